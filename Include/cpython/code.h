@@ -106,7 +106,11 @@ struct PyCodeObject {
      This should be treated as opaque by all code except the specializer and
      interpreter. */
     union _cache_or_instruction *co_quickened;
-
+    /* Per-instruction specialization stats (-X specialization_stats), or
+       NULL.  Allocated along with co_quickened. */
+    struct _PyOpcodeStats *co_opstats;
+    /* Tier-2 traces of hot loops, or NULL (see Python/optimizer.c) */
+    struct _PyTier2Table *co_tier2;
 };
 
 /* Masks for co_flags above */
@@ -4,6 +4,10 @@
 
 PyAPI_FUNC(void) _Py_NewReference(PyObject *op);
 
+/* Make op immortal: it will never be deallocated, and Py_INCREF() and
+   Py_DECREF() no longer write to it. */
+PyAPI_FUNC(void) _Py_SetImmortal(PyObject *op);
+
 #ifdef Py_TRACE_REFS
 /* Py_TRACE_REFS is such major surgery that we call external routines. */
 PyAPI_FUNC(void) _Py_ForgetReference(PyObject *);
@@ -291,6 +295,10 @@ typedef struct _heaptypeobject {
     struct _dictkeysobject *ht_cached_keys;
     PyObject *ht_module;
     char *_ht_tpname;  // Storage for "tp_name"; see PyType_FromModuleAndSpec
+    /* Python __init__ cached by the specializer for CALL_FUNCTION_CLASS_INIT.
+       Borrowed; only valid while _ht_init_version equals tp_version_tag. */
+    PyObject *_ht_init;
+    unsigned int _ht_init_version;
     /* here are optional user slots, followed by the members. */
 } PyHeapTypeObject;
 
@@ -170,6 +170,9 @@ struct _ts {
     _PyStackChunk *datastack_chunk;
     PyObject **datastack_top;
     PyObject **datastack_limit;
+
+    /* Free blocks of the small object allocator, or NULL */
+    struct _PyObject_ThreadCache *obmalloc_cache;
     /* XXX signal handlers should also be here */
 
 };
@@ -267,9 +267,18 @@ int _Py_Specialize_StoreAttr(PyObject *owner, _Py_CODEUNIT *instr, PyObject *nam
 int _Py_Specialize_LoadGlobal(PyObject *globals, PyObject *builtins, _Py_CODEUNIT *instr, PyObject *name, SpecializedCacheEntry *cache);
 int _Py_Specialize_LoadMethod(PyObject *owner, _Py_CODEUNIT *instr, PyObject *name, SpecializedCacheEntry *cache);
 int _Py_Specialize_BinarySubscr(PyObject *sub, PyObject *container, _Py_CODEUNIT *instr);
+int _Py_Specialize_StoreSubscr(PyObject *container, PyObject *sub, _Py_CODEUNIT *instr);
 int _Py_Specialize_CallFunction(PyObject *callable, _Py_CODEUNIT *instr, int nargs, SpecializedCacheEntry *cache, PyObject *builtins);
+int _Py_Specialize_CallFunctionKw(PyObject *callable, _Py_CODEUNIT *instr, int nargs, PyObject *kwnames, SpecializedCacheEntry *cache);
+int _Py_Specialize_CallMethod(PyObject *meth, PyObject *self_or_callable, _Py_CODEUNIT *instr, int nargs, SpecializedCacheEntry *cache);
 void _Py_Specialize_BinaryOp(PyObject *lhs, PyObject *rhs, _Py_CODEUNIT *instr,
                              SpecializedCacheEntry *cache);
+void _Py_Specialize_CompareOp(PyObject *lhs, PyObject *rhs, _Py_CODEUNIT *instr,
+                              SpecializedCacheEntry *cache);
+void _Py_Specialize_ForIter(PyObject *iter, _Py_CODEUNIT *instr,
+                            SpecializedCacheEntry *cache);
+void _Py_Specialize_UnpackSequence(PyObject *seq, _Py_CODEUNIT *instr,
+                                   SpecializedCacheEntry *cache);
 
 #define PRINT_SPECIALIZATION_STATS 0
 #define PRINT_SPECIALIZATION_STATS_DETAILED 0
@@ -301,17 +310,48 @@ typedef struct _stats {
 } SpecializationStats;
 
 extern SpecializationStats _specialization_stats[256];
-#define STAT_INC(opname, name) _specialization_stats[opname].name++
-#define STAT_DEC(opname, name) _specialization_stats[opname].name--
+#define GLOBAL_STAT_INC(opname, name) _specialization_stats[opname].name++
+#define GLOBAL_STAT_DEC(opname, name) _specialization_stats[opname].name--
 void _Py_PrintSpecializationStats(void);
 
 PyAPI_FUNC(PyObject*) _Py_GetSpecializationStats(void);
 
 #else
-#define STAT_INC(opname, name) ((void)0)
-#define STAT_DEC(opname, name) ((void)0)
+#define GLOBAL_STAT_INC(opname, name) ((void)0)
+#define GLOBAL_STAT_DEC(opname, name) ((void)0)
 #endif
 
+/* Per-instruction stats, kept by quickened code objects in any build when
+ * running with -X specialization_stats.  The fields are those of
+ * SpecializationStats; see sys._get_specialization_stats(). */
+typedef struct _PyOpcodeStats {
+    uint32_t specialization_success;
+    uint32_t specialization_failure;
+    uint32_t hit;
+    uint32_t deferred;
+    uint32_t miss;
+    uint32_t deopt;
+    uint32_t unquickened;
+    uint32_t specialization_failure_kinds[SPECIALIZATION_FAILURE_KINDS];
+} _PyOpcodeStats;
+
+/* Count an event for the instruction at the given index of the code object,
+ * if it collects stats */
+#define CODE_STAT_INC(code, index, name) \
+    do { \
+        if ((code)->co_opstats != NULL) { \
+            (code)->co_opstats[(index)].name++; \
+        } \
+    } while (0)
+#define CODE_STAT_DEC(code, index, name) \
+    do { \
+        if ((code)->co_opstats != NULL) { \
+            (code)->co_opstats[(index)].name--; \
+        } \
+    } while (0)
+
+PyAPI_FUNC(PyObject *) _PyCode_GetSpecializationStats(PyCodeObject *code);
+
 
 #ifdef __cplusplus
 }
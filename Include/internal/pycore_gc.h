@@ -69,6 +69,9 @@ typedef struct {
 /* If we change this, we need to change the default value in the
    signature of gc.collect. */
 #define NUM_GENERATIONS 3
+/* The most full collections objects can be required to survive before
+   they are tenured (see gc.set_tenure_threshold()) */
+#define GC_MAX_TENURE_THRESHOLD 8
 /*
    NOTE: about untracking of mutable objects.
 
@@ -125,6 +128,16 @@ struct gc_generation_stats {
     Py_ssize_t collected;
     /* total number of uncollectable objects (put into gc.garbage) */
     Py_ssize_t uncollectable;
+    /* total number of objects examined */
+    Py_ssize_t visited;
+    /* total time spent in each phase of the collections */
+    _PyTime_t update_refs_time;
+    _PyTime_t subtract_refs_time;
+    _PyTime_t move_unreachable_time;
+    _PyTime_t weakrefs_time;
+    _PyTime_t finalization_time;
+    _PyTime_t delete_time;
+    _PyTime_t total_time;
 };
 
 struct _gc_runtime_state {
@@ -159,6 +172,34 @@ struct _gc_runtime_state {
        collections, and are awaiting to undergo a full collection for
        the first time. */
     Py_ssize_t long_lived_pending;
+    /* Incremental collection of the oldest generation: automatic
+       collections of it scan a slice of it at a time, sized to take about
+       pause_target.  Zero disables it. */
+    _PyTime_t pause_target;
+    /* Objects of the oldest generation already scanned by the current
+       incremental cycle; the rest are still in the generation's list. */
+    PyGC_Head old_visited;
+    Py_ssize_t old_visited_size;
+    /* Objects scanned per second by the recent slices */
+    double scan_rate;
+    /* Set at the end of an incremental cycle if the oldest generation
+       grew enough since the last full collection to warrant a new one */
+    int full_collection_due;
+    /* Automatic tenuring, see gc.set_tenure_threshold().  aging[i] holds
+       the objects of the oldest generation that survived i+1 full
+       collections.  Those that survive tenure_threshold of them move to the
+       tenured generation, which only one in tenured.threshold automatic full
+       collections examines (tenured.count counts them).  Zero disables it. */
+    int tenure_threshold;
+    PyGC_Head aging[GC_MAX_TENURE_THRESHOLD - 1];
+    struct gc_generation tenured;
+    /* A list holding the objects frozen by gc.freeze(detach=True), or NULL.
+       They are linked to themselves rather than to a gc list, so that the
+       collector never writes to them again. */
+    PyObject *detached;
+    /* Give the free memory of pymalloc back to the system after each full
+       collection (see gc.set_trim_memory()) */
+    int trim_memory;
 };
 
 extern void _PyGC_InitState(struct _gc_runtime_state *);
@@ -174,6 +215,16 @@ extern void _PyList_ClearFreeList(PyInterpreterState *interp);
 extern void _PyDict_ClearFreeList(PyInterpreterState *interp);
 extern void _PyAsyncGen_ClearFreeLists(PyInterpreterState *interp);
 extern void _PyContext_ClearFreeList(PyInterpreterState *interp);
+extern void _PyMethod_ClearFreeList(PyInterpreterState *interp);
+extern void _PySlice_ClearFreeList(PyInterpreterState *interp);
+extern void _PyRangeIter_ClearFreeList(PyInterpreterState *interp);
+extern void _PyLong_ClearFreeList(PyInterpreterState *interp);
+
+// Functions to print statistics of types free lists
+extern void _PyMethod_DebugMallocStats(FILE *out);
+extern void _PySlice_DebugMallocStats(FILE *out);
+extern void _PyRangeIter_DebugMallocStats(FILE *out);
+extern void _PyLong_DebugMallocStats(FILE *out);
 
 #ifdef __cplusplus
 }
@@ -12,6 +12,7 @@ extern "C" {
 #include "pycore_ast_state.h"     // struct ast_state
 #include "pycore_gil.h"           // struct _gil_runtime_state
 #include "pycore_gc.h"            // struct _gc_runtime_state
+#include "pycore_optimizer.h"     // struct _Py_optimizer_state
 #include "pycore_warnings.h"      // struct _warnings_runtime_state
 
 struct _pending_calls {
@@ -141,6 +142,9 @@ struct _Py_list_state {
 #if PyList_MAXFREELIST > 0
     PyListObject *free_list[PyList_MAXFREELIST];
     int numfree;
+    /* list iterators (_PyListIterObject) */
+    PyObject *iter_free_list[PyList_MAXFREELIST];
+    int iter_numfree;
 #endif
 };
 
@@ -155,6 +159,9 @@ struct _Py_dict_state {
     int numfree;
     PyDictKeysObject *keys_free_list[PyDict_MAXFREELIST];
     int keys_numfree;
+    /* dict_keys, dict_values and dict_items views */
+    _PyDictViewObject *view_free_list[PyDict_MAXFREELIST];
+    int view_numfree;
 #endif
 };
 
@@ -200,6 +207,55 @@ struct _Py_context_state {
 #endif
 };
 
+#ifndef PyMethod_MAXFREELIST
+#  define PyMethod_MAXFREELIST 80
+#endif
+
+struct _Py_method_state {
+#if PyMethod_MAXFREELIST > 0
+    /* Bound methods are created for every obj.method() call which is not
+       optimized into LOAD_METHOD/CALL_METHOD */
+    PyMethodObject *free_list[PyMethod_MAXFREELIST];
+    int numfree;
+#endif
+};
+
+#ifndef PySlice_MAXFREELIST
+#  define PySlice_MAXFREELIST 80
+#endif
+
+struct _Py_slice_state {
+#if PySlice_MAXFREELIST > 0
+    PySliceObject *free_list[PySlice_MAXFREELIST];
+    int numfree;
+#endif
+};
+
+#ifndef PyRangeIter_MAXFREELIST
+#  define PyRangeIter_MAXFREELIST 80
+#endif
+
+struct _Py_range_state {
+#if PyRangeIter_MAXFREELIST > 0
+    /* range iterators (_PyRangeIterObject) */
+    PyObject *iter_free_list[PyRangeIter_MAXFREELIST];
+    int iter_numfree;
+#endif
+};
+
+#ifndef PyLong_MAXFREELIST
+#  define PyLong_MAXFREELIST 100
+#endif
+
+struct _Py_long_state {
+#if PyLong_MAXFREELIST > 0
+    /* Single digit integers which are not small ints: they are all
+       allocated with the same size */
+    PyLongObject *free_list[PyLong_MAXFREELIST];
+    int numfree;
+#endif
+};
+
 struct _Py_exc_state {
     // The dict mapping from errno codes to OSError subclasses
     PyObject *errnomap;
@@ -267,6 +323,11 @@ struct _is {
 
     struct _ceval_state ceval;
     struct _gc_runtime_state gc;
+#ifdef EXPERIMENTAL_ISOLATED_SUBINTERPRETERS
+    // pymalloc pools and arenas of a subinterpreter (NULL for the main
+    // interpreter, which uses the static state of Objects/obmalloc.c)
+    struct _obmalloc_state *obmalloc;
+#endif
 
     // sys.modules dictionary
     PyObject *modules;
@@ -325,13 +386,14 @@ struct _is {
     struct _Py_bytes_state bytes;
     struct _Py_unicode_state unicode;
     struct _Py_float_state float_state;
-    /* Using a cache is very effective since typically only a single slice is
-       created and then deleted again. */
-    PySliceObject *slice_cache;
+    struct _Py_long_state long_state;
+    struct _Py_slice_state slice;
 
     struct _Py_tuple_state tuple;
     struct _Py_list_state list;
     struct _Py_dict_state dict_state;
+    struct _Py_method_state method;
+    struct _Py_range_state range;
     struct _Py_frame_state frame;
     struct _Py_async_gen_state async_gen;
     struct _Py_context_state context;
@@ -339,6 +401,10 @@ struct _is {
 
     struct ast_state ast;
     struct type_cache type_cache;
+    struct _Py_optimizer_state optimizer;
+    /* Quickened code objects keep per-instruction specialization stats
+       (-X specialization_stats) */
+    int specialization_stats;
 };
 
 extern void _PyInterpreterState_ClearModules(PyInterpreterState *interp);
@@ -0,0 +1,49 @@
+#ifndef Py_INTERNAL_JIT_H
+#define Py_INTERNAL_JIT_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef Py_BUILD_CORE
+#  error "this header requires Py_BUILD_CORE define"
+#endif
+
+#include "pycore_frame.h"         // InterpreterFrame
+#include "pycore_uops.h"          // _PyUOpTrace
+
+/* Copy-and-patch JIT for tier-2 traces (-X jit).
+ *
+ * At build time, Tools/jit/build.py compiles Tools/jit/template.c once
+ * per uop into a "stencil": machine code with holes for the uop's oparg
+ * and operand, for the addresses of the C functions it calls and for the
+ * next stencil to continue with.  Compiling a trace copies the stencils of
+ * its uops into executable memory one after the other and patches the
+ * holes.  See Python/jit.c.
+ */
+
+/* Shared by all stencils of a running trace */
+typedef struct {
+    PyThreadState *tstate;
+    Py_ssize_t iterations;
+    /* How the trace was left (_PyUOP_EXIT_*), and the index of the uop
+     * that left it */
+    int exit;
+    int index;
+} _PyJITState;
+
+/* Every stencil has this signature, and continues with the next one
+ * through a tail call.  Returns the stack pointer when leaving the trace. */
+typedef PyObject **(*_PyJITFunction)(_PyJITState *state,
+                                     InterpreterFrame *frame,
+                                     PyObject **stack_pointer);
+
+/* Compile the trace into trace->jit_code.  Returns 0 on success, or -1
+ * if the trace cannot be compiled (without setting an exception). */
+extern int _PyJIT_Compile(_PyUOpTrace *trace);
+
+extern void _PyJIT_Free(_PyUOpTrace *trace);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* !Py_INTERNAL_JIT_H */
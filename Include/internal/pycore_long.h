@@ -23,6 +23,35 @@ static inline PyObject* _PyLong_GetOne(void)
 
 PyObject *_PyLong_Add(PyLongObject *left, PyLongObject *right);
 PyObject *_PyLong_Multiply(PyLongObject *left, PyLongObject *right);
+PyObject *_PyLong_Subtract(PyLongObject *left, PyLongObject *right);
+
+/* Is this an int of size 1, 0 or -1? */
+static inline int _PyLong_IsMedium(PyObject *op)
+{ return ((size_t)Py_SIZE(op)) + 1U < 3U; }
+
+static inline stwodigits _PyLong_MediumValue(PyObject *op)
+{
+    assert(_PyLong_IsMedium(op));
+    return ((stwodigits)Py_SIZE(op)) * ((PyLongObject *)op)->ob_digit[0];
+}
+
+/* The specialized int instructions store a single-digit result into an
+ * operand they hold the only reference to, rather than allocating a new
+ * int.  Results in the small int cache must still be the cached objects. */
+static inline int _PyLong_CanStoreInPlace(PyObject *op, stwodigits value)
+{
+    return (Py_REFCNT(op) == 1 && Py_SIZE(op) != 0 &&
+            value != 0 && -(stwodigits)PyLong_MASK <= value &&
+            value <= (stwodigits)PyLong_MASK &&
+            !(-_PY_NSMALLNEGINTS <= value && value < _PY_NSMALLPOSINTS));
+}
+
+static inline void _PyLong_StoreInPlace(PyObject *op, stwodigits value)
+{
+    assert(_PyLong_CanStoreInPlace(op, value));
+    Py_SET_SIZE(op, value < 0 ? -1 : 1);
+    ((PyLongObject *)op)->ob_digit[0] = (digit)(value < 0 ? -value : value);
+}
 
 /* Used by Python/mystrtoul.c, _PyBytes_FromHex(),
    _PyBytes_DecodeEscape(), etc. */
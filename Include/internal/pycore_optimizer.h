@@ -0,0 +1,65 @@
+#ifndef Py_INTERNAL_OPTIMIZER_H
+#define Py_INTERNAL_OPTIMIZER_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef Py_BUILD_CORE
+#  error "this header requires Py_BUILD_CORE define"
+#endif
+
+#include "pycore_frame.h"         // InterpreterFrame
+
+/* Tier-2 execution engine (-X uops).
+ *
+ * Hot loops are projected from their quickened bytecode into a linear
+ * trace of micro-ops, starting at the target of a JUMP_ABSOLUTE_QUICK
+ * back-edge.  The trace is optimized and then run by a separate
+ * interpreter loop until a guard fails, a side exit is taken or the
+ * loop finishes.  See Python/optimizer.c.
+ */
+
+struct _Py_optimizer_stats {
+    Py_ssize_t traces_created;
+    Py_ssize_t traces_failed;
+    Py_ssize_t traces_invalidated;
+    Py_ssize_t executions;
+    Py_ssize_t iterations;
+    Py_ssize_t deopts;
+    Py_ssize_t side_exits;
+    Py_ssize_t guards_removed;
+    Py_ssize_t increfs_removed;
+    Py_ssize_t constants_propagated;
+    Py_ssize_t constants_folded;
+    Py_ssize_t jit_traces;
+    Py_ssize_t jit_failures;
+    Py_ssize_t jit_code_size;
+};
+
+struct _Py_optimizer_state {
+    /* Set by -X uops or -X jit */
+    int enabled;
+    /* Set by -X jit */
+    int jit;
+    struct _Py_optimizer_stats stats;
+};
+
+extern void _PyOptimizer_Init(PyInterpreterState *interp);
+
+/* Free the traces attached to a code object. */
+extern void _PyOptimizer_ClearCode(PyCodeObject *co);
+
+/* Called on a back-edge to `start` with the optimizer enabled.
+ * Returns 0 if no trace was run, otherwise sets *resume to the index of
+ * the instruction to continue with and returns 1, or -1 if that
+ * instruction raised an exception. */
+extern int _PyOptimizer_RunLoop(PyThreadState *tstate,
+                                InterpreterFrame *frame, int start,
+                                PyObject ***stack_pointer, int *resume);
+
+PyAPI_FUNC(PyObject *) _PyOptimizer_GetStats(PyInterpreterState *interp);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* !Py_INTERNAL_OPTIMIZER_H */
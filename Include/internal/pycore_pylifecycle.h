@@ -88,6 +88,8 @@ extern void _PyList_Fini(PyInterpreterState *interp);
 extern void _PyBytes_Fini(PyInterpreterState *interp);
 extern void _PyFloat_Fini(PyInterpreterState *interp);
 extern void _PySlice_Fini(PyInterpreterState *interp);
+extern void _PyMethod_Fini(PyInterpreterState *interp);
+extern void _PyRange_Fini(PyInterpreterState *interp);
 extern void _PyAsyncGen_Fini(PyInterpreterState *interp);
 
 extern int _PySignal_Init(int install_signal_handlers);
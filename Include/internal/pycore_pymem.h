@@ -99,6 +99,23 @@ PyAPI_DATA(struct _PyTraceMalloc_Config) _Py_tracemalloc_config;
 void *_PyObject_VirtualAlloc(size_t size);
 void _PyObject_VirtualFree(void *, size_t size);
 
+/* Give the memory of the free pymalloc pools back to the system.
+   Return the number of bytes released. */
+PyAPI_FUNC(size_t) _PyObject_TrimMemory(void);
+
+/* Per-thread caches of free pymalloc blocks (see Objects/obmalloc.c).
+   A thread state without a cache uses the pools directly. */
+extern struct _PyObject_ThreadCache *_PyObject_NewThreadCache(void);
+extern void _PyObject_ClearThreadCache(PyThreadState *tstate);
+
+#ifdef EXPERIMENTAL_ISOLATED_SUBINTERPRETERS
+/* Give a subinterpreter its own pymalloc pools and arenas (see
+   Objects/obmalloc.c), so that interpreters running in parallel don't
+   share them. */
+extern int _PyObject_InitAllocatorState(PyInterpreterState *interp);
+extern void _PyObject_FiniAllocatorState(PyInterpreterState *interp);
+#endif
+
 
 #ifdef __cplusplus
 }
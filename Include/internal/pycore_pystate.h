@@ -171,6 +171,9 @@ PyAPI_FUNC(int) _PyState_AddModule(
 
 PyAPI_FUNC(int) _PyOS_InterruptOccurred(PyThreadState *tstate);
 
+// Exporter of buffers shared between interpreters (see pystate.c).
+extern PyTypeObject _PySharedBuffer_Type;
+
 #ifdef __cplusplus
 }
 #endif
@@ -105,6 +105,11 @@ typedef struct pyruntimestate {
         PyThread_type_lock mutex;
         struct _xidregitem *head;
     } xidregistry;
+#ifdef EXPERIMENTAL_ISOLATED_SUBINTERPRETERS
+    // Serializes the arena allocations of the interpreters, which have their
+    // own pools but share the arena map of Objects/obmalloc.c
+    PyThread_type_lock obmalloc_mutex;
+#endif
 
     unsigned long main_thread;
 
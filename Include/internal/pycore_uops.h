@@ -0,0 +1,98 @@
+#ifndef Py_INTERNAL_UOPS_H
+#define Py_INTERNAL_UOPS_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef Py_BUILD_CORE
+#  error "this header requires Py_BUILD_CORE define"
+#endif
+
+/* Micro-op traces, shared by the tier-2 interpreter in Python/optimizer.c
+ * and the JIT stencils built from Tools/jit/template.c.  The uop bodies
+ * themselves are in Python/uop_cases.h. */
+
+/* Micro-ops */
+#define UOP_NOP                         0
+#define UOP_LOAD_FAST                   1
+#define UOP_LOAD_CONST                  2
+#define UOP_STORE_FAST                  3
+#define UOP_POP_TOP                     4
+#define UOP_DUP_TOP                     5
+#define UOP_ROT_TWO                     6
+#define UOP_GUARD_TYPE                  7
+#define UOP_BINARY_OP                   8
+#define UOP_ADD_INT                     9
+#define UOP_MULTIPLY_INT               10
+#define UOP_SUBTRACT_INT               11
+#define UOP_ADD_FLOAT                  12
+#define UOP_MULTIPLY_FLOAT             13
+#define UOP_SUBTRACT_FLOAT             14
+#define UOP_BINARY_SUBSCR              15
+#define UOP_BINARY_SUBSCR_LIST_INT     16
+#define UOP_BINARY_SUBSCR_TUPLE_INT    17
+#define UOP_STORE_SUBSCR               18
+#define UOP_STORE_SUBSCR_LIST_INT      19
+#define UOP_COMPARE_OP                 20
+#define UOP_IS_OP                      21
+#define UOP_COMPARE_INT_BRANCH         22
+#define UOP_COMPARE_FLOAT_BRANCH       23
+#define UOP_COMPARE_STR_BRANCH         24
+#define UOP_BRANCH                     25
+#define UOP_FOR_ITER                   26
+#define UOP_FOR_ITER_LIST              27
+#define UOP_FOR_ITER_TUPLE             28
+#define UOP_FOR_ITER_RANGE             29
+#define UOP_LOAD_GLOBAL_MODULE         30
+#define UOP_LOAD_GLOBAL_BUILTIN        31
+#define UOP_JUMP_TO_TOP                32
+
+/* Flags */
+#define UOP_BORROW 1    /* The value pushed is a borrowed reference */
+#define UOP_JUMP 2      /* The trace follows the jump of this branch */
+
+typedef struct {
+    uint8_t opcode;
+    uint8_t flags;
+    /* Stack items holding borrowed references when the uop starts,
+     * bit 0 being the top of the stack. */
+    uint16_t borrowed;
+    int32_t oparg;
+    /* Index of the instruction to resume at on a deopt or an error */
+    int32_t target;
+    /* Index of the instruction to resume at when leaving through the
+     * side exit of a branch, or at the end of a generic FOR_ITER */
+    int32_t jump_target;
+    uint32_t exits;
+    uint64_t operand;
+} _PyUOpInstruction;
+
+typedef struct {
+    int start;
+    int valid;
+    int running;
+    /* Index of the branch instruction to flip, or -1 */
+    int flip;
+    Py_ssize_t iterations;
+    Py_ssize_t deopts;
+    /* Results of constant folding, or NULL */
+    PyObject *consts;
+    /* Machine code compiled by the JIT (-X jit), or NULL */
+    void *jit_code;
+    size_t jit_size;
+    int length;
+    _PyUOpInstruction uops[1];
+} _PyUOpTrace;
+
+/* How a trace was left */
+#define _PyUOP_EXIT_DEOPT               0   /* A guard failed */
+#define _PyUOP_EXIT_SIDE                1   /* A branch left the trace */
+#define _PyUOP_EXIT_LOOP                2   /* A generic FOR_ITER finished */
+#define _PyUOP_EXIT_BREAK               3   /* Eval breaker or tracing */
+#define _PyUOP_EXIT_ERROR               4
+#define _PyUOP_EXIT_ERROR_WITH_STACK    5   /* Operands still on the stack */
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* !Py_INTERNAL_UOPS_H */
@@ -88,6 +88,28 @@ typedef struct _typeobject PyTypeObject;
 #define PyVarObject_HEAD_INIT(type, size)       \
     { PyObject_HEAD_INIT(type) size },
 
+/* Immortal objects are never deallocated: Py_INCREF() and Py_DECREF() skip
+ * them, so the memory holding their header is never written to once they
+ * are created.  This keeps singletons and objects shared after a fork()
+ * out of the way of copy-on-write and of cache line ping-pong between CPUs.
+ *
+ * An object is immortal when the _Py_IMMORTAL_BIT of its reference count is
+ * set.  Immortal objects start half way through the immortal range, so that
+ * code built without this check (old extensions using the stable ABI) can
+ * still increment or decrement the count a very large number of times
+ * without making the object mortal again.  The bit is chosen so that the
+ * count still fits in the garbage collector's gc_refs field.
+ */
+#define _Py_IMMORTAL_BIT ((Py_ssize_t)1 << (8 * SIZEOF_SIZE_T - 4))
+#define _Py_IMMORTAL_REFCNT (_Py_IMMORTAL_BIT + (_Py_IMMORTAL_BIT >> 1))
+
+#define _PyObject_IMMORTAL_INIT(type)   \
+    { _PyObject_EXTRA_INIT              \
+    _Py_IMMORTAL_REFCNT, type },
+
+#define _PyVarObject_IMMORTAL_INIT(type, size)  \
+    { _PyObject_IMMORTAL_INIT(type) size },
+
 /* PyObject_VAR_HEAD defines the initial segment of all variable-size
  * container objects.  These end with a declaration of an array with 1
  * element, but enough space is malloc'ed so that the array actually
@@ -132,6 +154,11 @@ static inline Py_ssize_t _Py_REFCNT(const PyObject *ob) {
 }
 #define Py_REFCNT(ob) _Py_REFCNT(_PyObject_CAST_CONST(ob))
 
+static inline int _Py_IsImmortal(const PyObject *ob) {
+    return (ob->ob_refcnt & _Py_IMMORTAL_BIT) != 0;
+}
+#define _Py_IsImmortal(ob) _Py_IsImmortal(_PyObject_CAST_CONST(ob))
+
 
 // bpo-39573: The Py_SET_TYPE() function must be used to set an object type.
 static inline PyTypeObject* _Py_TYPE(const PyObject *ob) {
@@ -477,6 +504,9 @@ static inline void _Py_INCREF(PyObject *op)
 #else
     // Non-limited C API and limited C API for Python 3.9 and older access
     // directly PyObject.ob_refcnt.
+    if (_Py_IsImmortal(op)) {
+        return;
+    }
 #ifdef Py_REF_DEBUG
     _Py_RefTotal++;
 #endif
@@ -497,6 +527,9 @@ static inline void _Py_DECREF(
 #else
     // Non-limited C API and limited C API for Python 3.9 and older access
     // directly PyObject.ob_refcnt.
+    if (_Py_IsImmortal(op)) {
+        return;
+    }
 #ifdef Py_REF_DEBUG
     _Py_RefTotal--;
 #endif
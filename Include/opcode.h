@@ -118,39 +118,68 @@ extern "C" {
 #define BINARY_OP_INPLACE_ADD_UNICODE    16
 #define BINARY_OP_MULTIPLY_INT           17
 #define BINARY_OP_MULTIPLY_FLOAT         18
-#define BINARY_SUBSCR_ADAPTIVE           19
-#define BINARY_SUBSCR_LIST_INT           20
-#define BINARY_SUBSCR_TUPLE_INT          21
-#define BINARY_SUBSCR_DICT               22
-#define CALL_FUNCTION_ADAPTIVE           23
-#define CALL_FUNCTION_BUILTIN_O          24
-#define CALL_FUNCTION_BUILTIN_FAST       26
-#define CALL_FUNCTION_LEN                27
-#define CALL_FUNCTION_ISINSTANCE         28
-#define CALL_FUNCTION_PY_SIMPLE          29
-#define JUMP_ABSOLUTE_QUICK              34
-#define LOAD_ATTR_ADAPTIVE               36
-#define LOAD_ATTR_INSTANCE_VALUE         38
-#define LOAD_ATTR_WITH_HINT              39
-#define LOAD_ATTR_SLOT                   40
-#define LOAD_ATTR_MODULE                 41
-#define LOAD_GLOBAL_ADAPTIVE             42
-#define LOAD_GLOBAL_MODULE               43
-#define LOAD_GLOBAL_BUILTIN              44
-#define LOAD_METHOD_ADAPTIVE             45
-#define LOAD_METHOD_CACHED               46
-#define LOAD_METHOD_CLASS                47
-#define LOAD_METHOD_MODULE               48
-#define LOAD_METHOD_NO_DICT              55
-#define STORE_ATTR_ADAPTIVE              56
-#define STORE_ATTR_INSTANCE_VALUE        57
-#define STORE_ATTR_SLOT                  58
-#define STORE_ATTR_WITH_HINT             59
-#define LOAD_FAST__LOAD_FAST             62
-#define STORE_FAST__LOAD_FAST            63
-#define LOAD_FAST__LOAD_CONST            64
-#define LOAD_CONST__LOAD_FAST            65
-#define STORE_FAST__STORE_FAST           66
+#define BINARY_OP_SUBTRACT_INT           19
+#define BINARY_OP_SUBTRACT_FLOAT         20
+#define BINARY_SUBSCR_ADAPTIVE           21
+#define BINARY_SUBSCR_LIST_INT           22
+#define BINARY_SUBSCR_TUPLE_INT          23
+#define BINARY_SUBSCR_DICT               24
+#define CALL_FUNCTION_ADAPTIVE           26
+#define CALL_FUNCTION_BUILTIN_O          27
+#define CALL_FUNCTION_BUILTIN_FAST       28
+#define CALL_FUNCTION_LEN                29
+#define CALL_FUNCTION_ISINSTANCE         34
+#define CALL_FUNCTION_PY_SIMPLE          36
+#define CALL_FUNCTION_PY_WITH_DEFAULTS   38
+#define CALL_FUNCTION_BOUND_METHOD       39
+#define CALL_FUNCTION_CLASS_INIT         40
+#define CALL_FUNCTION_KW_ADAPTIVE        41
+#define CALL_FUNCTION_KW_PY              42
+#define CALL_METHOD_ADAPTIVE             43
+#define CALL_METHOD_PY                   44
+#define CALL_METHOD_DESCRIPTOR_NOARGS    45
+#define CALL_METHOD_DESCRIPTOR_O         46
+#define CALL_METHOD_DESCRIPTOR_FAST      47
+#define CALL_METHOD_LIST_APPEND          48
+#define COMPARE_OP_ADAPTIVE              55
+#define COMPARE_OP_FLOAT_JUMP            56
+#define COMPARE_OP_INT_JUMP              57
+#define COMPARE_OP_STR_JUMP              58
+#define FOR_ITER_ADAPTIVE                59
+#define FOR_ITER_LIST                    62
+#define FOR_ITER_TUPLE                   63
+#define FOR_ITER_RANGE                   64
+#define FOR_ITER_GEN                     65
+#define JUMP_ABSOLUTE_QUICK              66
+#define LOAD_ATTR_ADAPTIVE               67
+#define LOAD_ATTR_INSTANCE_VALUE         75
+#define LOAD_ATTR_WITH_HINT              76
+#define LOAD_ATTR_SLOT                   77
+#define LOAD_ATTR_MODULE                 78
+#define LOAD_GLOBAL_ADAPTIVE             79
+#define LOAD_GLOBAL_MODULE               80
+#define LOAD_GLOBAL_BUILTIN              81
+#define LOAD_METHOD_ADAPTIVE             87
+#define LOAD_METHOD_CACHED               88
+#define LOAD_METHOD_CLASS               123
+#define LOAD_METHOD_MODULE              127
+#define LOAD_METHOD_NO_DICT             128
+#define STORE_ATTR_ADAPTIVE             134
+#define STORE_ATTR_INSTANCE_VALUE       140
+#define STORE_ATTR_SLOT                 143
+#define STORE_ATTR_WITH_HINT            149
+#define STORE_SUBSCR_ADAPTIVE           150
+#define STORE_SUBSCR_LIST_INT           151
+#define STORE_SUBSCR_DICT               153
+#define UNPACK_SEQUENCE_ADAPTIVE        154
+#define UNPACK_SEQUENCE_LIST            158
+#define UNPACK_SEQUENCE_TUPLE           159
+#define UNPACK_SEQUENCE_TWO_TUPLE       167
+#define LOAD_FAST__LOAD_FAST            168
+#define STORE_FAST__LOAD_FAST           169
+#define LOAD_FAST__LOAD_CONST           170
+#define LOAD_CONST__LOAD_FAST           171
+#define STORE_FAST__STORE_FAST          172
 #define DO_TRACING                      255
 #ifdef NEED_OPCODE_JUMP_TABLES
 static uint32_t _PyOpcode_RelativeJump[8] = {
@@ -231,6 +231,8 @@ def jabs_op(name, op):
     "BINARY_OP_INPLACE_ADD_UNICODE",
     "BINARY_OP_MULTIPLY_INT",
     "BINARY_OP_MULTIPLY_FLOAT",
+    "BINARY_OP_SUBTRACT_INT",
+    "BINARY_OP_SUBTRACT_FLOAT",
     "BINARY_SUBSCR_ADAPTIVE",
     "BINARY_SUBSCR_LIST_INT",
     "BINARY_SUBSCR_TUPLE_INT",
@@ -241,6 +243,26 @@ def jabs_op(name, op):
     "CALL_FUNCTION_LEN",
     "CALL_FUNCTION_ISINSTANCE",
     "CALL_FUNCTION_PY_SIMPLE",
+    "CALL_FUNCTION_PY_WITH_DEFAULTS",
+    "CALL_FUNCTION_BOUND_METHOD",
+    "CALL_FUNCTION_CLASS_INIT",
+    "CALL_FUNCTION_KW_ADAPTIVE",
+    "CALL_FUNCTION_KW_PY",
+    "CALL_METHOD_ADAPTIVE",
+    "CALL_METHOD_PY",
+    "CALL_METHOD_DESCRIPTOR_NOARGS",
+    "CALL_METHOD_DESCRIPTOR_O",
+    "CALL_METHOD_DESCRIPTOR_FAST",
+    "CALL_METHOD_LIST_APPEND",
+    "COMPARE_OP_ADAPTIVE",
+    "COMPARE_OP_FLOAT_JUMP",
+    "COMPARE_OP_INT_JUMP",
+    "COMPARE_OP_STR_JUMP",
+    "FOR_ITER_ADAPTIVE",
+    "FOR_ITER_LIST",
+    "FOR_ITER_TUPLE",
+    "FOR_ITER_RANGE",
+    "FOR_ITER_GEN",
     "JUMP_ABSOLUTE_QUICK",
     "LOAD_ATTR_ADAPTIVE",
     "LOAD_ATTR_INSTANCE_VALUE",
@@ -259,6 +281,13 @@ def jabs_op(name, op):
     "STORE_ATTR_INSTANCE_VALUE",
     "STORE_ATTR_SLOT",
     "STORE_ATTR_WITH_HINT",
+    "STORE_SUBSCR_ADAPTIVE",
+    "STORE_SUBSCR_LIST_INT",
+    "STORE_SUBSCR_DICT",
+    "UNPACK_SEQUENCE_ADAPTIVE",
+    "UNPACK_SEQUENCE_LIST",
+    "UNPACK_SEQUENCE_TUPLE",
+    "UNPACK_SEQUENCE_TWO_TUPLE",
     # Super instructions
     "LOAD_FAST__LOAD_FAST",
     "STORE_FAST__LOAD_FAST",
@@ -74,6 +74,7 @@ def get_pooled_int(value):
     getallocatedblocks = sys.getallocatedblocks
     gettotalrefcount = sys.gettotalrefcount
     _getquickenedcount = sys._getquickenedcount
+    clear_type_cache = sys._clear_type_cache
     fd_count = os_helper.fd_count
     # initialize variables to make pyflakes quiet
     rc_before = alloc_before = fd_before = 0
@@ -91,6 +92,10 @@ def get_pooled_int(value):
 
         dash_R_cleanup(fs, ps, pic, zdc, abcs)
         support.gc_collect()
+        # The empty entries of the type cache refer to None, which is
+        # immortal: only the names in the cache are counted in the total
+        # reference count.  Empty the cache filled by the collection.
+        clear_type_cache()
 
         # Read memory statistics immediately after the garbage collection
         alloc_after = getallocatedblocks() - _getquickenedcount()
@@ -314,6 +314,9 @@ def test_default_shareables(self):
                 'spam',
                 10,
                 -10,
+                # buffers
+                bytearray(b'spam'),
+                memoryview(b'spam'),
                 ]
         for obj in shareables:
             with self.subTest(obj):
@@ -401,6 +404,72 @@ def test_int(self):
         self._assert_values(itertools.chain(range(-1, 258),
                                             [sys.maxsize, -sys.maxsize - 1]))
 
+    def test_buffers(self):
+        import array
+        import mmap
+        m = mmap.mmap(-1, 4)
+        m[:] = b'spam'
+        self.addCleanup(m.close)
+        for obj in [bytearray(b'spam'), array.array('i', [1, 2, 3]), m]:
+            with self.subTest(obj):
+                interpreters.channel_send(self.cid, obj)
+                got = interpreters.channel_recv(self.cid)
+
+                self.assertIsInstance(got, memoryview)
+                self.assertTrue(got.readonly)
+                self.assertEqual(got.tobytes(), bytes(obj))
+                self.assertEqual(got.format, memoryview(obj).format)
+                got.release()
+
+    def test_buffer_shares_memory(self):
+        buf = bytearray(b'spam')
+        interpreters.channel_send(self.cid, buf)
+        got = interpreters.channel_recv(self.cid)
+
+        buf[0] = ord('S')
+        self.assertEqual(got.tobytes(), b'Spam')
+        with self.assertRaises(TypeError):
+            got[0] = ord('x')
+        # The exporter can't be resized while the buffer is shared.
+        with self.assertRaises(BufferError):
+            buf.append(0)
+        del got
+        buf.append(0)
+
+    def test_buffer_pending(self):
+        buf = bytearray(b'spam')
+        interpreters.channel_send(self.cid, buf)
+        with self.assertRaises(BufferError):
+            buf.append(0)
+        interpreters.channel_recv(self.cid)
+        buf.append(0)
+
+    def test_memoryview_handoff(self):
+        buf = bytearray(b'spam eggs')
+        view = memoryview(buf)
+        interpreters.channel_send(self.cid, view[5:])
+        got = interpreters.channel_recv(self.cid)
+
+        self.assertFalse(got.readonly)
+        self.assertEqual(got.tobytes(), b'eggs')
+        got[0] = ord('E')
+        self.assertEqual(buf, b'spam Eggs')
+        # Only the sent memoryview is handed off.
+        self.assertEqual(view.tobytes(), b'spam Eggs')
+
+        sliced = view[:4]
+        interpreters.channel_send(self.cid, sliced)
+        with self.assertRaises(ValueError):
+            sliced.tobytes()
+        interpreters.channel_recv(self.cid).release()
+
+    def test_memoryview_handoff_exported(self):
+        view = memoryview(bytearray(b'spam'))
+        exported = pickle.PickleBuffer(view)
+        with self.assertRaises(BufferError):
+            interpreters.channel_send(self.cid, view)
+        exported.release()
+
     def test_non_shareable_int(self):
         ints = [
             sys.maxsize + 1,
@@ -1409,6 +1478,23 @@ def test_send_recv_different_interpreters(self):
 
         self.assertEqual(obj, b'spam')
 
+    def test_send_recv_buffer_different_interpreters(self):
+        cid = interpreters.channel_create()
+        buf = bytearray(b'spam')
+        interpreters.channel_send(cid, memoryview(buf))
+        id1 = interpreters.create()
+        out = _run_output(id1, dedent(f"""
+            import _xxsubinterpreters as _interpreters
+            view = _interpreters.channel_recv({cid})
+            view[0] = ord('S')
+            print(view.tobytes().decode())
+            del view
+            """))
+
+        self.assertEqual(out.strip(), 'Spam')
+        self.assertEqual(buf, b'Spam')
+        buf.append(0)
+
     def test_send_recv_different_threads(self):
         cid = interpreters.channel_create()
 
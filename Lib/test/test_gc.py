@@ -781,12 +781,202 @@ def test_get_stats(self):
         self.assertEqual(new[1]["collections"], old[1]["collections"])
         self.assertEqual(new[2]["collections"], old[2]["collections"] + 1)
 
+    def test_get_stats_detailed(self):
+        class Survivor:
+            pass
+        survivors = [Survivor() for i in range(10)]
+        gc.collect()
+        stats = gc.get_stats(detailed=True)
+        self.assertEqual(len(stats), 3)
+        phases = {"update_refs", "subtract_refs", "move_unreachable",
+                  "weakrefs", "finalization", "delete", "total"}
+        for st in stats:
+            self.assertEqual(set(st),
+                             {"collected", "collections", "uncollectable",
+                              "visited", "times", "survivors"})
+            self.assertGreaterEqual(st["visited"], 0)
+            self.assertEqual(set(st["times"]), phases)
+            for phase in phases:
+                self.assertGreaterEqual(st["times"][phase], 0)
+                self.assertLessEqual(st["times"][phase], st["times"]["total"])
+        self.assertGreaterEqual(stats[2]["visited"], len(survivors))
+        self.assertEqual(stats[2]["survivors"][Survivor], len(survivors))
+        self.assertNotIn(Survivor, stats[0]["survivors"])
+        self.assertEqual(set(gc.get_stats(detailed=False)[2]),
+                         {"collected", "collections", "uncollectable"})
+
+    def test_pause_target(self):
+        self.addCleanup(gc.set_pause_target, gc.get_pause_target())
+        gc.set_pause_target(2.5)
+        self.assertEqual(gc.get_pause_target(), 2.5)
+        gc.set_pause_target(10)
+        self.assertEqual(gc.get_pause_target(), 10.0)
+        gc.set_pause_target(0)
+        self.assertEqual(gc.get_pause_target(), 0.0)
+        self.assertRaises(ValueError, gc.set_pause_target, -1)
+        self.assertRaises(TypeError, gc.set_pause_target, "1")
+
+    @cpython_only
+    def test_incremental_collection(self):
+        code = textwrap.dedent('''
+            import gc, weakref
+
+            class A:
+                pass
+
+            # Keep the oldest generation small, so that it is scanned in
+            # a few slices
+            gc.freeze()
+            gc.set_threshold(100, 2, 2)
+            gc.set_pause_target(1)
+            slices = []
+            def callback(phase, info):
+                if info["incremental"]:
+                    slices.append((phase, info))
+            gc.callbacks.append(callback)
+
+            # A cycle that made it to the oldest generation
+            a = A()
+            a.cycle = a
+            gc.collect(1)
+            ref = weakref.ref(a)
+            del a
+
+            live = []
+            for i in range(100000):
+                live.append(A())
+                if ref() is None:
+                    break
+            gc.callbacks.clear()
+            print(ref() is None, len(live) < 100000)
+            stops = [info for phase, info in slices if phase == "stop"]
+            print(len(stops) > 0, len(stops) == len(slices) // 2)
+            print(all(info["generation"] == 2 and info["duration"] >= 0
+                      and info["objects"] > 0 for info in stops))
+            print(sum(info["collected"] for info in stops) >= 1)
+            # The live objects are all still tracked
+            print(len(gc.get_objects(2)) > len(live))
+        ''')
+        rc, out, err = assert_python_ok('-c', code)
+        self.assertEqual(out.decode().split(),
+                         ['True'] * 7)
+
     def test_freeze(self):
         gc.freeze()
         self.assertGreater(gc.get_freeze_count(), 0)
         gc.unfreeze()
         self.assertEqual(gc.get_freeze_count(), 0)
 
+    @cpython_only
+    def test_freeze_detach(self):
+        code = textwrap.dedent('''
+            import gc
+
+            class A:
+                pass
+
+            a = A()
+            gc.collect()
+            gc.freeze(detach=True)
+            print(gc.get_freeze_count() > 0, gc.is_tracked(a))
+            print(any(x is a for x in gc.get_objects()))
+            print(gc.get_referrers(a) == [])
+            # Detached objects are kept alive
+            b = A()
+            gc.freeze(detach=True)
+            count = gc.get_freeze_count()
+            del b
+            gc.collect()
+            print(gc.get_freeze_count() == count)
+            gc.unfreeze()
+            print(gc.get_freeze_count(), gc.is_tracked(a))
+            print(any(x is a for x in gc.get_objects()))
+        ''')
+        rc, out, err = assert_python_ok('-c', code)
+        self.assertEqual(out.decode().split(),
+                         ['True', 'True', 'False', 'True', 'True',
+                          '0', 'True', 'True'])
+
+    @cpython_only
+    def test_freeze_immortal(self):
+        code = textwrap.dedent('''
+            import gc, sys, weakref
+
+            class A:
+                pass
+
+            def f():
+                return 'a name only used here'
+
+            a = A()
+            a.attr = (str(12345678), 12345678)
+            gc.freeze(immortal=True)
+            rc = sys.getrefcount(a)
+            refs = [a] * 10
+            print(sys.getrefcount(a) == rc)
+            print(sys.getrefcount(a.attr) == sys.getrefcount(a.attr[0])
+                  == sys.getrefcount(f.__code__.co_consts) == rc)
+            # Immortal objects are never deallocated
+            gc.unfreeze()
+            wr = weakref.ref(a)
+            del a, refs
+            gc.collect()
+            print(wr() is not None)
+        ''')
+        rc, out, err = assert_python_ok('-c', code)
+        self.assertEqual(out.decode().split(), ['True'] * 3)
+
+    def test_trim_memory(self):
+        self.addCleanup(gc.set_trim_memory, gc.get_trim_memory())
+        self.assertFalse(gc.get_trim_memory())
+        gc.set_trim_memory(True)
+        self.assertTrue(gc.get_trim_memory())
+        x = [[i] for i in range(10000)]
+        keep = x[::2000]
+        del x
+        gc.collect()
+        # The pools freed by the collection were already trimmed
+        if sys.platform != 'win32':
+            self.assertLess(sys._trim_memory(), 1 << 20)
+        gc.set_trim_memory(False)
+        self.assertFalse(gc.get_trim_memory())
+
+    def test_tenure_threshold(self):
+        self.addCleanup(gc.set_tenure_threshold, *gc.get_tenure_threshold())
+        gc.set_tenure_threshold(3)
+        self.assertEqual(gc.get_tenure_threshold(), (3, 10))
+        gc.set_tenure_threshold(1, 5)
+        self.assertEqual(gc.get_tenure_threshold(), (1, 5))
+        self.assertRaises(ValueError, gc.set_tenure_threshold, -1)
+        self.assertRaises(ValueError, gc.set_tenure_threshold, 9)
+        self.assertRaises(ValueError, gc.set_tenure_threshold, 1, 0)
+        gc.set_tenure_threshold(0)
+        self.assertEqual(gc.get_tenured_count(), 0)
+
+    def test_tenuring(self):
+        class A:
+            pass
+        self.addCleanup(gc.set_tenure_threshold, *gc.get_tenure_threshold())
+        gc.set_tenure_threshold(2)
+        a = A()
+        gc.collect()
+        self.assertEqual(gc.get_tenured_count(), 0)
+        gc.collect()
+        tenured = gc.get_tenured_count()
+        self.assertGreater(tenured, 0)
+        # Tenured objects are still reported in the oldest generation
+        self.assertTrue(any(x is a for x in gc.get_objects(2)))
+
+        # Explicit collections find the garbage cycles in it
+        a.cycle = a
+        wr = weakref.ref(a)
+        del a
+        gc.collect()
+        self.assertIsNone(wr())
+
+        gc.set_tenure_threshold(0)
+        self.assertEqual(gc.get_tenured_count(), 0)
+
     def test_get_objects(self):
         gc.collect()
         l = []
@@ -1117,6 +1307,9 @@ def test_collect(self):
             self.assertTrue("generation" in info)
             self.assertTrue("collected" in info)
             self.assertTrue("uncollectable" in info)
+            self.assertFalse(info["incremental"])
+            if v[1] == "stop":
+                self.assertGreaterEqual(info["duration"], 0)
 
     def test_collect_generation(self):
         self.preclean()
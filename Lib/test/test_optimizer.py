@@ -0,0 +1,290 @@
+# Tests for the tier-2 trace optimizer (-X uops)
+
+import platform
+import sys
+import textwrap
+import unittest
+from test.support import import_helper
+from test.support.script_helper import assert_python_ok
+
+_testinternalcapi = import_helper.import_module("_testinternalcapi")
+
+
+PRELUDE = """\
+import _testinternalcapi
+
+def stats():
+    return _testinternalcapi.get_optimizer_stats()
+"""
+
+
+class TestUOps(unittest.TestCase):
+    xoption = 'uops'
+
+    def run_uops(self, code):
+        """Run code with and without -X uops and compare its output."""
+        code = PRELUDE + textwrap.dedent(code)
+        _, out, err = assert_python_ok('-X', self.xoption, '-c', code)
+        _, expected, _ = assert_python_ok('-c', code)
+        self.assertEqual(err, b'')
+        return out.decode(), expected.decode()
+
+    def check(self, code):
+        out, expected = self.run_uops(code)
+        self.assertEqual(out, expected)
+
+    def test_disabled_by_default(self):
+        def f():
+            total = 0
+            for i in range(1000):
+                total += i
+            return total
+        f()
+        stats = _testinternalcapi.get_optimizer_stats()
+        self.assertEqual(stats["traces_created"], 0)
+
+    def test_trace_created(self):
+        out, _ = self.run_uops("""
+            def f(n):
+                total = 0
+                for i in range(n):
+                    total = total + i * 2
+                return total
+            print(f(1000), f(0), f(5))
+            s = stats()
+            print(s["traces_created"] > 0, s["iterations"] > 500)
+        """)
+        self.assertEqual(out.splitlines(), ["999000 0 20", "True True"])
+
+    def test_int_and_float_arithmetic(self):
+        self.check("""
+            def f(n):
+                a = 0
+                b = 0.5
+                for i in range(n):
+                    a = a + i * i
+                    b = b * 1.0001 + 0.25
+                return a, b
+            print(f(2000))
+            # Overflow past a single digit and into big ints
+            def g(n):
+                x = 1
+                for i in range(n):
+                    x = x * 3 + i
+                return x
+            print(g(300))
+        """)
+
+    def test_results_reuse_operands(self):
+        # Temporaries are overwritten in place, but never values that are
+        # still referenced elsewhere, nor the cached small ints.
+        self.check("""
+            def f(n):
+                x = 0.5
+                y = 1000
+                zero = 0
+                seen = []
+                for i in range(n):
+                    t = (x * 2.0 - x) - 0.25
+                    u = (y * 3 - y) - i
+                    seen.append((t, u, i - i is zero, x, y))
+                return seen[-1], len(set(seen))
+            print(f(500))
+        """)
+
+    def test_constant_folding(self):
+        out, expected = self.run_uops("""
+            def f(n):
+                total = 0
+                for i in range(n):
+                    k = 3
+                    total = total + k * 7
+                return total
+            print(f(1000))
+            s = stats()
+            print(s["constants_propagated"] > 0, s["constants_folded"] > 0)
+        """)
+        self.assertEqual(out.splitlines(), ["21000", "True True"])
+        self.assertEqual(expected.splitlines()[0], "21000")
+
+    def test_guards_and_increfs_removed(self):
+        out, _ = self.run_uops("""
+            def f(n):
+                total = 0
+                for i in range(n):
+                    total = total + i
+                    total = total + i
+                return total
+            print(f(1000))
+            s = stats()
+            print(s["guards_removed"] > 0, s["increfs_removed"] > 0)
+        """)
+        self.assertEqual(out.splitlines(), ["999000", "True True"])
+
+    def test_deopt(self):
+        # The types change after the trace is created
+        self.check("""
+            def f(items):
+                total = 0
+                for x in items:
+                    total = total + x
+                return total
+            data = list(range(100)) + [0.5, 1.5] + list(range(100)) + [10**30]
+            print(f(data))
+            print(f([1] * 100 + [True] * 100))
+        """)
+
+    def test_branches(self):
+        out, expected = self.run_uops("""
+            def f(n):
+                evens = odds = big = 0
+                for i in range(n):
+                    if i % 2 == 0:
+                        evens += 1
+                    else:
+                        odds += 1
+                    if i > 900:
+                        big += 1
+                return evens, odds, big
+            print(f(1000))
+            def g(n):
+                # The branch is taken almost always, so it gets flipped
+                count = 0
+                for i in range(n):
+                    if i < 10:
+                        continue
+                    count += 1
+                return count
+            print(g(5000))
+            s = stats()
+            print(s["traces_invalidated"] > 0)
+        """)
+        self.assertEqual(out.splitlines()[:2], expected.splitlines()[:2])
+        self.assertEqual(out.splitlines()[2], "True")
+
+    def test_subscripts(self):
+        self.check("""
+            def f(n):
+                a = [0] * 10
+                t = tuple(range(10))
+                for i in range(n):
+                    a[i % 10] = a[i % 10] + t[i % 10]
+                return a
+            print(f(1000))
+            def g(a):
+                total = 0
+                for i in range(len(a) + 1):
+                    total += a[i]
+                return total
+            try:
+                g(list(range(100)))
+            except IndexError as e:
+                print("IndexError", e)
+            d = {i: i for i in range(10)}
+            def h(n):
+                total = 0
+                for i in range(n):
+                    total += d[i % 10]
+                return total
+            print(h(1000))
+        """)
+
+    def test_errors(self):
+        self.check("""
+            import traceback
+            def f(n):
+                total = 0
+                for i in range(n):
+                    total = total + 1 / (i - 500)
+                return total
+            try:
+                f(1000)
+            except ZeroDivisionError:
+                tb = traceback.format_exc().splitlines()
+                print(tb[-2].strip(), tb[-1])
+        """)
+
+    def test_generic_iteration(self):
+        self.check("""
+            def f(d):
+                total = 0
+                for k, v in d.items():
+                    total += k * v
+                n = 0
+                for c in "abcdefgh" * 100:
+                    if c == "a":
+                        n += 1
+                return total, n
+            print(f({i: i + 1 for i in range(500)}))
+            def gen(n):
+                for i in range(n):
+                    yield i
+            def g(n):
+                total = 0
+                for x in gen(n):
+                    total = total + x
+                return total
+            print(g(1000))
+        """)
+
+    def test_globals(self):
+        self.check("""
+            SCALE = 3
+            def g(n):
+                total = 0
+                for i in range(n):
+                    total = total + SCALE
+                return total
+            print(g(1000))
+            SCALE = 5
+            print(g(1000))
+            # Adding a global changes the keys version
+            OTHER = 1
+            print(g(1000))
+        """)
+
+    def test_tracing(self):
+        self.check("""
+            import sys
+            lines = []
+            def tracer(frame, event, arg):
+                if frame.f_code.co_name == "f":
+                    lines.append(frame.f_lineno)
+                return tracer
+            def f(n):
+                total = 0
+                for i in range(n):
+                    total = total + i
+                    if i == 500:
+                        sys.settrace(tracer)
+                return total
+            print(f(1000))
+            sys.settrace(None)
+            print(len(lines) > 0)
+        """)
+
+
+class TestJIT(TestUOps):
+    # Run all the tests above with the traces compiled to machine code
+    xoption = 'jit'
+
+    @unittest.skipUnless(sys.platform == 'linux' and
+                         platform.machine() == 'x86_64',
+                         'the JIT is only available on x86-64 Linux')
+    def test_compiled(self):
+        out, _ = self.run_uops("""
+            def f(n):
+                total = 0.0
+                for i in range(n):
+                    if i % 3 == 0:
+                        total = total + i * 0.5
+                return total
+            print(f(3000))
+            s = stats()
+            print(s["jit_traces"] > 0, s["jit_failures"], s["jit_code_size"] > 0)
+        """)
+        self.assertEqual(out.splitlines(), ["749250.0", "True 0 True"])
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -320,14 +320,38 @@ def test_refcount(self):
         # the reference count to increase by 2 instead of 1.
         global n
         self.assertRaises(TypeError, sys.getrefcount)
-        c = sys.getrefcount(None)
-        n = None
-        self.assertEqual(sys.getrefcount(None), c+1)
+        o = object()
+        c = sys.getrefcount(o)
+        n = o
+        self.assertEqual(sys.getrefcount(o), c+1)
         del n
-        self.assertEqual(sys.getrefcount(None), c)
+        self.assertEqual(sys.getrefcount(o), c)
         if hasattr(sys, "gettotalrefcount"):
             self.assertIsInstance(sys.gettotalrefcount(), int)
 
+    @test.support.cpython_only
+    def test_immortal_singletons(self):
+        # The reference count of immortal objects never changes
+        for o in (None, True, False, Ellipsis, NotImplemented, 0, 256, -5):
+            with self.subTest(o=o):
+                c = sys.getrefcount(o)
+                refs = [o] * 100
+                self.assertEqual(sys.getrefcount(o), c)
+                del refs
+                self.assertEqual(sys.getrefcount(o), c)
+
+    def test_immortal_static_types(self):
+        # Static types are shared by all the interpreters: they are immortal,
+        # and so are their dict, keys and values
+        for o in (int, object, type, int.__dict__['__add__'],
+                  list.__dict__['append'], str.__dict__['__doc__']):
+            with self.subTest(o=o):
+                c = sys.getrefcount(o)
+                refs = [o] * 100
+                self.assertEqual(sys.getrefcount(o), c)
+                del refs
+                self.assertEqual(sys.getrefcount(o), c)
+
     def test_getframe(self):
         self.assertRaises(TypeError, sys._getframe, 42, 42)
         self.assertRaises(ValueError, sys._getframe, 2000000000)
@@ -841,6 +865,136 @@ def test_debugmallocstats(self):
         # The function has no parameter
         self.assertRaises(TypeError, sys._debugmallocstats, True)
 
+    @test.support.cpython_only
+    @unittest.skipIf(sys.platform == "win32", "needs sysconfig vars")
+    @unittest.skipUnless(sysconfig.get_config_var("WITH_FREELISTS"),
+                         'requires free lists')
+    @unittest.skipUnless(sysconfig.get_config_var("WITH_PYMALLOC"),
+                         'requires pymalloc')
+    def test_debugmallocstats_freelists(self):
+        from test.support.script_helper import assert_python_ok
+        code = textwrap.dedent('''
+            import gc, sys
+            class C:
+                def method(self):
+                    pass
+            c = C()
+            d = {1: 2}
+            s = 'abc'
+            for i in range(10):
+                [x for x in []]
+                list(range(3))
+                d.keys(), d.values(), d.items()
+                c.method
+                s[i:i + 2:1]
+                x = 2 ** 20 + i
+                del x
+            sys._debugmallocstats()
+            gc.collect()
+            sys._debugmallocstats()
+        ''')
+        ret, out, err = assert_python_ok('-c', code)
+        names = [b'list_iterator', b'dict view', b'PyMethodObject',
+                 b'PySliceObject', b'range_iterator', b'PyLongObject']
+        # a header starts the output of each sys._debugmallocstats() call
+        _, before, after = err.split(b'Small block threshold')
+        for name in names:
+            with self.subTest(name=name):
+                self.assertRegex(before, rb'\b[1-9][0-9]* free ' + name)
+                self.assertRegex(after, rb'\b0 free ' + name)
+
+    @test.support.cpython_only
+    @unittest.skipUnless(sysconfig.get_config_var("WITH_PYMALLOC"),
+                         'requires pymalloc')
+    def test_trim_memory(self):
+        from test.support.script_helper import assert_python_ok
+        code = textwrap.dedent('''
+            import sys
+            # Keep a few objects in each arena, so that they aren't freed
+            x = [[i] for i in range(300000)]
+            keep = x[::2000]
+            del x
+            released = sys._trim_memory()
+            print(released > 0, sys._trim_memory())
+            x = [[i] for i in range(300000)]
+            print(sum(l[0] for l in x))
+            sys._debugmallocstats()
+        ''')
+        ret, out, err = assert_python_ok('-c', code, PYTHONMALLOC='')
+        if sys.platform == 'win32':
+            self.assertEqual(out.split()[:2], [b'False', b'0'])
+        else:
+            self.assertEqual(out.split()[:2], [b'True', b'0'])
+        self.assertEqual(int(out.split()[2]), sum(range(300000)))
+        self.assertIn(b'# unused pools trimmed', err)
+        self.assertIn(b'# blocks in thread caches', err)
+        self.assertRaises(TypeError, sys._trim_memory, True)
+
+    @test.support.cpython_only
+    @unittest.skipUnless(sys.platform == 'linux', 'Linux only')
+    @unittest.skipUnless(sysconfig.get_config_var("WITH_PYMALLOC"),
+                         'requires pymalloc')
+    def test_debugmallocstats_hugepages(self):
+        from test.support.script_helper import assert_python_ok
+        code = ('import sys; '
+                'x = [[i] for i in range(300000)]; '
+                'sys._debugmallocstats(); '
+                'del x; '
+                'sys._debugmallocstats()')
+        for mode in 'hugepages', 'hugepages_numa':
+            with self.subTest(mode=mode):
+                ret, out, err = assert_python_ok(
+                    '-c', code, PYTHONMALLOCARENA=mode, PYTHONMALLOC='')
+                self.assertRegex(err, rb'arena allocator += +' +
+                                      mode.encode() + b'\n')
+                self.assertRegex(err, rb'chunks \* 16777216 bytes/chunk')
+        ret, out, err = assert_python_ok(
+            '-c', code, PYTHONMALLOCARENA='default', PYTHONMALLOC='')
+        self.assertRegex(err, rb'arena allocator += +default\n')
+        self.assertNotIn(b'bytes/chunk', err)
+
+    def test_get_specialization_stats(self):
+        def f():
+            pass
+        for _ in range(100):
+            f()
+        self.assertIsNone(sys._get_specialization_stats(f.__code__))
+        self.assertRaises(TypeError, sys._get_specialization_stats, f)
+
+        code = textwrap.dedent("""
+            import dis, sys
+            class A:
+                def __init__(self):
+                    self.x = 1
+                @property
+                def p(self):
+                    return 2
+            class B:
+                x = 3
+                p = 4
+            def f(objs):
+                total = 0
+                for o in objs:
+                    total += o.x
+                    total += o.p
+                return total
+            f([A()] * 100)
+            f([B()] * 10)
+            stats = sys._get_specialization_stats(f.__code__)
+            for inst in dis.get_instructions(f):
+                if inst.opname == "LOAD_ATTR":
+                    s = stats[inst.offset]
+                    print(inst.argval, s["hit"] > 0, s["miss"],
+                          s["specialization_success"] > 0,
+                          s["specialization_failure"] > 0,
+                          sum(s["specialization_failure_kinds"]) > 0)
+        """)
+        rc, out, err = assert_python_ok('-X', 'specialization_stats',
+                                        '-c', code)
+        self.assertEqual(out.decode().splitlines(),
+                         ["x True 10 True False False",
+                          "p False 0 False True True"])
+
     @unittest.skipUnless(hasattr(sys, "getallocatedblocks"),
                          "sys.getallocatedblocks unavailable on this build")
     def test_getallocatedblocks(self):
@@ -1430,7 +1584,7 @@ def delx(self): del self.__x
                   '3P'                  # PyMappingMethods
                   '10P'                 # PySequenceMethods
                   '2P'                  # PyBufferProcs
-                  '6P')
+                  '7PI')
         class newstyleclass(object): pass
         # Separate block for PyDictKeysObject with 8 keys and 5 entries
         check(newstyleclass, s + calcsize(DICT_KEY_STRUCT_FORMAT) + 32 + 21*calcsize("n2P"))
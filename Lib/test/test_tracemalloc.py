@@ -1,4 +1,6 @@
 import contextlib
+import io
+import math
 import os
 import sys
 import tracemalloc
@@ -13,6 +15,10 @@
     import _testcapi
 except ImportError:
     _testcapi = None
+try:
+    import gzip
+except ImportError:
+    gzip = None
 
 
 EMPTY_STRING_SIZE = sys.getsizeof(b'')
@@ -39,6 +45,46 @@ def allocate_bytes(size):
     data = b'x' * bytes_len
     return data, tracemalloc.Traceback(frames, min(len(frames), nframe))
 
+def decode_protobuf(data):
+    # Decode a protobuf message into a list of (field, value) tuples:
+    # value is an int for varints, bytes for length-delimited fields
+    fields = []
+    pos = 0
+    def varint():
+        nonlocal pos
+        value = shift = 0
+        while True:
+            byte = data[pos]
+            pos += 1
+            value |= (byte & 0x7f) << shift
+            shift += 7
+            if byte < 0x80:
+                return value
+    while pos < len(data):
+        key = varint()
+        field, wire_type = key >> 3, key & 7
+        if wire_type == 0:
+            fields.append((field, varint()))
+        elif wire_type == 2:
+            size = varint()
+            fields.append((field, data[pos:pos + size]))
+            pos += size
+        else:
+            raise ValueError(f"unsupported wire type {wire_type}")
+    return fields
+
+def decode_varints(data):
+    # Decode a packed repeated field of varints
+    values = []
+    value = shift = 0
+    for byte in data:
+        value |= (byte & 0x7f) << shift
+        shift += 7
+        if byte < 0x80:
+            values.append(value)
+            value = shift = 0
+    return values
+
 def create_snapshots():
     traceback_limit = 2
 
@@ -333,6 +379,120 @@ def test_snapshot_save_attr(self):
         snapshot2 = tracemalloc.Snapshot.load(os_helper.TESTFN)
         self.assertEqual(snapshot2.test_attr, "new")
 
+    def test_sample_rate(self):
+        tracemalloc.stop()
+        self.assertEqual(tracemalloc.get_sample_rate(), 0)
+        with self.assertRaises(ValueError):
+            tracemalloc.start(1, sample_rate=-1)
+
+        sample_rate = 64 * 1024
+        tracemalloc.start(1, sample_rate=sample_rate)
+        self.assertEqual(tracemalloc.get_sample_rate(), sample_rate)
+
+        # a memory block much larger than the sample rate is always sampled
+        obj, obj_traceback = allocate_bytes(100 * sample_rate)
+        self.assertEqual(tracemalloc.get_object_traceback(obj),
+                         obj_traceback)
+
+        # statistics estimate the total size of the allocations
+        obj_size = 1000
+        data = [allocate_bytes(obj_size)[0] for _ in range(4000)]
+        snapshot = tracemalloc.take_snapshot()
+        self.assertEqual(snapshot.sample_rate, sample_rate)
+        lineno = allocate_bytes.__code__.co_firstlineno + 4
+        snapshot = snapshot.filter_traces([
+            tracemalloc.Filter(True, __file__, lineno)])
+        self.assertEqual(snapshot.sample_rate, sample_rate)
+        self.assertLess(len(snapshot.traces), len(data))
+        stats = snapshot.statistics('filename')
+        size = sum(stat.size for stat in stats)
+        total = obj_size * len(data) + 100 * sample_rate
+        self.assertGreater(size, total // 2)
+        self.assertLess(size, total * 2)
+
+    def load_pprof(self, data):
+        profile = decode_protobuf(gzip.decompress(data))
+        strings = [value.decode() for field, value in profile if field == 6]
+        self.assertEqual(strings[0], '')
+        sample_types = [
+            tuple(strings[value] for field, value in decode_protobuf(msg))
+            for field, msg in profile if field == 1]
+        self.assertEqual(sample_types,
+                         [('objects', 'count'), ('space', 'bytes')])
+        functions = {}
+        for field, msg in profile:
+            if field == 5:
+                function = dict(decode_protobuf(msg))
+                functions[function[1]] = strings[function[4]]
+        locations = {}
+        for field, msg in profile:
+            if field == 4:
+                location = dict(decode_protobuf(msg))
+                line = dict(decode_protobuf(location[4]))
+                locations[location[1]] = (functions[line[1]], line[2])
+        samples = []
+        for field, msg in profile:
+            if field == 2:
+                sample = dict(decode_protobuf(msg))
+                frames = tuple(locations[location_id] for location_id
+                               in decode_varints(sample[1]))
+                samples.append((frames, *decode_varints(sample[2])))
+        period = dict(profile).get(12, 0)
+        return samples, period
+
+    @unittest.skipIf(gzip is None, 'requires gzip')
+    def test_dump_pprof(self):
+        obj_size = 12345
+        obj, obj_traceback = allocate_bytes(obj_size)
+        frame = obj_traceback[0]
+        self.addCleanup(os_helper.unlink, os_helper.TESTFN)
+
+        tracemalloc.dump_pprof(os_helper.TESTFN)
+        with open(os_helper.TESTFN, "rb") as fp:
+            samples, period = self.load_pprof(fp.read())
+        self.assertEqual(period, 0)
+        sizes = [size for frames, count, size in samples
+                 if frames[0] == (frame.filename, frame.lineno)]
+        self.assertEqual(len(sizes), 1)
+        self.assertGreaterEqual(sizes[0], obj_size)
+
+        # file descriptor and file object
+        with open(os_helper.TESTFN, "wb") as fp:
+            tracemalloc.dump_pprof(fp.fileno())
+        with open(os_helper.TESTFN, "rb") as fp:
+            self.load_pprof(fp.read())
+        fp = io.BytesIO()
+        tracemalloc.dump_pprof(fp)
+        self.assertFalse(fp.closed)
+        self.load_pprof(fp.getvalue())
+
+        # the profile is empty if tracemalloc is not tracing
+        tracemalloc.stop()
+        fp = io.BytesIO()
+        tracemalloc.dump_pprof(fp)
+        self.assertEqual(self.load_pprof(fp.getvalue()), ([], 0))
+
+    @unittest.skipIf(gzip is None, 'requires gzip')
+    def test_dump_pprof_sample_rate(self):
+        tracemalloc.stop()
+        sample_rate = 64 * 1024
+        tracemalloc.start(1, sample_rate=sample_rate)
+        data = [allocate_bytes(1000)[0] for _ in range(4000)]
+        lineno = allocate_bytes.__code__.co_firstlineno + 4
+
+        fp = io.BytesIO()
+        tracemalloc.dump_pprof(fp)
+        samples, period = self.load_pprof(fp.getvalue())
+        self.assertEqual(period, sample_rate)
+        sizes = [(count, size) for frames, count, size in samples
+                 if frames[0] == (__file__, lineno)]
+        self.assertEqual(len(sizes), 1)
+        count, size = sizes[0]
+        self.assertGreater(size, len(data) * 1000 // 2)
+        self.assertLess(size, len(data) * 1000 * 2)
+        self.assertGreater(count, len(data) // 2)
+        self.assertLess(count, len(data) * 2)
+
     def fork_child(self):
         if not tracemalloc.is_tracing():
             return 2
@@ -506,6 +666,28 @@ def test_snapshot_group_by_line(self):
             tracemalloc.StatisticDiff(tb_a_2, 30, 0, 3, 0),
         ])
 
+    def test_snapshot_sample_rate(self):
+        raw_traces = [
+            (0, 100, (('a.py', 2),), 1),
+            (0, 100, (('a.py', 2),), 1),
+            (0, 10**6, (('b.py', 1),), 1),
+        ]
+        snapshot = tracemalloc.Snapshot(raw_traces, 1, sample_rate=1000)
+        weight = 1 / (1 - math.exp(-100 / 1000))
+        self.assertEqual(snapshot.statistics('lineno'), [
+            tracemalloc.Statistic(traceback_lineno('b.py', 1), 10**6, 1),
+            tracemalloc.Statistic(traceback_lineno('a.py', 2),
+                                  round(200 * weight), round(2 * weight)),
+        ])
+        self.assertEqual(snapshot.filter_traces([]).sample_rate, 1000)
+
+        # traces are not scaled without sampling
+        snapshot = tracemalloc.Snapshot(raw_traces, 1)
+        self.assertEqual(snapshot.sample_rate, 0)
+        self.assertEqual(snapshot.statistics('filename')[1],
+                         tracemalloc.Statistic(traceback_filename('a.py'),
+                                               200, 2))
+
     def test_snapshot_group_by_file(self):
         snapshot, snapshot2 = create_snapshots()
         tb_0 = traceback_filename('<unknown>')
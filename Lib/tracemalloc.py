@@ -2,12 +2,13 @@
 from functools import total_ordering
 import fnmatch
 import linecache
+import math
 import os.path
 import pickle
 
 # Import types and functions implemented in C
 from _tracemalloc import *
-from _tracemalloc import _get_object_traceback, _get_traces
+from _tracemalloc import _get_object_traceback, _get_traces, _dump_pprof
 
 
 def _format_size(size, sign):
@@ -417,11 +418,15 @@ class Snapshot:
     Snapshot of traces of memory blocks allocated by Python.
     """
 
-    def __init__(self, traces, traceback_limit):
+    # Snapshots pickled before sampling was added have no sample_rate
+    sample_rate = 0
+
+    def __init__(self, traces, traceback_limit, sample_rate=0):
         # traces is a tuple of trace tuples: see _Traces constructor for
         # the exact format
         self.traces = _Traces(traces)
         self.traceback_limit = traceback_limit
+        self.sample_rate = sample_rate
 
     def dump(self, filename):
         """
@@ -472,7 +477,7 @@ def filter_traces(self, filters):
                                                 trace)]
         else:
             new_traces = self.traces._traces.copy()
-        return Snapshot(new_traces, self.traceback_limit)
+        return Snapshot(new_traces, self.traceback_limit, self.sample_rate)
 
     def _group_by(self, key_type, cumulative):
         if key_type not in ('traceback', 'filename', 'lineno'):
@@ -483,9 +488,21 @@ def _group_by(self, key_type, cumulative):
 
         stats = {}
         tracebacks = {}
+        sample_rate = self.sample_rate
+        if sample_rate:
+            # A memory block of size bytes was sampled with the probability
+            # 1 - exp(-size / sample_rate): weight each trace by the inverse
+            # of this probability to estimate the total of all allocations.
+            def scale(size):
+                weight = 1.0 / -math.expm1(-size / sample_rate)
+                return size * weight, weight
         if not cumulative:
             for trace in self.traces._traces:
                 domain, size, trace_traceback, total_nframe = trace
+                if sample_rate:
+                    size, count = scale(size)
+                else:
+                    count = 1
                 try:
                     traceback = tracebacks[trace_traceback]
                 except KeyError:
@@ -500,13 +517,17 @@ def _group_by(self, key_type, cumulative):
                 try:
                     stat = stats[traceback]
                     stat.size += size
-                    stat.count += 1
+                    stat.count += count
                 except KeyError:
-                    stats[traceback] = Statistic(traceback, size, 1)
+                    stats[traceback] = Statistic(traceback, size, count)
         else:
             # cumulative statistics
             for trace in self.traces._traces:
                 domain, size, trace_traceback, total_nframe = trace
+                if sample_rate:
+                    size, count = scale(size)
+                else:
+                    count = 1
                 for frame in trace_traceback:
                     try:
                         traceback = tracebacks[frame]
@@ -520,9 +541,13 @@ def _group_by(self, key_type, cumulative):
                     try:
                         stat = stats[traceback]
                         stat.size += size
-                        stat.count += 1
+                        stat.count += count
                     except KeyError:
-                        stats[traceback] = Statistic(traceback, size, 1)
+                        stats[traceback] = Statistic(traceback, size, count)
+        if sample_rate:
+            for stat in stats.values():
+                stat.size = round(stat.size)
+                stat.count = round(stat.count)
         return stats
 
     def statistics(self, key_type, cumulative=False):
@@ -557,4 +582,30 @@ def take_snapshot():
                            "allocations to take a snapshot")
     traces = _get_traces()
     traceback_limit = get_traceback_limit()
-    return Snapshot(traces, traceback_limit)
+    sample_rate = get_sample_rate()
+    return Snapshot(traces, traceback_limit, sample_rate)
+
+
+def dump_pprof(file):
+    """
+    Write the traces of memory blocks allocated by Python into file in the
+    pprof format: a gzip-compressed profile.proto message.
+
+    file is a file name, a file descriptor or a binary file object. The
+    profile is compressed and written incrementally, without building a
+    snapshot of the traces in memory.
+    """
+    import gzip
+
+    if isinstance(file, int):
+        fp = open(file, "wb", closefd=False)
+    elif isinstance(file, (str, bytes, os.PathLike)):
+        fp = open(file, "wb")
+    else:
+        fp = None
+    try:
+        with gzip.GzipFile(fileobj=fp or file, mode="wb") as gzip_file:
+            _dump_pprof(gzip_file.write)
+    finally:
+        if fp is not None:
+            fp.close()
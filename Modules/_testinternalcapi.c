@@ -19,6 +19,7 @@
 #include "pycore_hashtable.h"    // _Py_hashtable_new()
 #include "pycore_initconfig.h"   // _Py_GetConfigsAsDict()
 #include "pycore_interp.h"       // _PyInterpreterState_GetConfigCopy()
+#include "pycore_optimizer.h"    // _PyOptimizer_GetStats()
 #include "pycore_pyerrors.h"     // _Py_UTF8_Edit_Cost()
 #include "pycore_pystate.h"      // _PyThreadState_GET()
 #include "osdefs.h"               // MAXPATHLEN
@@ -389,6 +390,13 @@ normalize_path(PyObject *self, PyObject *filename)
 }
 
 
+static PyObject *
+get_optimizer_stats(PyObject *self, PyObject *Py_UNUSED(args))
+{
+    return _PyOptimizer_GetStats(_PyInterpreterState_GET());
+}
+
+
 static PyMethodDef TestMethods[] = {
     {"get_configs", get_configs, METH_NOARGS},
     {"get_recursion_depth", get_recursion_depth, METH_NOARGS},
@@ -401,6 +409,7 @@ static PyMethodDef TestMethods[] = {
     {"test_atomic_funcs", test_atomic_funcs, METH_NOARGS},
     {"test_edit_cost", test_edit_cost, METH_NOARGS},
     {"normalize_path", normalize_path, METH_O, NULL},
+    {"get_optimizer_stats", get_optimizer_stats, METH_NOARGS},
     {NULL, NULL} /* sentinel */
 };
 
@@ -5,6 +5,7 @@
 #include "pycore_hashtable.h"
 #include <pycore_frame.h>
 
+#include <math.h>                 // log()
 #include <stdlib.h>               // malloc()
 
 #include "clinic/_tracemalloc.c.h"
@@ -111,6 +112,19 @@ static size_t tracemalloc_traced_memory = 0;
    Protected by TABLES_LOCK(). */
 static size_t tracemalloc_peak_traced_memory = 0;
 
+/* Average number of bytes between two sampled memory allocations,
+   or 0 to trace all memory allocations.
+   Protected by the GIL. */
+static size_t tracemalloc_sample_rate = 0;
+
+/* Number of bytes left to allocate before the next sampled allocation.
+   Protected by the GIL. */
+static size_t tracemalloc_sample_countdown = 0;
+
+/* State of the xorshift64* pseudo-random number generator used to draw
+   sampling intervals. Protected by the GIL. */
+static uint64_t tracemalloc_sample_state = 0;
+
 /* Hash table used as a set to intern filenames:
    PyObject* => PyObject*.
    Protected by the GIL */
@@ -494,6 +508,68 @@ tracemalloc_get_traces_table(unsigned int domain)
 }
 
 
+/* Draw the number of bytes until the next sampled allocation from an
+   exponential distribution of mean tracemalloc_sample_rate, so that sampled
+   bytes form a Poisson process: a memory block of size bytes is sampled with
+   the probability 1 - exp(-size / sample_rate). */
+static size_t
+tracemalloc_next_sample_interval(void)
+{
+    uint64_t x = tracemalloc_sample_state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    tracemalloc_sample_state = x;
+    x *= UINT64_C(0x2545F4914F6CDD1D);
+
+    /* uniform in (0.0; 1.0] */
+    double u = ((double)(x >> 11) + 1.0) * (1.0 / 9007199254740992.0);
+    double interval = -log(u) * (double)tracemalloc_sample_rate;
+    if (interval >= (double)SIZE_MAX) {
+        return SIZE_MAX;
+    }
+    return (size_t)interval + 1;
+}
+
+
+static void
+tracemalloc_init_sampling(size_t sample_rate)
+{
+    tracemalloc_sample_rate = sample_rate;
+    if (sample_rate == 0) {
+        return;
+    }
+
+    uint64_t seed;
+    if (_PyOS_URandomNonblock(&seed, sizeof(seed)) < 0) {
+        PyErr_Clear();
+        seed = (uint64_t)_PyTime_GetPerfCounter() ^ (uint64_t)(uintptr_t)&seed;
+    }
+    /* xorshift requires a non-zero state */
+    tracemalloc_sample_state = seed ? seed : UINT64_C(0x9E3779B97F4A7C15);
+    tracemalloc_sample_countdown = tracemalloc_next_sample_interval();
+}
+
+
+/* Return non-zero if a memory allocation of size bytes must be traced.
+
+   Called with the GIL held, before TABLES_LOCK(): memory allocations which
+   are not sampled don't pay for the lock nor for the traceback. */
+static inline int
+tracemalloc_sample(size_t size)
+{
+    if (tracemalloc_sample_rate == 0) {
+        return 1;
+    }
+    if (size < tracemalloc_sample_countdown) {
+        tracemalloc_sample_countdown -= size;
+        return 0;
+    }
+    tracemalloc_sample_countdown = tracemalloc_next_sample_interval();
+    return 1;
+}
+
+
 static void
 tracemalloc_remove_trace(unsigned int domain, uintptr_t ptr)
 {
@@ -592,6 +668,10 @@ tracemalloc_alloc(int use_calloc, void *ctx, size_t nelem, size_t elsize)
     if (ptr == NULL)
         return NULL;
 
+    if (!tracemalloc_sample(nelem * elsize)) {
+        return ptr;
+    }
+
     TABLES_LOCK();
     if (ADD_TRACE(ptr, nelem * elsize) < 0) {
         /* Failed to allocate a trace for the new memory block */
@@ -614,6 +694,16 @@ tracemalloc_realloc(void *ctx, void *ptr, size_t new_size)
     if (ptr2 == NULL)
         return NULL;
 
+    if (!tracemalloc_sample(new_size)) {
+        if (ptr != NULL) {
+            /* the resized memory block is not sampled: drop its old trace */
+            TABLES_LOCK();
+            REMOVE_TRACE(ptr);
+            TABLES_UNLOCK();
+        }
+        return ptr2;
+    }
+
     if (ptr != NULL) {
         /* an existing memory block has been resized */
 
@@ -952,7 +1042,7 @@ tracemalloc_deinit(void)
 
 
 static int
-tracemalloc_start(int max_nframe)
+tracemalloc_start(int max_nframe, Py_ssize_t sample_rate)
 {
     PyMemAllocatorEx alloc;
     size_t size;
@@ -964,6 +1054,12 @@ tracemalloc_start(int max_nframe)
         return -1;
     }
 
+    if (sample_rate < 0) {
+        PyErr_SetString(PyExc_ValueError,
+                        "the sample rate must be greater than or equal to 0");
+        return -1;
+    }
+
     if (tracemalloc_init() < 0) {
         return -1;
     }
@@ -974,6 +1070,7 @@ tracemalloc_start(int max_nframe)
     }
 
     _Py_tracemalloc_config.max_nframe = max_nframe;
+    tracemalloc_init_sampling((size_t)sample_rate);
 
     /* allocate a buffer to store a new traceback */
     size = TRACEBACK_SIZE(max_nframe);
@@ -1476,6 +1573,643 @@ _tracemalloc__get_object_traceback(PyObject *module, PyObject *obj)
 }
 
 
+/* Export of traces in the pprof format: a profile.proto message of
+   github.com/google/pprof.
+
+   Traces are first aggregated by (domain, traceback) while holding
+   TABLES_LOCK(): the memory needed is proportional to the number of distinct
+   tracebacks, not to the number of traces. The profile is then encoded and
+   passed by chunks of PPROF_CHUNK_SIZE bytes to a write() callable, without
+   holding the lock. Tracebacks are copied and their filenames are strong
+   references, so the export is not affected by clear_traces() or stop()
+   being called from the write() callable or by another thread. */
+
+#define PPROF_CHUNK_SIZE (64 * 1024)
+
+/* Field numbers of the messages of profile.proto */
+#define PPROF_PROFILE_SAMPLE_TYPE 1
+#define PPROF_PROFILE_SAMPLE 2
+#define PPROF_PROFILE_LOCATION 4
+#define PPROF_PROFILE_FUNCTION 5
+#define PPROF_PROFILE_STRING_TABLE 6
+#define PPROF_PROFILE_TIME_NANOS 9
+#define PPROF_PROFILE_PERIOD_TYPE 11
+#define PPROF_PROFILE_PERIOD 12
+#define PPROF_VALUE_TYPE_TYPE 1
+#define PPROF_VALUE_TYPE_UNIT 2
+#define PPROF_SAMPLE_LOCATION_ID 1
+#define PPROF_SAMPLE_VALUE 2
+#define PPROF_SAMPLE_LABEL 3
+#define PPROF_LABEL_KEY 1
+#define PPROF_LABEL_NUM 3
+#define PPROF_LOCATION_ID 1
+#define PPROF_LOCATION_LINE 4
+#define PPROF_LINE_FUNCTION_ID 1
+#define PPROF_LINE_LINE 2
+#define PPROF_FUNCTION_ID 1
+#define PPROF_FUNCTION_NAME 2
+#define PPROF_FUNCTION_FILENAME 4
+
+/* Wire types of the protobuf encoding */
+#define PB_VARINT 0
+#define PB_LEN 2
+
+/* Indexes of the strings which start the string table */
+enum {
+    PPROF_STR_EMPTY = 0,
+    PPROF_STR_OBJECTS,
+    PPROF_STR_COUNT,
+    PPROF_STR_SPACE,
+    PPROF_STR_BYTES,
+    PPROF_STR_DOMAIN,
+    PPROF_NSTR
+};
+
+static const char* const pprof_strings[PPROF_NSTR] = {
+    "", "objects", "count", "space", "bytes", "domain"
+};
+
+/* Aggregated traces of a (domain, traceback) pair: a pprof sample */
+typedef struct {
+    unsigned int domain;
+    /* Estimated number and size of the memory blocks: traces are scaled up
+       if allocations are sampled */
+    double count;
+    double size;
+    /* Interned traceback: only used as a key, it is never dereferenced
+       after TABLES_LOCK() is released */
+    const traceback_t *interned;
+    /* Copy of the traceback with strong references to the filenames */
+    traceback_t *traceback;
+} pprof_sample_t;
+
+typedef struct {
+    _Py_hashtable_t *samples;
+    size_t sample_rate;
+    unsigned int domain;
+} pprof_aggregate_t;
+
+typedef struct {
+    unsigned char *data;
+    size_t len;
+    size_t size;
+} pb_buffer_t;
+
+typedef struct {
+    PyObject *write;
+    /* Profile message being written, flushed to write() by chunks */
+    pb_buffer_t out;
+    /* Scratch buffers used to encode nested messages */
+    pb_buffer_t msg;
+    pb_buffer_t packed;
+    /* filename (PyObject*) => index in the string table, which is also used
+       as the function identifier */
+    _Py_hashtable_t *functions;
+    /* frame_t* => location identifier */
+    _Py_hashtable_t *locations;
+    uint64_t nstring;
+    uint64_t nlocation;
+} pprof_writer_t;
+
+
+static Py_uhash_t
+hashtable_hash_pprof_sample(const void *key)
+{
+    const pprof_sample_t *sample = (const pprof_sample_t *)key;
+    return sample->traceback->hash ^ (Py_uhash_t)sample->domain;
+}
+
+
+static int
+hashtable_compare_pprof_sample(const void *key1, const void *key2)
+{
+    const pprof_sample_t *sample1 = (const pprof_sample_t *)key1;
+    const pprof_sample_t *sample2 = (const pprof_sample_t *)key2;
+    return (sample1->domain == sample2->domain
+            && sample1->interned == sample2->interned);
+}
+
+
+static void
+pprof_sample_free(void *value)
+{
+    pprof_sample_t *sample = (pprof_sample_t *)value;
+    for (int i=0; i < sample->traceback->nframe; i++) {
+        Py_DECREF(sample->traceback->frames[i].filename);
+    }
+    free(sample->traceback);
+    free(sample);
+}
+
+
+static Py_uhash_t
+hashtable_hash_frame(const void *key)
+{
+    const frame_t *frame = (const frame_t *)key;
+    return _Py_HashPointer(frame->filename) ^ (Py_uhash_t)frame->lineno;
+}
+
+
+static int
+hashtable_compare_frame(const void *key1, const void *key2)
+{
+    const frame_t *frame1 = (const frame_t *)key1;
+    const frame_t *frame2 = (const frame_t *)key2;
+    return (frame1->filename == frame2->filename
+            && frame1->lineno == frame2->lineno);
+}
+
+
+static int
+pprof_aggregate_trace(_Py_hashtable_t *traces,
+                      const void *key, const void *value,
+                      void *user_data)
+{
+    pprof_aggregate_t *aggregate = (pprof_aggregate_t *)user_data;
+    const trace_t *trace = (const trace_t *)value;
+
+    double count = 1.0;
+    double size = (double)trace->size;
+    if (aggregate->sample_rate != 0 && trace->size != 0) {
+        /* the memory block was sampled with the probability
+           1 - exp(-size / sample_rate) */
+        count = 1.0 / -expm1(-size / (double)aggregate->sample_rate);
+        size *= count;
+    }
+
+    /* Tracebacks are interned: compare them by address */
+    pprof_sample_t lookup;
+    lookup.domain = aggregate->domain;
+    lookup.interned = trace->traceback;
+    lookup.traceback = trace->traceback;
+    pprof_sample_t *sample = _Py_hashtable_get(aggregate->samples, &lookup);
+    if (sample != NULL) {
+        sample->count += count;
+        sample->size += size;
+        return 0;
+    }
+
+    sample = malloc(sizeof(pprof_sample_t));
+    if (sample == NULL) {
+        return -1;
+    }
+    size_t tb_size = TRACEBACK_SIZE(trace->traceback->nframe);
+    sample->traceback = malloc(tb_size);
+    if (sample->traceback == NULL) {
+        free(sample);
+        return -1;
+    }
+    memcpy(sample->traceback, trace->traceback, tb_size);
+    for (int i=0; i < sample->traceback->nframe; i++) {
+        Py_INCREF(sample->traceback->frames[i].filename);
+    }
+    sample->domain = aggregate->domain;
+    sample->count = count;
+    sample->size = size;
+    sample->interned = trace->traceback;
+
+    if (_Py_hashtable_set(aggregate->samples, sample, sample) < 0) {
+        pprof_sample_free(sample);
+        return -1;
+    }
+    return 0;
+}
+
+
+static int
+pb_reserve(pb_buffer_t *buf, size_t size)
+{
+    if (buf->len + size <= buf->size) {
+        return 0;
+    }
+    size_t new_size = Py_MAX(buf->size * 2, buf->len + size);
+    new_size = Py_MAX(new_size, 256);
+    unsigned char *data = realloc(buf->data, new_size);
+    if (data == NULL) {
+        return -1;
+    }
+    buf->data = data;
+    buf->size = new_size;
+    return 0;
+}
+
+
+static int
+pb_put_varint(pb_buffer_t *buf, uint64_t value)
+{
+    if (pb_reserve(buf, 10) < 0) {
+        return -1;
+    }
+    while (value >= 0x80) {
+        buf->data[buf->len++] = (unsigned char)(value | 0x80);
+        value >>= 7;
+    }
+    buf->data[buf->len++] = (unsigned char)value;
+    return 0;
+}
+
+
+static int
+pb_put_uint(pb_buffer_t *buf, int field, uint64_t value)
+{
+    if (pb_put_varint(buf, ((uint64_t)field << 3) | PB_VARINT) < 0) {
+        return -1;
+    }
+    return pb_put_varint(buf, value);
+}
+
+
+static int
+pb_put_bytes(pb_buffer_t *buf, int field, const void *data, size_t size)
+{
+    if (pb_put_varint(buf, ((uint64_t)field << 3) | PB_LEN) < 0
+        || pb_put_varint(buf, size) < 0
+        || pb_reserve(buf, size) < 0)
+    {
+        return -1;
+    }
+    memcpy(buf->data + buf->len, data, size);
+    buf->len += size;
+    return 0;
+}
+
+
+/* Write the pending chunk of the profile to the write() callable */
+static int
+pprof_flush(pprof_writer_t *writer)
+{
+    if (writer->out.len == 0) {
+        return 0;
+    }
+    PyObject *chunk = PyBytes_FromStringAndSize((const char *)writer->out.data,
+                                                writer->out.len);
+    if (chunk == NULL) {
+        return -1;
+    }
+    writer->out.len = 0;
+    PyObject *res = PyObject_CallOneArg(writer->write, chunk);
+    Py_DECREF(chunk);
+    if (res == NULL) {
+        return -1;
+    }
+    Py_DECREF(res);
+    return 0;
+}
+
+
+/* Add the message encoded in writer->msg to the profile as the field
+   of number field */
+static int
+pprof_put_message(pprof_writer_t *writer, int field)
+{
+    if (pb_put_bytes(&writer->out, field,
+                     writer->msg.data, writer->msg.len) < 0) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    writer->msg.len = 0;
+    if (writer->out.len >= PPROF_CHUNK_SIZE) {
+        return pprof_flush(writer);
+    }
+    return 0;
+}
+
+
+static int
+pprof_put_string(pprof_writer_t *writer, const char *str, size_t size)
+{
+    if (pb_put_bytes(&writer->out, PPROF_PROFILE_STRING_TABLE,
+                     str, size) < 0) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    writer->nstring++;
+    return 0;
+}
+
+
+static int
+pprof_put_value_type(pprof_writer_t *writer, int field,
+                     uint64_t type, uint64_t unit)
+{
+    if (pb_put_uint(&writer->msg, PPROF_VALUE_TYPE_TYPE, type) < 0
+        || pb_put_uint(&writer->msg, PPROF_VALUE_TYPE_UNIT, unit) < 0)
+    {
+        PyErr_NoMemory();
+        return -1;
+    }
+    return pprof_put_message(writer, field);
+}
+
+
+/* Get the identifier of the function of a filename. Python frames only
+   store a filename and a line number: a pprof function is a file. */
+static int
+pprof_get_function(pprof_writer_t *writer, PyObject *filename,
+                   uint64_t *function_id)
+{
+    _Py_hashtable_entry_t *entry;
+    entry = _Py_hashtable_get_entry(writer->functions, filename);
+    if (entry != NULL) {
+        *function_id = (uint64_t)FROM_PTR(entry->value);
+        return 0;
+    }
+
+    PyObject *bytes = PyUnicode_AsEncodedString(filename, "utf-8",
+                                                "backslashreplace");
+    if (bytes == NULL) {
+        return -1;
+    }
+    uint64_t id = writer->nstring;
+    int res = pprof_put_string(writer, PyBytes_AS_STRING(bytes),
+                               PyBytes_GET_SIZE(bytes));
+    Py_DECREF(bytes);
+    if (res < 0) {
+        return -1;
+    }
+
+    if (pb_put_uint(&writer->msg, PPROF_FUNCTION_ID, id) < 0
+        || pb_put_uint(&writer->msg, PPROF_FUNCTION_NAME, id) < 0
+        || pb_put_uint(&writer->msg, PPROF_FUNCTION_FILENAME, id) < 0)
+    {
+        PyErr_NoMemory();
+        return -1;
+    }
+    if (pprof_put_message(writer, PPROF_PROFILE_FUNCTION) < 0) {
+        return -1;
+    }
+
+    /* the sample keeps a strong reference to filename */
+    if (_Py_hashtable_set(writer->functions, filename,
+                          (void *)(uintptr_t)id) < 0) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    *function_id = id;
+    return 0;
+}
+
+
+static int
+pprof_get_location(pprof_writer_t *writer, const frame_t *frame,
+                   uint64_t *location_id)
+{
+    _Py_hashtable_entry_t *entry;
+    entry = _Py_hashtable_get_entry(writer->locations, frame);
+    if (entry != NULL) {
+        *location_id = (uint64_t)FROM_PTR(entry->value);
+        return 0;
+    }
+
+    uint64_t function_id;
+    if (pprof_get_function(writer, frame->filename, &function_id) < 0) {
+        return -1;
+    }
+
+    uint64_t id = ++writer->nlocation;
+    pb_buffer_t *line = &writer->packed;
+    line->len = 0;
+    if (pb_put_uint(line, PPROF_LINE_FUNCTION_ID, function_id) < 0
+        || pb_put_uint(line, PPROF_LINE_LINE, frame->lineno) < 0
+        || pb_put_uint(&writer->msg, PPROF_LOCATION_ID, id) < 0
+        || pb_put_bytes(&writer->msg, PPROF_LOCATION_LINE,
+                        line->data, line->len) < 0)
+    {
+        PyErr_NoMemory();
+        return -1;
+    }
+    if (pprof_put_message(writer, PPROF_PROFILE_LOCATION) < 0) {
+        return -1;
+    }
+
+    frame_t *key = malloc(sizeof(frame_t));
+    if (key == NULL) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    *key = *frame;
+    if (_Py_hashtable_set(writer->locations, key,
+                          (void *)(uintptr_t)id) < 0) {
+        free(key);
+        PyErr_NoMemory();
+        return -1;
+    }
+    *location_id = id;
+    return 0;
+}
+
+
+static int
+pprof_write_sample(_Py_hashtable_t *samples,
+                   const void *key, const void *value,
+                   void *user_data)
+{
+    pprof_writer_t *writer = (pprof_writer_t *)user_data;
+    const pprof_sample_t *sample = (const pprof_sample_t *)value;
+    const traceback_t *traceback = sample->traceback;
+
+    /* Locations and functions are written before the sample, so the sample
+       is encoded in writer->msg only once they are known */
+    uint64_t location_ids[16];
+    uint64_t *ids = location_ids;
+    if (traceback->nframe > (int)Py_ARRAY_LENGTH(location_ids)) {
+        ids = malloc(traceback->nframe * sizeof(uint64_t));
+        if (ids == NULL) {
+            PyErr_NoMemory();
+            return -1;
+        }
+    }
+
+    int res = -1;
+    /* pprof expects the leaf first, as traceback frames */
+    for (int i=0; i < traceback->nframe; i++) {
+        if (pprof_get_location(writer, &traceback->frames[i], &ids[i]) < 0) {
+            goto done;
+        }
+    }
+
+    pb_buffer_t *packed = &writer->packed;
+    packed->len = 0;
+    for (int i=0; i < traceback->nframe; i++) {
+        if (pb_put_varint(packed, ids[i]) < 0) {
+            goto no_memory;
+        }
+    }
+    if (pb_put_bytes(&writer->msg, PPROF_SAMPLE_LOCATION_ID,
+                     packed->data, packed->len) < 0) {
+        goto no_memory;
+    }
+
+    packed->len = 0;
+    if (pb_put_varint(packed, (uint64_t)llround(sample->count)) < 0
+        || pb_put_varint(packed, (uint64_t)llround(sample->size)) < 0
+        || pb_put_bytes(&writer->msg, PPROF_SAMPLE_VALUE,
+                        packed->data, packed->len) < 0)
+    {
+        goto no_memory;
+    }
+
+    if (sample->domain != DEFAULT_DOMAIN) {
+        packed->len = 0;
+        if (pb_put_uint(packed, PPROF_LABEL_KEY, PPROF_STR_DOMAIN) < 0
+            || pb_put_uint(packed, PPROF_LABEL_NUM, sample->domain) < 0
+            || pb_put_bytes(&writer->msg, PPROF_SAMPLE_LABEL,
+                            packed->data, packed->len) < 0)
+        {
+            goto no_memory;
+        }
+    }
+
+    res = pprof_put_message(writer, PPROF_PROFILE_SAMPLE);
+    goto done;
+
+no_memory:
+    PyErr_NoMemory();
+done:
+    if (ids != location_ids) {
+        free(ids);
+    }
+    return res;
+}
+
+
+static int
+pprof_aggregate_domain(_Py_hashtable_t *domains,
+                       const void *key, const void *value,
+                       void *user_data)
+{
+    pprof_aggregate_t *aggregate = (pprof_aggregate_t *)user_data;
+    _Py_hashtable_t *traces = (_Py_hashtable_t *)value;
+
+    aggregate->domain = (unsigned int)FROM_PTR(key);
+    return _Py_hashtable_foreach(traces, pprof_aggregate_trace, aggregate);
+}
+
+
+static int
+pprof_write(pprof_writer_t *writer, _Py_hashtable_t *samples,
+            size_t sample_rate)
+{
+    for (int i=0; i < PPROF_NSTR; i++) {
+        if (pprof_put_string(writer, pprof_strings[i],
+                             strlen(pprof_strings[i])) < 0) {
+            return -1;
+        }
+    }
+    if (pprof_put_value_type(writer, PPROF_PROFILE_SAMPLE_TYPE,
+                             PPROF_STR_OBJECTS, PPROF_STR_COUNT) < 0
+        || pprof_put_value_type(writer, PPROF_PROFILE_SAMPLE_TYPE,
+                                PPROF_STR_SPACE, PPROF_STR_BYTES) < 0)
+    {
+        return -1;
+    }
+
+    _PyTime_t now = _PyTime_AsNanoseconds(_PyTime_GetSystemClock());
+    if (pb_put_uint(&writer->out, PPROF_PROFILE_TIME_NANOS,
+                    (uint64_t)now) < 0) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    if (sample_rate != 0) {
+        if (pprof_put_value_type(writer, PPROF_PROFILE_PERIOD_TYPE,
+                                 PPROF_STR_SPACE, PPROF_STR_BYTES) < 0) {
+            return -1;
+        }
+        if (pb_put_uint(&writer->out, PPROF_PROFILE_PERIOD,
+                        sample_rate) < 0) {
+            PyErr_NoMemory();
+            return -1;
+        }
+    }
+
+    if (_Py_hashtable_foreach(samples, pprof_write_sample, writer)) {
+        return -1;
+    }
+    return pprof_flush(writer);
+}
+
+
+/*[clinic input]
+_tracemalloc._dump_pprof
+
+    write: object
+    /
+
+Write the traces of memory blocks allocated by Python in the pprof format.
+
+The uncompressed profile.proto message is passed by chunks to the
+write() callable. Traces are aggregated by traceback and scaled up if
+memory allocations are sampled.
+
+Write an empty profile if the tracemalloc module is disabled.
+[clinic start generated code]*/
+
+static PyObject *
+_tracemalloc__dump_pprof(PyObject *module, PyObject *write)
+/*[clinic end generated code: output=bbfc0d43929e7712 input=8a35900e87a60503]*/
+{
+    pprof_writer_t writer;
+    memset(&writer, 0, sizeof(writer));
+    writer.write = write;
+    pprof_aggregate_t aggregate;
+    aggregate.sample_rate = tracemalloc_sample_rate;
+    aggregate.domain = DEFAULT_DOMAIN;
+    PyObject *result = NULL;
+
+    aggregate.samples = hashtable_new(hashtable_hash_pprof_sample,
+                                      hashtable_compare_pprof_sample,
+                                      NULL, pprof_sample_free);
+    writer.functions = hashtable_new(_Py_hashtable_hash_ptr,
+                                     _Py_hashtable_compare_direct,
+                                     NULL, NULL);
+    writer.locations = hashtable_new(hashtable_hash_frame,
+                                     hashtable_compare_frame,
+                                     free, NULL);
+    if (aggregate.samples == NULL || writer.functions == NULL
+        || writer.locations == NULL) {
+        PyErr_NoMemory();
+        goto finally;
+    }
+
+    if (_Py_tracemalloc_config.tracing) {
+        /* The aggregation uses malloc(), not the Python allocators, and so
+           does not modify the traces */
+        TABLES_LOCK();
+        int err = _Py_hashtable_foreach(tracemalloc_traces,
+                                        pprof_aggregate_trace, &aggregate);
+        if (!err) {
+            err = _Py_hashtable_foreach(tracemalloc_domains,
+                                        pprof_aggregate_domain, &aggregate);
+        }
+        TABLES_UNLOCK();
+        if (err) {
+            PyErr_NoMemory();
+            goto finally;
+        }
+    }
+
+    if (pprof_write(&writer, aggregate.samples, aggregate.sample_rate) < 0) {
+        goto finally;
+    }
+    result = Py_NewRef(Py_None);
+
+finally:
+    if (writer.locations != NULL) {
+        _Py_hashtable_destroy(writer.locations);
+    }
+    if (writer.functions != NULL) {
+        _Py_hashtable_destroy(writer.functions);
+    }
+    if (aggregate.samples != NULL) {
+        _Py_hashtable_destroy(aggregate.samples);
+    }
+    free(writer.out.data);
+    free(writer.msg.data);
+    free(writer.packed.data);
+    return result;
+}
+
+
 #define PUTS(fd, str) _Py_write_noraise(fd, str, (int)strlen(str))
 
 static void
@@ -1522,18 +2256,24 @@ _tracemalloc.start
 
     nframe: int = 1
     /
+    *
+    sample_rate: Py_ssize_t = 0
 
 Start tracing Python memory allocations.
 
 Also set the maximum number of frames stored in the traceback of a
 trace to nframe.
+
+If sample_rate is greater than zero, only trace a random sample of
+memory allocations: on average, one memory block is traced every
+sample_rate allocated bytes.
 [clinic start generated code]*/
 
 static PyObject *
-_tracemalloc_start_impl(PyObject *module, int nframe)
-/*[clinic end generated code: output=caae05c23c159d3c input=40d849b5b29d1933]*/
+_tracemalloc_start_impl(PyObject *module, int nframe, Py_ssize_t sample_rate)
+/*[clinic end generated code: output=d6cc3ee157dce095 input=fd6e23feb999e94e]*/
 {
-    if (tracemalloc_start(nframe) < 0) {
+    if (tracemalloc_start(nframe, sample_rate) < 0) {
         return NULL;
     }
     Py_RETURN_NONE;
@@ -1574,6 +2314,22 @@ _tracemalloc_get_traceback_limit_impl(PyObject *module)
 }
 
 
+/*[clinic input]
+_tracemalloc.get_sample_rate -> Py_ssize_t
+
+Get the average number of bytes between two sampled memory allocations.
+
+Return 0 if all memory allocations are traced.
+[clinic start generated code]*/
+
+static Py_ssize_t
+_tracemalloc_get_sample_rate_impl(PyObject *module)
+/*[clinic end generated code: output=9a198f676280b690 input=e025d962e5dad51a]*/
+{
+    return (Py_ssize_t)tracemalloc_sample_rate;
+}
+
+
 static int
 tracemalloc_get_tracemalloc_memory_cb(_Py_hashtable_t *domains,
                                       const void *key, const void *value,
@@ -1669,9 +2425,11 @@ static PyMethodDef module_methods[] = {
     _TRACEMALLOC_CLEAR_TRACES_METHODDEF
     _TRACEMALLOC__GET_TRACES_METHODDEF
     _TRACEMALLOC__GET_OBJECT_TRACEBACK_METHODDEF
+    _TRACEMALLOC__DUMP_PPROF_METHODDEF
     _TRACEMALLOC_START_METHODDEF
     _TRACEMALLOC_STOP_METHODDEF
     _TRACEMALLOC_GET_TRACEBACK_LIMIT_METHODDEF
+    _TRACEMALLOC_GET_SAMPLE_RATE_METHODDEF
     _TRACEMALLOC_GET_TRACEMALLOC_MEMORY_METHODDEF
     _TRACEMALLOC_GET_TRACED_MEMORY_METHODDEF
     _TRACEMALLOC_RESET_PEAK_METHODDEF
@@ -1715,7 +2473,7 @@ _PyTraceMalloc_Init(int nframe)
     if (nframe == 0) {
         return 0;
     }
-    return tracemalloc_start(nframe);
+    return tracemalloc_start(nframe, 0);
 }
 
 
@@ -1741,7 +2499,14 @@ PyTraceMalloc_Track(unsigned int domain, uintptr_t ptr,
     gil_state = PyGILState_Ensure();
 
     TABLES_LOCK();
-    res = tracemalloc_add_trace(domain, ptr, size);
+    if (tracemalloc_sample(size)) {
+        res = tracemalloc_add_trace(domain, ptr, size);
+    }
+    else {
+        /* the memory block is not sampled */
+        tracemalloc_remove_trace(domain, ptr);
+        res = 0;
+    }
     TABLES_UNLOCK();
 
     PyGILState_Release(gil_state);
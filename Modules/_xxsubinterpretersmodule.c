@@ -12,6 +12,16 @@
 #include "pycore_interpreteridobject.h"
 
 
+/* The channels and the data passed between interpreters are not owned by
+   any interpreter, and may be freed by another interpreter than the one
+   which allocated them: use the raw allocator, which isn't tied to an
+   interpreter. */
+#define GLOBAL_MALLOC(TYPE) \
+    PyMem_RawMalloc(sizeof(TYPE))
+#define GLOBAL_FREE(VAR) \
+    PyMem_RawFree(VAR)
+
+
 static char *
 _copy_raw_string(PyObject *strobj)
 {
@@ -19,7 +29,7 @@ _copy_raw_string(PyObject *strobj)
     if (str == NULL) {
         return NULL;
     }
-    char *copied = PyMem_Malloc(strlen(str)+1);
+    char *copied = PyMem_RawMalloc(strlen(str)+1);
     if (copied == NULL) {
         PyErr_NoMemory();
         return NULL;
@@ -64,7 +74,7 @@ static void
 _sharednsitem_clear(struct _sharednsitem *item)
 {
     if (item->name != NULL) {
-        PyMem_Free(item->name);
+        GLOBAL_FREE(item->name);
         item->name = NULL;
     }
     _PyCrossInterpreterData_Release(&item->data);
@@ -96,16 +106,16 @@ typedef struct _sharedns {
 static _sharedns *
 _sharedns_new(Py_ssize_t len)
 {
-    _sharedns *shared = PyMem_NEW(_sharedns, 1);
+    _sharedns *shared = GLOBAL_MALLOC(_sharedns);
     if (shared == NULL) {
         PyErr_NoMemory();
         return NULL;
     }
     shared->len = len;
-    shared->items = PyMem_NEW(struct _sharednsitem, len);
+    shared->items = PyMem_RawCalloc(len, sizeof(struct _sharednsitem));
     if (shared->items == NULL) {
         PyErr_NoMemory();
-        PyMem_Free(shared);
+        GLOBAL_FREE(shared);
         return NULL;
     }
     return shared;
@@ -117,8 +127,8 @@ _sharedns_free(_sharedns *shared)
     for (Py_ssize_t i=0; i < shared->len; i++) {
         _sharednsitem_clear(&shared->items[i]);
     }
-    PyMem_Free(shared->items);
-    PyMem_Free(shared);
+    GLOBAL_FREE(shared->items);
+    GLOBAL_FREE(shared);
 }
 
 static _sharedns *
@@ -177,7 +187,7 @@ typedef struct _sharedexception {
 static _sharedexception *
 _sharedexception_new(void)
 {
-    _sharedexception *err = PyMem_NEW(_sharedexception, 1);
+    _sharedexception *err = GLOBAL_MALLOC(_sharedexception);
     if (err == NULL) {
         PyErr_NoMemory();
         return NULL;
@@ -191,10 +201,10 @@ static void
 _sharedexception_clear(_sharedexception *exc)
 {
     if (exc->name != NULL) {
-        PyMem_Free(exc->name);
+        GLOBAL_FREE(exc->name);
     }
     if (exc->msg != NULL) {
-        PyMem_Free(exc->msg);
+        GLOBAL_FREE(exc->msg);
     }
 }
 
@@ -202,7 +212,7 @@ static void
 _sharedexception_free(_sharedexception *exc)
 {
     _sharedexception_clear(exc);
-    PyMem_Free(exc);
+    GLOBAL_FREE(exc);
 }
 
 static _sharedexception *
@@ -254,7 +264,7 @@ _sharedexception_bind(PyObject *exctype, PyObject *exc, PyObject *tb)
     if (failure != NULL) {
         PyErr_Clear();
         if (err->name != NULL) {
-            PyMem_Free(err->name);
+            GLOBAL_FREE(err->name);
             err->name = NULL;
         }
         err->msg = failure;
@@ -364,7 +374,7 @@ typedef struct _channelitem {
 static _channelitem *
 _channelitem_new(void)
 {
-    _channelitem *item = PyMem_NEW(_channelitem, 1);
+    _channelitem *item = GLOBAL_MALLOC(_channelitem);
     if (item == NULL) {
         PyErr_NoMemory();
         return NULL;
@@ -379,7 +389,7 @@ _channelitem_clear(_channelitem *item)
 {
     if (item->data != NULL) {
         _PyCrossInterpreterData_Release(item->data);
-        PyMem_Free(item->data);
+        GLOBAL_FREE(item->data);
         item->data = NULL;
     }
     item->next = NULL;
@@ -389,7 +399,7 @@ static void
 _channelitem_free(_channelitem *item)
 {
     _channelitem_clear(item);
-    PyMem_Free(item);
+    GLOBAL_FREE(item);
 }
 
 static void
@@ -402,15 +412,6 @@ _channelitem_free_all(_channelitem *item)
     }
 }
 
-static _PyCrossInterpreterData *
-_channelitem_popped(_channelitem *item)
-{
-    _PyCrossInterpreterData *data = item->data;
-    item->data = NULL;
-    _channelitem_free(item);
-    return data;
-}
-
 typedef struct _channelqueue {
     int64_t count;
     _channelitem *first;
@@ -420,7 +421,7 @@ typedef struct _channelqueue {
 static _channelqueue *
 _channelqueue_new(void)
 {
-    _channelqueue *queue = PyMem_NEW(_channelqueue, 1);
+    _channelqueue *queue = GLOBAL_MALLOC(_channelqueue);
     if (queue == NULL) {
         PyErr_NoMemory();
         return NULL;
@@ -444,7 +445,7 @@ static void
 _channelqueue_free(_channelqueue *queue)
 {
     _channelqueue_clear(queue);
-    PyMem_Free(queue);
+    GLOBAL_FREE(queue);
 }
 
 static int
@@ -467,20 +468,29 @@ _channelqueue_put(_channelqueue *queue, _PyCrossInterpreterData *data)
     return 0;
 }
 
-static _PyCrossInterpreterData *
-_channelqueue_get(_channelqueue *queue)
-{
-    _channelitem *item = queue->first;
-    if (item == NULL) {
-        return NULL;
-    }
-    queue->first = item->next;
-    if (queue->last == item) {
-        queue->last = NULL;
+/* Detach up to "max" items from the front of the queue, as a chain. */
+static _channelitem *
+_channelqueue_get_many(_channelqueue *queue, Py_ssize_t max,
+                       Py_ssize_t *pcount)
+{
+    _channelitem *first = queue->first;
+    _channelitem *last = NULL;
+    Py_ssize_t count = 0;
+    for (_channelitem *item = first; item != NULL && count < max;
+         item = item->next) {
+        last = item;
+        count++;
+    }
+    if (last != NULL) {
+        queue->first = last->next;
+        if (queue->first == NULL) {
+            queue->last = NULL;
+        }
+        last->next = NULL;
+        queue->count -= count;
     }
-    queue->count -= 1;
-
-    return _channelitem_popped(item);
+    *pcount = count;
+    return last != NULL ? first : NULL;
 }
 
 /* channel-interpreter associations */
@@ -496,7 +506,7 @@ typedef struct _channelend {
 static _channelend *
 _channelend_new(int64_t interp)
 {
-    _channelend *end = PyMem_NEW(_channelend, 1);
+    _channelend *end = GLOBAL_MALLOC(_channelend);
     if (end == NULL) {
         PyErr_NoMemory();
         return NULL;
@@ -510,7 +520,7 @@ _channelend_new(int64_t interp)
 static void
 _channelend_free(_channelend *end)
 {
-    PyMem_Free(end);
+    GLOBAL_FREE(end);
 }
 
 static void
@@ -555,7 +565,7 @@ typedef struct _channelassociations {
 static _channelends *
 _channelends_new(void)
 {
-    _channelends *ends = PyMem_NEW(_channelends, 1);
+    _channelends *ends = GLOBAL_MALLOC(_channelends);
     if (ends== NULL) {
         return NULL;
     }
@@ -582,7 +592,7 @@ static void
 _channelends_free(_channelends *ends)
 {
     _channelends_clear(ends);
-    PyMem_Free(ends);
+    GLOBAL_FREE(ends);
 }
 
 static _channelend *
@@ -706,6 +716,199 @@ _channelends_close_all(_channelends *ends, int which, int force)
     }
 }
 
+/* channel notifications */
+
+/* Receivers that block wait on a condition built from PyThread locks,
+   like threading.Condition: each waiter holds its own lock and blocks
+   trying to acquire it again, until a sender releases it.  The notifier
+   is refcounted separately from the channel, so a waiter can safely
+   finish waiting after the channel has been destroyed.
+
+   The notifier also provides a pipe whose read end is readable while the
+   channel has pending items (or was closed), for use with selectors. */
+
+struct _channelnotifier;
+
+typedef struct _channelwaiter {
+    PyThread_type_lock lock;
+    struct _channelnotifier *notifier;  // set while registered
+    struct _channelwaiter *next;
+} _channelwaiter;
+
+typedef struct _channelnotifier {
+    PyThread_type_lock mutex;
+    Py_ssize_t refcount;
+    _channelwaiter *first;
+    _channelwaiter *last;
+    // The pipe is only created on request.
+    int fds[2];
+    int ready;
+} _channelnotifier;
+
+static _channelnotifier *
+_channelnotifier_new(void)
+{
+    _channelnotifier *notifier = GLOBAL_MALLOC(_channelnotifier);
+    if (notifier == NULL) {
+        PyErr_NoMemory();
+        return NULL;
+    }
+    notifier->mutex = PyThread_allocate_lock();
+    if (notifier->mutex == NULL) {
+        GLOBAL_FREE(notifier);
+        PyErr_SetString(ChannelError,
+                        "can't initialize mutex for channel notifier");
+        return NULL;
+    }
+    notifier->refcount = 1;
+    notifier->first = NULL;
+    notifier->last = NULL;
+    notifier->fds[0] = -1;
+    notifier->fds[1] = -1;
+    notifier->ready = 0;
+    return notifier;
+}
+
+static void
+_channelnotifier_decref(_channelnotifier *notifier)
+{
+    PyThread_acquire_lock(notifier->mutex, WAIT_LOCK);
+    Py_ssize_t refcount = --notifier->refcount;
+    PyThread_release_lock(notifier->mutex);
+    if (refcount > 0) {
+        return;
+    }
+    assert(notifier->first == NULL);
+    if (notifier->fds[0] >= 0) {
+        close(notifier->fds[0]);
+        close(notifier->fds[1]);
+    }
+    PyThread_free_lock(notifier->mutex);
+    GLOBAL_FREE(notifier);
+}
+
+static void
+_channelnotifier_add_waiter(_channelnotifier *notifier,
+                            _channelwaiter *waiter)
+{
+    PyThread_acquire_lock(notifier->mutex, WAIT_LOCK);
+    notifier->refcount += 1;
+    waiter->notifier = notifier;
+    waiter->next = NULL;
+    if (notifier->first == NULL) {
+        notifier->first = waiter;
+    }
+    else {
+        notifier->last->next = waiter;
+    }
+    notifier->last = waiter;
+    PyThread_release_lock(notifier->mutex);
+}
+
+/* Unregister the waiter and return 1 if it was still waiting, or return
+   0 if it was notified (and thus already unregistered). */
+static int
+_channelnotifier_remove_waiter(_channelnotifier *notifier,
+                               _channelwaiter *waiter)
+{
+    int found = 0;
+    PyThread_acquire_lock(notifier->mutex, WAIT_LOCK);
+    _channelwaiter *prev = NULL;
+    for (_channelwaiter *cur = notifier->first; cur != NULL; cur = cur->next) {
+        if (cur == waiter) {
+            if (prev == NULL) {
+                notifier->first = cur->next;
+            }
+            else {
+                prev->next = cur->next;
+            }
+            if (notifier->last == cur) {
+                notifier->last = prev;
+            }
+            found = 1;
+            break;
+        }
+        prev = cur;
+    }
+    PyThread_release_lock(notifier->mutex);
+    return found;
+}
+
+/* Wake up the oldest waiter, or all of them. */
+static void
+_channelnotifier_notify(_channelnotifier *notifier, int all)
+{
+    PyThread_acquire_lock(notifier->mutex, WAIT_LOCK);
+    while (notifier->first != NULL) {
+        _channelwaiter *waiter = notifier->first;
+        notifier->first = waiter->next;
+        if (notifier->first == NULL) {
+            notifier->last = NULL;
+        }
+        waiter->next = NULL;
+        PyThread_release_lock(waiter->lock);
+        if (!all) {
+            break;
+        }
+    }
+    PyThread_release_lock(notifier->mutex);
+}
+
+/* Make the pipe readable, or not.  The caller must hold the channel's
+   mutex. */
+static void
+_channelnotifier_set_ready(_channelnotifier *notifier, int ready)
+{
+    if (notifier->fds[0] < 0 || notifier->ready == ready) {
+        return;
+    }
+    char byte = 0;
+    Py_ssize_t n;
+    if (ready) {
+        n = write(notifier->fds[1], &byte, 1);
+    }
+    else {
+        n = read(notifier->fds[0], &byte, 1);
+    }
+    if (n == 1) {
+        notifier->ready = ready;
+    }
+}
+
+/* Return the read end of the pipe, creating it if necessary.  The caller
+   must hold the channel's mutex. */
+static int
+_channelnotifier_fileno(_channelnotifier *notifier, int ready)
+{
+    if (notifier->fds[0] >= 0) {
+        return notifier->fds[0];
+    }
+#ifdef MS_WINDOWS
+    PyErr_SetString(PyExc_NotImplementedError,
+                    "channel file descriptors are not supported on Windows");
+    return -1;
+#else
+    int fds[2];
+    if (pipe(fds) != 0) {
+        PyErr_SetFromErrno(PyExc_OSError);
+        return -1;
+    }
+    for (int i = 0; i < 2; i++) {
+        if (_Py_set_inheritable(fds[i], 0, NULL) < 0 ||
+                _Py_set_blocking(fds[i], 0) < 0) {
+            close(fds[0]);
+            close(fds[1]);
+            return -1;
+        }
+    }
+    notifier->fds[0] = fds[0];
+    notifier->fds[1] = fds[1];
+    notifier->ready = 0;
+    _channelnotifier_set_ready(notifier, ready);
+    return notifier->fds[0];
+#endif
+}
+
 /* channels */
 
 struct _channel;
@@ -717,6 +920,7 @@ typedef struct _channel {
     PyThread_type_lock mutex;
     _channelqueue *queue;
     _channelends *ends;
+    _channelnotifier *notifier;
     int open;
     struct _channel_closing *closing;
 } _PyChannelState;
@@ -724,26 +928,33 @@ typedef struct _channel {
 static _PyChannelState *
 _channel_new(void)
 {
-    _PyChannelState *chan = PyMem_NEW(_PyChannelState, 1);
+    _PyChannelState *chan = GLOBAL_MALLOC(_PyChannelState);
     if (chan == NULL) {
         return NULL;
     }
     chan->mutex = PyThread_allocate_lock();
     if (chan->mutex == NULL) {
-        PyMem_Free(chan);
+        GLOBAL_FREE(chan);
         PyErr_SetString(ChannelError,
                         "can't initialize mutex for new channel");
         return NULL;
     }
     chan->queue = _channelqueue_new();
     if (chan->queue == NULL) {
-        PyMem_Free(chan);
+        GLOBAL_FREE(chan);
         return NULL;
     }
     chan->ends = _channelends_new();
     if (chan->ends == NULL) {
         _channelqueue_free(chan->queue);
-        PyMem_Free(chan);
+        GLOBAL_FREE(chan);
+        return NULL;
+    }
+    chan->notifier = _channelnotifier_new();
+    if (chan->notifier == NULL) {
+        _channelends_free(chan->ends);
+        _channelqueue_free(chan->queue);
+        GLOBAL_FREE(chan);
         return NULL;
     }
     chan->open = 1;
@@ -758,10 +969,14 @@ _channel_free(_PyChannelState *chan)
     PyThread_acquire_lock(chan->mutex, WAIT_LOCK);
     _channelqueue_free(chan->queue);
     _channelends_free(chan->ends);
+    // Blocked receivers will find the channel gone.
+    _channelnotifier_set_ready(chan->notifier, 1);
+    _channelnotifier_notify(chan->notifier, 1);
+    _channelnotifier_decref(chan->notifier);
     PyThread_release_lock(chan->mutex);
 
     PyThread_free_lock(chan->mutex);
-    PyMem_Free(chan);
+    GLOBAL_FREE(chan);
 }
 
 static int
@@ -782,6 +997,8 @@ _channel_add(_PyChannelState *chan, int64_t interp,
     if (_channelqueue_put(chan->queue, data) != 0) {
         goto done;
     }
+    _channelnotifier_set_ready(chan->notifier, 1);
+    _channelnotifier_notify(chan->notifier, 0);
 
     res = 0;
 done:
@@ -789,10 +1006,14 @@ _channel_add(_PyChannelState *chan, int64_t interp,
     return res;
 }
 
-static _PyCrossInterpreterData *
-_channel_next(_PyChannelState *chan, int64_t interp)
+/* Pop up to "max" items off the channel's queue.  If there are none
+   and a waiter is given then it is registered with the channel's
+   notifier, so the caller can block until the next item is added. */
+static Py_ssize_t
+_channel_next(_PyChannelState *chan, int64_t interp,
+              _channelitem **pitems, Py_ssize_t max, _channelwaiter *waiter)
 {
-    _PyCrossInterpreterData *data = NULL;
+    Py_ssize_t count = -1;
     PyThread_acquire_lock(chan->mutex, WAIT_LOCK);
 
     if (!chan->open) {
@@ -803,17 +1024,21 @@ _channel_next(_PyChannelState *chan, int64_t interp)
         goto done;
     }
 
-    data = _channelqueue_get(chan->queue);
-    if (data == NULL && !PyErr_Occurred() && chan->closing != NULL) {
+    *pitems = _channelqueue_get_many(chan->queue, max, &count);
+    if (count == 0 && chan->closing != NULL) {
         chan->open = 0;
     }
+    else if (count == 0 && waiter != NULL) {
+        _channelnotifier_add_waiter(chan->notifier, waiter);
+    }
+    _channelnotifier_set_ready(chan->notifier, chan->queue->count > 0);
 
 done:
     PyThread_release_lock(chan->mutex);
     if (chan->queue->count == 0) {
         _channel_finish_closing(chan);
     }
-    return data;
+    return count;
 }
 
 static int
@@ -831,6 +1056,10 @@ _channel_close_interpreter(_PyChannelState *chan, int64_t interp, int end)
         goto done;
     }
     chan->open = _channelends_is_open(chan->ends);
+    if (!chan->open) {
+        _channelnotifier_set_ready(chan->notifier, 1);
+        _channelnotifier_notify(chan->notifier, 1);
+    }
 
     res = 0;
 done:
@@ -856,6 +1085,8 @@ _channel_close_all(_PyChannelState *chan, int end, int force)
     }
 
     chan->open = 0;
+    _channelnotifier_set_ready(chan->notifier, 1);
+    _channelnotifier_notify(chan->notifier, 1);
 
     // We *could* also just leave these in place, since we've marked
     // the channel as closed already.
@@ -881,7 +1112,7 @@ typedef struct _channelref {
 static _channelref *
 _channelref_new(int64_t id, _PyChannelState *chan)
 {
-    _channelref *ref = PyMem_NEW(_channelref, 1);
+    _channelref *ref = GLOBAL_MALLOC(_channelref);
     if (ref == NULL) {
         return NULL;
     }
@@ -908,7 +1139,7 @@ _channelref_free(_channelref *ref)
         _channel_clear_closing(ref->chan);
     }
     //_channelref_clear(ref);
-    PyMem_Free(ref);
+    GLOBAL_FREE(ref);
 }
 
 static _channelref *
@@ -1219,7 +1450,7 @@ _channel_set_closing(struct _channelref *ref, PyThread_type_lock mutex) {
         PyErr_SetString(ChannelClosedError, "channel closed");
         goto done;
     }
-    chan->closing = PyMem_NEW(struct _channel_closing, 1);
+    chan->closing = GLOBAL_MALLOC(struct _channel_closing);
     if (chan->closing == NULL) {
         goto done;
     }
@@ -1235,7 +1466,7 @@ static void
 _channel_clear_closing(struct _channel *chan) {
     PyThread_acquire_lock(chan->mutex, WAIT_LOCK);
     if (chan->closing != NULL) {
-        PyMem_Free(chan->closing);
+        GLOBAL_FREE(chan->closing);
         chan->closing = NULL;
     }
     PyThread_release_lock(chan->mutex);
@@ -1307,14 +1538,14 @@ _channel_send(_channels *channels, int64_t id, PyObject *obj)
     }
 
     // Convert the object to cross-interpreter data.
-    _PyCrossInterpreterData *data = PyMem_NEW(_PyCrossInterpreterData, 1);
+    _PyCrossInterpreterData *data = GLOBAL_MALLOC(_PyCrossInterpreterData);
     if (data == NULL) {
         PyThread_release_lock(mutex);
         return -1;
     }
     if (_PyObject_GetCrossInterpreterData(obj, data) != 0) {
         PyThread_release_lock(mutex);
-        PyMem_Free(data);
+        GLOBAL_FREE(data);
         return -1;
     }
 
@@ -1323,40 +1554,155 @@ _channel_send(_channels *channels, int64_t id, PyObject *obj)
     PyThread_release_lock(mutex);
     if (res != 0) {
         _PyCrossInterpreterData_Release(data);
-        PyMem_Free(data);
+        GLOBAL_FREE(data);
         return -1;
     }
 
     return 0;
 }
 
-static PyObject *
-_channel_recv(_channels *channels, int64_t id)
+/* Pop up to "max" items off the channel and return how many there
+   were.  See _channel_next() about the waiter. */
+static Py_ssize_t
+_channel_pop(_channels *channels, int64_t id,
+             _channelitem **pitems, Py_ssize_t max, _channelwaiter *waiter)
 {
     PyInterpreterState *interp = _get_current();
     if (interp == NULL) {
-        return NULL;
+        return -1;
     }
 
     // Look up the channel.
     PyThread_type_lock mutex = NULL;
     _PyChannelState *chan = _channels_lookup(channels, id, &mutex);
     if (chan == NULL) {
-        return NULL;
+        return -1;
     }
     // Past this point we are responsible for releasing the mutex.
 
-    // Pop off the next item from the channel.
-    _PyCrossInterpreterData *data = _channel_next(chan, PyInterpreterState_GetID(interp));
+    // Pop off the next items from the channel.
+    Py_ssize_t count = _channel_next(chan, PyInterpreterState_GetID(interp),
+                                     pitems, max, waiter);
     PyThread_release_lock(mutex);
-    if (data == NULL) {
+    return count;
+}
+
+/* Convert the "block" and "timeout" arguments of the receiving functions
+   to a timeout, which is negative to wait forever. */
+static int
+_channel_timeout(int block, PyObject *timeout_obj, _PyTime_t *timeout)
+{
+    if (!block) {
+        *timeout = 0;
+    }
+    else if (timeout_obj != Py_None) {
+        if (_PyTime_FromSecondsObject(timeout,
+                                      timeout_obj, _PyTime_ROUND_CEILING) < 0) {
+            return -1;
+        }
+        if (*timeout < 0) {
+            PyErr_SetString(PyExc_ValueError,
+                            "'timeout' must be a non-negative number");
+            return -1;
+        }
+        if (_PyTime_AsMicroseconds(*timeout,
+                                   _PyTime_ROUND_CEILING) > PY_TIMEOUT_MAX) {
+            PyErr_SetString(PyExc_OverflowError,
+                            "timeout value is too large");
+            return -1;
+        }
+    }
+    else {
+        *timeout = -1;
+    }
+    return 0;
+}
+
+/* Like _channel_pop(), but if the channel is empty then wait for an item
+   to be sent, for at most "timeout" (or forever if negative). */
+static Py_ssize_t
+_channel_pop_wait(_channels *channels, int64_t id,
+                  _channelitem **pitems, Py_ssize_t max, _PyTime_t timeout)
+{
+    if (timeout == 0) {
+        return _channel_pop(channels, id, pitems, max, NULL);
+    }
+
+    _channelwaiter waiter = {0};
+    waiter.lock = PyThread_allocate_lock();
+    if (waiter.lock == NULL) {
+        PyErr_SetString(ChannelError, "can't allocate lock for waiting");
+        return -1;
+    }
+    // The lock is held while waiting, and released when notified.
+    PyThread_acquire_lock(waiter.lock, WAIT_LOCK);
+
+    _PyTime_t endtime = 0;
+    PY_TIMEOUT_T microseconds = -1;
+    if (timeout > 0) {
+        endtime = _PyDeadline_Init(timeout);
+        microseconds = _PyTime_AsMicroseconds(timeout, _PyTime_ROUND_CEILING);
+    }
+    Py_ssize_t count;
+    while (1) {
+        count = _channel_pop(channels, id, pitems, max, &waiter);
+        if (count != 0 || waiter.notifier == NULL) {
+            break;
+        }
+
+        PyLockStatus r;
+        Py_BEGIN_ALLOW_THREADS
+        r = PyThread_acquire_lock_timed(waiter.lock, microseconds, 1);
+        Py_END_ALLOW_THREADS
+
+        _channelnotifier *notifier = waiter.notifier;
+        waiter.notifier = NULL;
+        int notified = !_channelnotifier_remove_waiter(notifier, &waiter);
+        if (notified && r != PY_LOCK_ACQUIRED) {
+            // The notifier released the lock after we gave up on it.
+            PyThread_acquire_lock(waiter.lock, WAIT_LOCK);
+        }
+
+        if (r == PY_LOCK_INTR && Py_MakePendingCalls() < 0) {
+            if (notified) {
+                // Pass the notification on to another waiter.
+                _channelnotifier_notify(notifier, 0);
+            }
+            _channelnotifier_decref(notifier);
+            count = -1;
+            break;
+        }
+        _channelnotifier_decref(notifier);
+
+        // Adjust the timeout for the next iteration.
+        if (microseconds > 0) {
+            microseconds = _PyTime_AsMicroseconds(_PyDeadline_Get(endtime),
+                                                  _PyTime_ROUND_CEILING);
+            if (microseconds <= 0) {
+                // Time is up, so try one last time without waiting.
+                count = _channel_pop(channels, id, pitems, max, NULL);
+                break;
+            }
+        }
+    }
+
+    PyThread_release_lock(waiter.lock);
+    PyThread_free_lock(waiter.lock);
+    return count;
+}
+
+static PyObject *
+_channel_recv(_channels *channels, int64_t id, _PyTime_t timeout)
+{
+    _channelitem *item;
+    Py_ssize_t count = _channel_pop_wait(channels, id, &item, 1, timeout);
+    if (count <= 0) {
         return NULL;
     }
 
     // Convert the data back to an object.
-    PyObject *obj = _PyCrossInterpreterData_NewObject(data);
-    _PyCrossInterpreterData_Release(data);
-    PyMem_Free(data);
+    PyObject *obj = _PyCrossInterpreterData_NewObject(item->data);
+    _channelitem_free(item);
     if (obj == NULL) {
         return NULL;
     }
@@ -1364,6 +1710,52 @@ _channel_recv(_channels *channels, int64_t id)
     return obj;
 }
 
+static PyObject *
+_channel_recv_many(_channels *channels, int64_t id, Py_ssize_t max,
+                   _PyTime_t timeout)
+{
+    _channelitem *items;
+    Py_ssize_t count = _channel_pop_wait(channels, id, &items, max, timeout);
+    if (count < 0) {
+        return NULL;
+    }
+
+    // Convert the data back to objects.
+    PyObject *objs = PyList_New(count);
+    for (Py_ssize_t i = 0; i < count; i++) {
+        _channelitem *item = items;
+        items = item->next;
+        if (objs != NULL) {
+            PyObject *obj = _PyCrossInterpreterData_NewObject(item->data);
+            if (obj == NULL) {
+                Py_CLEAR(objs);
+            }
+            else {
+                PyList_SET_ITEM(objs, i, obj);
+            }
+        }
+        _channelitem_free(item);
+    }
+    return objs;
+}
+
+static int
+_channel_fileno(_channels *channels, int64_t id)
+{
+    PyThread_type_lock mutex = NULL;
+    _PyChannelState *chan = _channels_lookup(channels, id, &mutex);
+    if (chan == NULL) {
+        return -1;
+    }
+    // Past this point we are responsible for releasing the mutex.
+
+    PyThread_acquire_lock(chan->mutex, WAIT_LOCK);
+    int fd = _channelnotifier_fileno(chan->notifier, chan->queue->count > 0);
+    PyThread_release_lock(chan->mutex);
+    PyThread_release_lock(mutex);
+    return fd;
+}
+
 static int
 _channel_drop(_channels *channels, int64_t id, int send, int recv)
 {
@@ -1714,7 +2106,7 @@ _channelid_from_xid(_PyCrossInterpreterData *data)
 static int
 _channelid_shared(PyObject *obj, _PyCrossInterpreterData *data)
 {
-    struct _channelid_xid *xid = PyMem_NEW(struct _channelid_xid, 1);
+    struct _channelid_xid *xid = GLOBAL_MALLOC(struct _channelid_xid);
     if (xid == NULL) {
         return -1;
     }
@@ -1726,7 +2118,7 @@ _channelid_shared(PyObject *obj, _PyCrossInterpreterData *data)
     Py_INCREF(obj);
     data->obj = obj;
     data->new_object = _channelid_from_xid;
-    data->free = PyMem_Free;
+    data->free = PyMem_RawFree;
     return 0;
 }
 
@@ -2441,16 +2833,23 @@ Add the object's data to the channel's queue.");
 static PyObject *
 channel_recv(PyObject *self, PyObject *args, PyObject *kwds)
 {
-    static char *kwlist[] = {"cid", "default", NULL};
+    static char *kwlist[] = {"cid", "default", "block", "timeout", NULL};
     int64_t cid;
     PyObject *dflt = NULL;
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O&|O:channel_recv", kwlist,
-                                     channel_id_converter, &cid, &dflt)) {
+    int block = 0;
+    PyObject *timeout_obj = Py_None;
+    _PyTime_t timeout;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O&|O$pO:channel_recv", kwlist,
+                                     channel_id_converter, &cid, &dflt,
+                                     &block, &timeout_obj)) {
+        return NULL;
+    }
+    if (_channel_timeout(block, timeout_obj, &timeout) < 0) {
         return NULL;
     }
     Py_XINCREF(dflt);
 
-    PyObject *obj = _channel_recv(&_globals.channels, cid);
+    PyObject *obj = _channel_recv(&_globals.channels, cid, timeout);
     if (obj != NULL) {
         Py_XDECREF(dflt);
         return obj;
@@ -2466,12 +2865,75 @@ channel_recv(PyObject *self, PyObject *args, PyObject *kwds)
 }
 
 PyDoc_STRVAR(channel_recv_doc,
-"channel_recv(cid, [default]) -> obj\n\
+"channel_recv(cid, [default], *, block=False, timeout=None) -> obj\n\
 \n\
 Return a new object from the data at the front of the channel's queue.\n\
 \n\
-If there is nothing to receive then raise ChannelEmptyError, unless\n\
-a default value is provided.  In that case return it.");
+If block is true, wait (without holding the GIL) until there is\n\
+something to receive, for at most timeout seconds if it is not None.\n\
+If there is still nothing to receive then raise ChannelEmptyError,\n\
+unless a default value is provided.  In that case return it.");
+
+static PyObject *
+channel_recv_many(PyObject *self, PyObject *args, PyObject *kwds)
+{
+    static char *kwlist[] = {"cid", "max_items", "block", "timeout", NULL};
+    int64_t cid;
+    Py_ssize_t max_items;
+    int block = 0;
+    PyObject *timeout_obj = Py_None;
+    _PyTime_t timeout;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O&n|$pO:channel_recv_many",
+                                     kwlist, channel_id_converter, &cid,
+                                     &max_items, &block, &timeout_obj)) {
+        return NULL;
+    }
+    if (max_items <= 0) {
+        PyErr_SetString(PyExc_ValueError, "'max_items' must be positive");
+        return NULL;
+    }
+    if (_channel_timeout(block, timeout_obj, &timeout) < 0) {
+        return NULL;
+    }
+
+    return _channel_recv_many(&_globals.channels, cid, max_items, timeout);
+}
+
+PyDoc_STRVAR(channel_recv_many_doc,
+"channel_recv_many(cid, max_items, *, block=False, timeout=None) -> list\n\
+\n\
+Return a list of new objects from the data at the front of the channel's\n\
+queue, with at most max_items items.\n\
+\n\
+If block is true, wait (without holding the GIL) until there is\n\
+something to receive, for at most timeout seconds if it is not None.\n\
+If there is still nothing to receive then return an empty list.");
+
+static PyObject *
+channel_fileno(PyObject *self, PyObject *args, PyObject *kwds)
+{
+    static char *kwlist[] = {"cid", NULL};
+    int64_t cid;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O&:channel_fileno", kwlist,
+                                     channel_id_converter, &cid)) {
+        return NULL;
+    }
+
+    int fd = _channel_fileno(&_globals.channels, cid);
+    if (fd < 0) {
+        return NULL;
+    }
+    return PyLong_FromLong(fd);
+}
+
+PyDoc_STRVAR(channel_fileno_doc,
+"channel_fileno(cid) -> int\n\
+\n\
+Return a file descriptor that is ready for reading while the channel\n\
+has something to receive or is closed, for use with selectors.\n\
+\n\
+The descriptor belongs to the channel: do not read from or close it.\n\
+It is closed along with the channel.");
 
 static PyObject *
 channel_close(PyObject *self, PyObject *args, PyObject *kwds)
@@ -2592,6 +3054,10 @@ static PyMethodDef module_functions[] = {
      METH_VARARGS | METH_KEYWORDS, channel_send_doc},
     {"channel_recv",              (PyCFunction)(void(*)(void))channel_recv,
      METH_VARARGS | METH_KEYWORDS, channel_recv_doc},
+    {"channel_recv_many",         (PyCFunction)(void(*)(void))channel_recv_many,
+     METH_VARARGS | METH_KEYWORDS, channel_recv_many_doc},
+    {"channel_fileno",            (PyCFunction)(void(*)(void))channel_fileno,
+     METH_VARARGS | METH_KEYWORDS, channel_fileno_doc},
     {"channel_close",             (PyCFunction)(void(*)(void))channel_close,
      METH_VARARGS | METH_KEYWORDS, channel_close_doc},
     {"channel_release",           (PyCFunction)(void(*)(void))channel_release,
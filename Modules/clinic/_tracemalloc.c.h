@@ -74,39 +74,81 @@ PyDoc_STRVAR(_tracemalloc__get_object_traceback__doc__,
 #define _TRACEMALLOC__GET_OBJECT_TRACEBACK_METHODDEF    \
     {"_get_object_traceback", (PyCFunction)_tracemalloc__get_object_traceback, METH_O, _tracemalloc__get_object_traceback__doc__},
 
+PyDoc_STRVAR(_tracemalloc__dump_pprof__doc__,
+"_dump_pprof($module, write, /)\n"
+"--\n"
+"\n"
+"Write the traces of memory blocks allocated by Python in the pprof format.\n"
+"\n"
+"The uncompressed profile.proto message is passed by chunks to the\n"
+"write() callable. Traces are aggregated by traceback and scaled up if\n"
+"memory allocations are sampled.\n"
+"\n"
+"Write an empty profile if the tracemalloc module is disabled.");
+
+#define _TRACEMALLOC__DUMP_PPROF_METHODDEF    \
+    {"_dump_pprof", (PyCFunction)_tracemalloc__dump_pprof, METH_O, _tracemalloc__dump_pprof__doc__},
+
 PyDoc_STRVAR(_tracemalloc_start__doc__,
-"start($module, nframe=1, /)\n"
+"start($module, nframe=1, /, *, sample_rate=0)\n"
 "--\n"
 "\n"
 "Start tracing Python memory allocations.\n"
 "\n"
 "Also set the maximum number of frames stored in the traceback of a\n"
-"trace to nframe.");
+"trace to nframe.\n"
+"\n"
+"If sample_rate is greater than zero, only trace a random sample of\n"
+"memory allocations: on average, one memory block is traced every\n"
+"sample_rate allocated bytes.");
 
 #define _TRACEMALLOC_START_METHODDEF    \
-    {"start", (PyCFunction)(void(*)(void))_tracemalloc_start, METH_FASTCALL, _tracemalloc_start__doc__},
+    {"start", (PyCFunction)(void(*)(void))_tracemalloc_start, METH_FASTCALL|METH_KEYWORDS, _tracemalloc_start__doc__},
 
 static PyObject *
-_tracemalloc_start_impl(PyObject *module, int nframe);
+_tracemalloc_start_impl(PyObject *module, int nframe, Py_ssize_t sample_rate);
 
 static PyObject *
-_tracemalloc_start(PyObject *module, PyObject *const *args, Py_ssize_t nargs)
+_tracemalloc_start(PyObject *module, PyObject *const *args, Py_ssize_t nargs, PyObject *kwnames)
 {
     PyObject *return_value = NULL;
+    static const char * const _keywords[] = {"", "sample_rate", NULL};
+    static _PyArg_Parser _parser = {NULL, _keywords, "start", 0};
+    PyObject *argsbuf[2];
+    Py_ssize_t noptargs = nargs + (kwnames ? PyTuple_GET_SIZE(kwnames) : 0) - 0;
     int nframe = 1;
+    Py_ssize_t sample_rate = 0;
 
-    if (!_PyArg_CheckPositional("start", nargs, 0, 1)) {
+    args = _PyArg_UnpackKeywords(args, nargs, NULL, kwnames, &_parser, 0, 1, 0, argsbuf);
+    if (!args) {
         goto exit;
     }
     if (nargs < 1) {
-        goto skip_optional;
+        goto skip_optional_posonly;
     }
+    noptargs--;
     nframe = _PyLong_AsInt(args[0]);
     if (nframe == -1 && PyErr_Occurred()) {
         goto exit;
     }
-skip_optional:
-    return_value = _tracemalloc_start_impl(module, nframe);
+skip_optional_posonly:
+    if (!noptargs) {
+        goto skip_optional_kwonly;
+    }
+    {
+        Py_ssize_t ival = -1;
+        PyObject *iobj = _PyNumber_Index(args[1]);
+        if (iobj != NULL) {
+            ival = PyLong_AsSsize_t(iobj);
+            Py_DECREF(iobj);
+        }
+        if (ival == -1 && PyErr_Occurred()) {
+            goto exit;
+        }
+        sample_rate = ival;
+    }
+skip_optional_kwonly:
+    return_value = _tracemalloc_start_impl(module, nframe, sample_rate);
 
 exit:
     return return_value;
@@ -153,6 +195,36 @@ _tracemalloc_get_traceback_limit(PyObject *module, PyObject *Py_UNUSED(ignored))
     return _tracemalloc_get_traceback_limit_impl(module);
 }
 
+PyDoc_STRVAR(_tracemalloc_get_sample_rate__doc__,
+"get_sample_rate($module, /)\n"
+"--\n"
+"\n"
+"Get the average number of bytes between two sampled memory allocations.\n"
+"\n"
+"Return 0 if all memory allocations are traced.");
+
+#define _TRACEMALLOC_GET_SAMPLE_RATE_METHODDEF    \
+    {"get_sample_rate", (PyCFunction)_tracemalloc_get_sample_rate, METH_NOARGS, _tracemalloc_get_sample_rate__doc__},
+
+static Py_ssize_t
+_tracemalloc_get_sample_rate_impl(PyObject *module);
+
+static PyObject *
+_tracemalloc_get_sample_rate(PyObject *module, PyObject *Py_UNUSED(ignored))
+{
+    PyObject *return_value = NULL;
+    Py_ssize_t _return_value;
+
+    _return_value = _tracemalloc_get_sample_rate_impl(module);
+    if ((_return_value == -1) && PyErr_Occurred()) {
+        goto exit;
+    }
+    return_value = PyLong_FromSsize_t(_return_value);
+
+exit:
+    return return_value;
+}
+
 PyDoc_STRVAR(_tracemalloc_get_tracemalloc_memory__doc__,
 "get_tracemalloc_memory($module, /)\n"
 "--\n"
@@ -212,4 +284,4 @@ _tracemalloc_reset_peak(PyObject *module, PyObject *Py_UNUSED(ignored))
 {
     return _tracemalloc_reset_peak_impl(module);
 }
-/*[clinic end generated code: output=bafca0a19b0b0823 input=a9049054013a1b77]*/
+/*[clinic end generated code: output=97f6fbd1d76181c4 input=a9049054013a1b77]*/
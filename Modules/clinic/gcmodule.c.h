@@ -202,6 +202,92 @@ gc_get_threshold(PyObject *module, PyObject *Py_UNUSED(ignored))
     return gc_get_threshold_impl(module);
 }
 
+PyDoc_STRVAR(gc_set_pause_target__doc__,
+"set_pause_target($module, ms, /)\n"
+"--\n"
+"\n"
+"Set the pause target of automatic collections, in milliseconds.\n"
+"\n"
+"Automatic collections of the oldest generation then run in slices sized\n"
+"to take about that long.  Zero disables incremental collection.");
+
+#define GC_SET_PAUSE_TARGET_METHODDEF    \
+    {"set_pause_target", (PyCFunction)gc_set_pause_target, METH_O, gc_set_pause_target__doc__},
+
+PyDoc_STRVAR(gc_get_pause_target__doc__,
+"get_pause_target($module, /)\n"
+"--\n"
+"\n"
+"Return the pause target of automatic collections, in milliseconds.");
+
+#define GC_GET_PAUSE_TARGET_METHODDEF    \
+    {"get_pause_target", (PyCFunction)gc_get_pause_target, METH_NOARGS, gc_get_pause_target__doc__},
+
+static PyObject *
+gc_get_pause_target_impl(PyObject *module);
+
+static PyObject *
+gc_get_pause_target(PyObject *module, PyObject *Py_UNUSED(ignored))
+{
+    return gc_get_pause_target_impl(module);
+}
+
+PyDoc_STRVAR(gc_set_trim_memory__doc__,
+"set_trim_memory($module, enabled, /)\n"
+"--\n"
+"\n"
+"Set whether full collections give the free memory back to the system.");
+
+#define GC_SET_TRIM_MEMORY_METHODDEF    \
+    {"set_trim_memory", (PyCFunction)gc_set_trim_memory, METH_O, gc_set_trim_memory__doc__},
+
+static PyObject *
+gc_set_trim_memory_impl(PyObject *module, int enabled);
+
+static PyObject *
+gc_set_trim_memory(PyObject *module, PyObject *arg)
+{
+    PyObject *return_value = NULL;
+    int enabled;
+
+    enabled = _PyLong_AsInt(arg);
+    if (enabled == -1 && PyErr_Occurred()) {
+        goto exit;
+    }
+    return_value = gc_set_trim_memory_impl(module, enabled);
+
+exit:
+    return return_value;
+}
+
+PyDoc_STRVAR(gc_get_trim_memory__doc__,
+"get_trim_memory($module, /)\n"
+"--\n"
+"\n"
+"Return whether full collections give the free memory back to the system.");
+
+#define GC_GET_TRIM_MEMORY_METHODDEF    \
+    {"get_trim_memory", (PyCFunction)gc_get_trim_memory, METH_NOARGS, gc_get_trim_memory__doc__},
+
+static int
+gc_get_trim_memory_impl(PyObject *module);
+
+static PyObject *
+gc_get_trim_memory(PyObject *module, PyObject *Py_UNUSED(ignored))
+{
+    PyObject *return_value = NULL;
+    int _return_value;
+
+    _return_value = gc_get_trim_memory_impl(module);
+    if ((_return_value == -1) && PyErr_Occurred()) {
+        goto exit;
+    }
+    return_value = PyBool_FromLong((long)_return_value);
+
+exit:
+    return return_value;
+}
+
 PyDoc_STRVAR(gc_get_count__doc__,
 "get_count($module, /)\n"
 "--\n"
@@ -266,21 +352,47 @@ gc_get_objects(PyObject *module, PyObject *const *args, Py_ssize_t nargs, PyObje
 }
 
 PyDoc_STRVAR(gc_get_stats__doc__,
-"get_stats($module, /)\n"
+"get_stats($module, /, *, detailed=False)\n"
 "--\n"
 "\n"
-"Return a list of dictionaries containing per-generation statistics.");
+"Return a list of dictionaries containing per-generation statistics.\n"
+"\n"
+"With detailed=True, the dictionaries also hold the number of objects\n"
+"the collections examined, the time they spent in each phase, and the\n"
+"number of objects of each type now in the generation.");
 
 #define GC_GET_STATS_METHODDEF    \
-    {"get_stats", (PyCFunction)gc_get_stats, METH_NOARGS, gc_get_stats__doc__},
+    {"get_stats", (PyCFunction)(void(*)(void))gc_get_stats, METH_FASTCALL|METH_KEYWORDS, gc_get_stats__doc__},
 
 static PyObject *
-gc_get_stats_impl(PyObject *module);
+gc_get_stats_impl(PyObject *module, int detailed);
 
 static PyObject *
-gc_get_stats(PyObject *module, PyObject *Py_UNUSED(ignored))
+gc_get_stats(PyObject *module, PyObject *const *args, Py_ssize_t nargs, PyObject *kwnames)
 {
-    return gc_get_stats_impl(module);
+    PyObject *return_value = NULL;
+    static const char * const _keywords[] = {"detailed", NULL};
+    static _PyArg_Parser _parser = {NULL, _keywords, "get_stats", 0};
+    PyObject *argsbuf[1];
+    Py_ssize_t noptargs = nargs + (kwnames ? PyTuple_GET_SIZE(kwnames) : 0) - 0;
+    int detailed = 0;
+
+    args = _PyArg_UnpackKeywords(args, nargs, NULL, kwnames, &_parser, 0, 0, 0, argsbuf);
+    if (!args) {
+        goto exit;
+    }
+    if (!noptargs) {
+        goto skip_optional_kwonly;
+    }
+    detailed = _PyLong_AsInt(args[0]);
+    if (detailed == -1 && PyErr_Occurred()) {
+        goto exit;
+    }
+skip_optional_kwonly:
+    return_value = gc_get_stats_impl(module, detailed);
+
+exit:
+    return return_value;
 }
 
 PyDoc_STRVAR(gc_is_tracked__doc__,
@@ -304,25 +416,65 @@ PyDoc_STRVAR(gc_is_finalized__doc__,
     {"is_finalized", (PyCFunction)gc_is_finalized, METH_O, gc_is_finalized__doc__},
 
 PyDoc_STRVAR(gc_freeze__doc__,
-"freeze($module, /)\n"
+"freeze($module, /, *, detach=False, immortal=False)\n"
 "--\n"
 "\n"
 "Freeze all current tracked objects and ignore them for future collections.\n"
 "\n"
 "This can be used before a POSIX fork() call to make the gc copy-on-write friendly.\n"
 "Note: collection before a POSIX fork() call may free pages for future allocation\n"
-"which can cause copy-on-write.");
+"which can cause copy-on-write.\n"
+"\n"
+"If detach is true, the frozen objects are also taken out of the collector\'s\n"
+"lists, so that it never writes to them again, and they are kept alive until\n"
+"unfreeze() is called.\n"
+"\n"
+"If immortal is true, the frozen objects and all the objects they refer to are\n"
+"made immortal: they will never be deallocated, and their reference counts are\n"
+"no longer updated, so that the pages holding them stay shared after fork().");
 
 #define GC_FREEZE_METHODDEF    \
-    {"freeze", (PyCFunction)gc_freeze, METH_NOARGS, gc_freeze__doc__},
+    {"freeze", (PyCFunction)(void(*)(void))gc_freeze, METH_FASTCALL|METH_KEYWORDS, gc_freeze__doc__},
 
 static PyObject *
-gc_freeze_impl(PyObject *module);
+gc_freeze_impl(PyObject *module, int detach, int immortal);
 
 static PyObject *
-gc_freeze(PyObject *module, PyObject *Py_UNUSED(ignored))
+gc_freeze(PyObject *module, PyObject *const *args, Py_ssize_t nargs, PyObject *kwnames)
 {
-    return gc_freeze_impl(module);
+    PyObject *return_value = NULL;
+    static const char * const _keywords[] = {"detach", "immortal", NULL};
+    static _PyArg_Parser _parser = {NULL, _keywords, "freeze", 0};
+    PyObject *argsbuf[2];
+    Py_ssize_t noptargs = nargs + (kwnames ? PyTuple_GET_SIZE(kwnames) : 0) - 0;
+    int detach = 0;
+    int immortal = 0;
+
+    args = _PyArg_UnpackKeywords(args, nargs, NULL, kwnames, &_parser, 0, 0, 0, argsbuf);
+    if (!args) {
+        goto exit;
+    }
+    if (!noptargs) {
+        goto skip_optional_kwonly;
+    }
+    if (args[0]) {
+        detach = _PyLong_AsInt(args[0]);
+        if (detach == -1 && PyErr_Occurred()) {
+            goto exit;
+        }
+        if (!--noptargs) {
+            goto skip_optional_kwonly;
+        }
+    }
+    immortal = _PyLong_AsInt(args[1]);
+    if (immortal == -1 && PyErr_Occurred()) {
+        goto exit;
+    }
+skip_optional_kwonly:
+    return_value = gc_freeze_impl(module, detach, immortal);
+
+exit:
+    return return_value;
 }
 
 PyDoc_STRVAR(gc_unfreeze__doc__,
@@ -372,4 +524,95 @@ gc_get_freeze_count(PyObject *module, PyObject *Py_UNUSED(ignored))
 exit:
     return return_value;
 }
-/*[clinic end generated code: output=61e15f3a549f3ab5 input=a9049054013a1b77]*/
+
+PyDoc_STRVAR(gc_set_tenure_threshold__doc__,
+"set_tenure_threshold($module, threshold, interval=10, /)\n"
+"--\n"
+"\n"
+"Set the number of full collections after which objects are tenured.\n"
+"\n"
+"The objects of the oldest generation that survive that many full\n"
+"collections move to the tenured generation.  Only one in interval\n"
+"automatic full collections examines it, as do explicit ones.  A\n"
+"threshold of zero disables tenuring.");
+
+#define GC_SET_TENURE_THRESHOLD_METHODDEF    \
+    {"set_tenure_threshold", (PyCFunction)(void(*)(void))gc_set_tenure_threshold, METH_FASTCALL, gc_set_tenure_threshold__doc__},
+
+static PyObject *
+gc_set_tenure_threshold_impl(PyObject *module, int threshold, int interval);
+
+static PyObject *
+gc_set_tenure_threshold(PyObject *module, PyObject *const *args, Py_ssize_t nargs)
+{
+    PyObject *return_value = NULL;
+    int threshold;
+    int interval = 10;
+
+    if (!_PyArg_CheckPositional("set_tenure_threshold", nargs, 1, 2)) {
+        goto exit;
+    }
+    threshold = _PyLong_AsInt(args[0]);
+    if (threshold == -1 && PyErr_Occurred()) {
+        goto exit;
+    }
+    if (nargs < 2) {
+        goto skip_optional;
+    }
+    interval = _PyLong_AsInt(args[1]);
+    if (interval == -1 && PyErr_Occurred()) {
+        goto exit;
+    }
+skip_optional:
+    return_value = gc_set_tenure_threshold_impl(module, threshold, interval);
+
+exit:
+    return return_value;
+}
+
+PyDoc_STRVAR(gc_get_tenure_threshold__doc__,
+"get_tenure_threshold($module, /)\n"
+"--\n"
+"\n"
+"Return the tenure threshold and the interval of tenured collections.");
+
+#define GC_GET_TENURE_THRESHOLD_METHODDEF    \
+    {"get_tenure_threshold", (PyCFunction)gc_get_tenure_threshold, METH_NOARGS, gc_get_tenure_threshold__doc__},
+
+static PyObject *
+gc_get_tenure_threshold_impl(PyObject *module);
+
+static PyObject *
+gc_get_tenure_threshold(PyObject *module, PyObject *Py_UNUSED(ignored))
+{
+    return gc_get_tenure_threshold_impl(module);
+}
+
+PyDoc_STRVAR(gc_get_tenured_count__doc__,
+"get_tenured_count($module, /)\n"
+"--\n"
+"\n"
+"Return the number of objects in the tenured generation.");
+
+#define GC_GET_TENURED_COUNT_METHODDEF    \
+    {"get_tenured_count", (PyCFunction)gc_get_tenured_count, METH_NOARGS, gc_get_tenured_count__doc__},
+
+static Py_ssize_t
+gc_get_tenured_count_impl(PyObject *module);
+
+static PyObject *
+gc_get_tenured_count(PyObject *module, PyObject *Py_UNUSED(ignored))
+{
+    PyObject *return_value = NULL;
+    Py_ssize_t _return_value;
+
+    _return_value = gc_get_tenured_count_impl(module);
+    if ((_return_value == -1) && PyErr_Occurred()) {
+        goto exit;
+    }
+    return_value = PyLong_FromSsize_t(_return_value);
+
+exit:
+    return return_value;
+}
+/*[clinic end generated code: output=8c0354aa39e6ad7f input=a9049054013a1b77]*/
@@ -29,6 +29,7 @@
 #include "pycore_interp.h"      // PyInterpreterState.gc
 #include "pycore_object.h"
 #include "pycore_pyerrors.h"
+#include "pycore_pymem.h"       // _PyObject_TrimMemory()
 #include "pycore_pystate.h"     // _PyThreadState_GET()
 #include "pydtrace.h"
 
@@ -127,6 +128,12 @@ gc_decref(PyGC_Head *g)
 
 #define GEN_HEAD(gcstate, n) (&(gcstate)->generations[n].head)
 
+/* Objects scanned per second, assumed until incremental slices have
+   measured it, and the fewest objects of the oldest generation a slice
+   starts from */
+#define GC_INITIAL_SCAN_RATE 1e6
+#define GC_MIN_SLICE 100
+
 
 static GCState *
 get_gc_state(void)
@@ -157,6 +164,18 @@ _PyGC_InitState(GCState *gcstate)
            (uintptr_t)&gcstate->permanent_generation.head}, 0, 0
     };
     gcstate->permanent_generation = permanent_generation;
+    gcstate->old_visited._gc_next = (uintptr_t)&gcstate->old_visited;
+    gcstate->old_visited._gc_prev = (uintptr_t)&gcstate->old_visited;
+    gcstate->scan_rate = GC_INITIAL_SCAN_RATE;
+    for (int i = 0; i < GC_MAX_TENURE_THRESHOLD - 1; i++) {
+        gcstate->aging[i]._gc_next = (uintptr_t)&gcstate->aging[i];
+        gcstate->aging[i]._gc_prev = (uintptr_t)&gcstate->aging[i];
+    }
+    struct gc_generation tenured = {
+          {(uintptr_t)&gcstate->tenured.head,
+           (uintptr_t)&gcstate->tenured.head}, 10, 0
+    };
+    gcstate->tenured = tenured;
 }
 
 
@@ -418,12 +437,14 @@ validate_list(PyGC_Head *head, enum flagstates flags)
 
 /* Set all gc_refs = ob_refcnt.  After this, gc_refs is > 0 and
  * PREV_MASK_COLLECTING bit is set for all objects in containers.
+ * Return the number of objects in containers.
  */
-static void
+static Py_ssize_t
 update_refs(PyGC_Head *containers)
 {
+    Py_ssize_t n = 0;
     PyGC_Head *gc = GC_NEXT(containers);
-    for (; gc != containers; gc = GC_NEXT(gc)) {
+    for (; gc != containers; gc = GC_NEXT(gc), n++) {
         gc_reset_refs(gc, Py_REFCNT(FROM_GC(gc)));
         /* Python's cyclic gc should never see an incoming refcount
          * of 0:  if something decref'ed to 0, it should have been
@@ -445,6 +466,7 @@ update_refs(PyGC_Head *containers)
          */
         _PyObject_ASSERT(FROM_GC(gc), gc_get_refs(gc) != 0);
     }
+    return n;
 }
 
 /* A traversal callback for subtract_refs. */
@@ -565,6 +587,13 @@ move_unreachable(PyGC_Head *young, PyGC_Head *unreachable)
     PyGC_Head *prev = young;
     PyGC_Head *gc = GC_NEXT(young);
 
+    // unreachable may hold the objects of a previous call already (see
+    // deduce_unreachable()): they have NEXT_MASK_UNREACHABLE, but the list
+    // head was cleaned, and visit_reachable expects it on all of them.
+    if (!gc_list_is_empty(unreachable)) {
+        unreachable->_gc_next |= NEXT_MASK_UNREACHABLE;
+    }
+
     /* Invariants:  all objects "to the left" of us in young are reachable
      * (directly or indirectly) from outside the young list as it was at entry.
      *
@@ -1045,6 +1074,27 @@ clear_freelists(PyInterpreterState *interp)
     _PyDict_ClearFreeList(interp);
     _PyAsyncGen_ClearFreeLists(interp);
     _PyContext_ClearFreeList(interp);
+    _PyMethod_ClearFreeList(interp);
+    _PySlice_ClearFreeList(interp);
+    _PyRangeIter_ClearFreeList(interp);
+    _PyLong_ClearFreeList(interp);
+}
+
+/* Fill in the lists that hold the oldest generation besides its own: the
+ * objects the current incremental cycle already scanned, and the aging and
+ * tenured objects.  Return how many there are. */
+#define NUM_OLD_LISTS (GC_MAX_TENURE_THRESHOLD + 1)
+static int
+old_generation_lists(GCState *gcstate, PyGC_Head **lists)
+{
+    int n = 0;
+    lists[n++] = &gcstate->old_visited;
+    for (int i = 0; i < GC_MAX_TENURE_THRESHOLD - 1; i++) {
+        lists[n++] = &gcstate->aging[i];
+    }
+    lists[n++] = &gcstate->tenured.head;
+    assert(n == NUM_OLD_LISTS);
+    return n;
 }
 
 // Show stats for objects in each generations
@@ -1053,21 +1103,30 @@ show_stats_each_generations(GCState *gcstate)
 {
     char buf[100];
     size_t pos = 0;
+    PyGC_Head *old_lists[NUM_OLD_LISTS];
+    int n_old_lists = old_generation_lists(gcstate, old_lists);
 
     for (int i = 0; i < NUM_GENERATIONS && pos < sizeof(buf); i++) {
-        pos += PyOS_snprintf(buf+pos, sizeof(buf)-pos,
-                             " %zd",
-                             gc_list_size(GEN_HEAD(gcstate, i)));
+        Py_ssize_t size = gc_list_size(GEN_HEAD(gcstate, i));
+        if (i == NUM_GENERATIONS - 1) {
+            for (int j = 0; j < n_old_lists; j++) {
+                size += gc_list_size(old_lists[j]);
+            }
+        }
+        pos += PyOS_snprintf(buf+pos, sizeof(buf)-pos, " %zd", size);
     }
 
     PySys_FormatStderr(
         "gc: objects in each generation:%s\n"
+        "gc: objects in tenured generation: %zd\n"
         "gc: objects in permanent generation: %zd\n",
-        buf, gc_list_size(&gcstate->permanent_generation.head));
+        buf, gc_list_size(&gcstate->tenured.head),
+        gc_list_size(&gcstate->permanent_generation.head));
 }
 
-/* Deduce which objects among "base" are unreachable from outside the list
-   and move them to 'unreachable'. The process consist in the following steps:
+/* Deduce which objects among the "bases" lists are unreachable from outside
+   the lists and move them to 'unreachable'. The process consist in the
+   following steps:
 
 1. Copy all reference counts to a different field (gc_prev is used to hold
    this copy to save memory).
@@ -1081,28 +1140,53 @@ show_stats_each_generations(GCState *gcstate)
    objects that were initially marked as unreachable but are referred transitively
    by the reachable objects (the ones with strictly positive reference count).
 
+The reachable objects stay in their own list, except for those that step 3
+moves back from "unreachable": they go to the list being scanned then.  So the
+lists can keep objects of different ages apart (see gc_collect_main()).
+
 Contracts:
 
-    * The "base" has to be a valid list with no mask set.
+    * The "bases" have to be valid lists with no mask set.
 
     * The "unreachable" list must be uninitialized (this function calls
       gc_list_init over 'unreachable').
 
+    * The time spent in each step is added to "stats", unless it is NULL.
+
 IMPORTANT: This function leaves 'unreachable' with the NEXT_MASK_UNREACHABLE
 flag set but it does not clear it to skip unnecessary iteration. Before the
 flag is cleared (for example, by using 'clear_unreachable_mask' function or
 by a call to 'move_legacy_finalizers'), the 'unreachable' list is not a normal
 list and we can not use most gc_list_* functions for it. */
 static inline void
-deduce_unreachable(PyGC_Head *base, PyGC_Head *unreachable) {
-    validate_list(base, collecting_clear_unreachable_clear);
+deduce_unreachable(PyGC_Head **bases, int nbases, PyGC_Head *unreachable,
+                   struct gc_generation_stats *stats) {
+    _PyTime_t t1 = 0, t2 = 0, t3 = 0;
+    Py_ssize_t n = 0;
+    int i;
+    for (i = 0; i < nbases; i++) {
+        validate_list(bases[i], collecting_clear_unreachable_clear);
+    }
     /* Using ob_refcnt and gc_refs, calculate which objects in the
      * container set are reachable from outside the set (i.e., have a
      * refcount greater than 0 when all the references within the
      * set are taken into account).
      */
-    update_refs(base);  // gc_prev is used for gc_refs
-    subtract_refs(base);
+    if (stats) {
+        t1 = _PyTime_GetPerfCounter();
+    }
+    for (i = 0; i < nbases; i++) {
+        n += update_refs(bases[i]);  // gc_prev is used for gc_refs
+    }
+    if (stats) {
+        t2 = _PyTime_GetPerfCounter();
+    }
+    for (i = 0; i < nbases; i++) {
+        subtract_refs(bases[i]);
+    }
+    if (stats) {
+        t3 = _PyTime_GetPerfCounter();
+    }
 
     /* Leave everything reachable from outside base in base, and move
      * everything else (in base) to unreachable.
@@ -1140,9 +1224,19 @@ deduce_unreachable(PyGC_Head *base, PyGC_Head *unreachable) {
      * worth complicating the code to speed just a little.
      */
     gc_list_init(unreachable);
-    move_unreachable(base, unreachable);  // gc_prev is pointer again
-    validate_list(base, collecting_clear_unreachable_clear);
+    for (i = 0; i < nbases; i++) {
+        move_unreachable(bases[i], unreachable);  // gc_prev is pointer again
+    }
+    for (i = 0; i < nbases; i++) {
+        validate_list(bases[i], collecting_clear_unreachable_clear);
+    }
     validate_list(unreachable, collecting_set_unreachable_set);
+    if (stats) {
+        stats->visited += n;
+        stats->update_refs_time += t2 - t1;
+        stats->subtract_refs_time += t3 - t2;
+        stats->move_unreachable_time += _PyTime_GetPerfCounter() - t3;
+    }
 }
 
 /* Handle objects that may have resurrected after a call to 'finalize_garbage', moving
@@ -1170,88 +1264,53 @@ handle_resurrected_objects(PyGC_Head *unreachable, PyGC_Head* still_unreachable,
     // have the PREV_MARK_COLLECTING set, but the objects are going to be
     // removed so we can skip the expense of clearing the flag.
     PyGC_Head* resurrected = unreachable;
-    deduce_unreachable(resurrected, still_unreachable);
+    deduce_unreachable(&resurrected, 1, still_unreachable, NULL);
     clear_unreachable_mask(still_unreachable);
 
     // Move the resurrected objects to the old generation for future collection.
     gc_list_merge(resurrected, old_generation);
 }
 
-/* This is the main function.  Read this to understand how the
- * collection process works. */
-static Py_ssize_t
-gc_collect_main(PyThreadState *tstate, int generation,
-                Py_ssize_t *n_collected, Py_ssize_t *n_uncollectable,
-                int nofail)
+/* Collect the unreachable objects of the lists young[0..nlists-1] and
+ * append the survivors of young[i] to olds[i], in that order (they may be
+ * the same list).  Objects that must be kept for other reasons go to the
+ * last of olds.  The number of survivors of each list is stored in
+ * n_survivors if it isn't NULL, and the time spent in each phase is added
+ * to "stats". */
+static void
+gc_collect_region(PyThreadState *tstate, PyGC_Head **young, PyGC_Head **olds,
+                  int nlists, int untrack_dicts_flag,
+                  struct gc_generation_stats *stats, Py_ssize_t *n_survivors,
+                  Py_ssize_t *n_collected, Py_ssize_t *n_uncollectable)
 {
-    int i;
     Py_ssize_t m = 0; /* # objects collected */
     Py_ssize_t n = 0; /* # unreachable objects that couldn't be collected */
-    PyGC_Head *young; /* the generation we are examining */
-    PyGC_Head *old; /* next older generation */
+    PyGC_Head *old = olds[nlists - 1];
     PyGC_Head unreachable; /* non-problematic unreachable trash */
     PyGC_Head finalizers;  /* objects with, & reachable from, __del__ */
     PyGC_Head *gc;
-    _PyTime_t t1 = 0;   /* initialize to prevent a compiler warning */
     GCState *gcstate = &tstate->interp->gc;
+    _PyTime_t t0 = _PyTime_GetPerfCounter(), t1, t2;
+    int i;
 
-    // gc_collect_main() must not be called before _PyGC_Init
-    // or after _PyGC_Fini()
-    assert(gcstate->garbage != NULL);
-    assert(!_PyErr_Occurred(tstate));
-
-#ifdef EXPERIMENTAL_ISOLATED_SUBINTERPRETERS
-    if (tstate->interp->config._isolated_interpreter) {
-        // bpo-40533: The garbage collector must not be run on parallel on
-        // Python objects shared by multiple interpreters.
-        return 0;
-    }
-#endif
-
-    if (gcstate->debug & DEBUG_STATS) {
-        PySys_WriteStderr("gc: collecting generation %d...\n", generation);
-        show_stats_each_generations(gcstate);
-        t1 = _PyTime_GetPerfCounter();
-    }
-
-    if (PyDTrace_GC_START_ENABLED())
-        PyDTrace_GC_START(generation);
-
-    /* update collection and allocation counters */
-    if (generation+1 < NUM_GENERATIONS)
-        gcstate->generations[generation+1].count += 1;
-    for (i = 0; i <= generation; i++)
-        gcstate->generations[i].count = 0;
-
-    /* merge younger generations with one we are currently collecting */
-    for (i = 0; i < generation; i++) {
-        gc_list_merge(GEN_HEAD(gcstate, i), GEN_HEAD(gcstate, generation));
-    }
-
-    /* handy references */
-    young = GEN_HEAD(gcstate, generation);
-    if (generation < NUM_GENERATIONS-1)
-        old = GEN_HEAD(gcstate, generation+1);
-    else
-        old = young;
     validate_list(old, collecting_clear_unreachable_clear);
 
-    deduce_unreachable(young, &unreachable);
+    deduce_unreachable(young, nlists, &unreachable, stats);
 
-    untrack_tuples(young);
-    /* Move reachable objects to next generation. */
-    if (young != old) {
-        if (generation == NUM_GENERATIONS - 2) {
-            gcstate->long_lived_pending += gc_list_size(young);
+    for (i = 0; i < nlists; i++) {
+        untrack_tuples(young[i]);
+        if (untrack_dicts_flag) {
+            /* We only un-track dicts in full collections, to avoid quadratic
+               dict build-up. See issue #14775. */
+            untrack_dicts(young[i]);
+        }
+        if (n_survivors) {
+            n_survivors[i] = gc_list_size(young[i]);
+        }
+        /* Move reachable objects to next generation. */
+        if (young[i] != olds[i]) {
+            gc_list_merge(young[i], olds[i]);
         }
-        gc_list_merge(young, old);
-    }
-    else {
-        /* We only un-track dicts in full collections, to avoid quadratic
-           dict build-up. See issue #14775. */
-        untrack_dicts(young);
-        gcstate->long_lived_pending = 0;
-        gcstate->long_lived_total = gc_list_size(young);
     }
 
     /* All objects in unreachable are trash, but objects reachable from
@@ -1278,7 +1337,10 @@ gc_collect_main(PyThreadState *tstate, int generation,
     }
 
     /* Clear weakrefs and invoke callbacks as necessary. */
+    t1 = _PyTime_GetPerfCounter();
     m += handle_weakrefs(&unreachable, old);
+    t2 = _PyTime_GetPerfCounter();
+    stats->weakrefs_time += t2 - t1;
 
     validate_list(old, collecting_clear_unreachable_clear);
     validate_list(&unreachable, collecting_set_unreachable_clear);
@@ -1291,6 +1353,8 @@ gc_collect_main(PyThreadState *tstate, int generation,
      * objects that are still unreachable */
     PyGC_Head final_unreachable;
     handle_resurrected_objects(&unreachable, &final_unreachable, old);
+    t1 = _PyTime_GetPerfCounter();
+    stats->finalization_time += t1 - t2;
 
     /* Call tp_clear on objects in the final_unreachable set.  This will cause
     * the reference cycles to be broken.  It may also cause some objects
@@ -1298,6 +1362,8 @@ gc_collect_main(PyThreadState *tstate, int generation,
     */
     m += gc_list_size(&final_unreachable);
     delete_garbage(tstate, gcstate, &final_unreachable, old);
+    t2 = _PyTime_GetPerfCounter();
+    stats->delete_time += t2 - t1;
 
     /* Collect statistics on uncollectable objects found and print
      * debugging information. */
@@ -1306,12 +1372,6 @@ gc_collect_main(PyThreadState *tstate, int generation,
         if (gcstate->debug & DEBUG_UNCOLLECTABLE)
             debug_cycle("uncollectable", FROM_GC(gc));
     }
-    if (gcstate->debug & DEBUG_STATS) {
-        double d = _PyTime_AsSecondsDouble(_PyTime_GetPerfCounter() - t1);
-        PySys_WriteStderr(
-            "gc: done, %zd unreachable, %zd uncollectable, %.4fs elapsed\n",
-            n+m, n, d);
-    }
 
     /* Append instances in the uncollectable set to a Python
      * reachable list of garbage.  The programmer has to deal with
@@ -1320,10 +1380,144 @@ gc_collect_main(PyThreadState *tstate, int generation,
     handle_legacy_finalizers(tstate, gcstate, &finalizers, old);
     validate_list(old, collecting_clear_unreachable_clear);
 
+    stats->total_time += _PyTime_GetPerfCounter() - t0;
+    *n_collected = m;
+    *n_uncollectable = n;
+}
+
+/* Fill in the lists a full collection examines when tenuring is enabled,
+ * oldest first, and the lists where their survivors go.  Return how many
+ * there are.  The tenured generation is only examined if scan_tenured is
+ * true; otherwise the references from it work like references from outside
+ * the collector. */
+static int
+tenuring_lists(GCState *gcstate, int scan_tenured,
+               PyGC_Head **young, PyGC_Head **old)
+{
+    PyGC_Head *tenured = &gcstate->tenured.head;
+    int n = 0;
+    if (scan_tenured) {
+        young[n] = old[n] = tenured;
+        n++;
+        gcstate->tenured.count = 0;
+    }
+    /* age is the number of full collections the objects survived */
+    for (int age = GC_MAX_TENURE_THRESHOLD - 1; age >= 0; age--) {
+        young[n] = age ? &gcstate->aging[age - 1]
+                       : GEN_HEAD(gcstate, NUM_GENERATIONS - 1);
+        old[n] = age + 1 >= gcstate->tenure_threshold ? tenured
+                                                      : &gcstate->aging[age];
+        n++;
+    }
+    return n;
+}
+
+/* This is the main function.  Read this to understand how the
+ * collection process works. */
+static Py_ssize_t
+gc_collect_main(PyThreadState *tstate, int generation,
+                Py_ssize_t *n_collected, Py_ssize_t *n_uncollectable,
+                int scan_tenured, int nofail)
+{
+    int i;
+    Py_ssize_t m = 0; /* # objects collected */
+    Py_ssize_t n = 0; /* # unreachable objects that couldn't be collected */
+    Py_ssize_t survivors = 0;
+    PyGC_Head *young; /* the generation we are examining */
+    PyGC_Head *old; /* next older generation */
+    _PyTime_t t1 = 0;   /* initialize to prevent a compiler warning */
+    GCState *gcstate = &tstate->interp->gc;
+
+    // gc_collect_main() must not be called before _PyGC_Init
+    // or after _PyGC_Fini()
+    assert(gcstate->garbage != NULL);
+    assert(!_PyErr_Occurred(tstate));
+
+#ifdef EXPERIMENTAL_ISOLATED_SUBINTERPRETERS
+    if (tstate->interp->config._isolated_interpreter) {
+        // bpo-40533: The garbage collector must not be run on parallel on
+        // Python objects shared by multiple interpreters.
+        return 0;
+    }
+#endif
+
+    if (gcstate->debug & DEBUG_STATS) {
+        PySys_WriteStderr("gc: collecting generation %d...\n", generation);
+        show_stats_each_generations(gcstate);
+        t1 = _PyTime_GetPerfCounter();
+    }
+
+    if (PyDTrace_GC_START_ENABLED())
+        PyDTrace_GC_START(generation);
+
+    /* update collection and allocation counters */
+    if (generation+1 < NUM_GENERATIONS)
+        gcstate->generations[generation+1].count += 1;
+    for (i = 0; i <= generation; i++)
+        gcstate->generations[i].count = 0;
+
+    /* merge younger generations with one we are currently collecting */
+    for (i = 0; i < generation; i++) {
+        gc_list_merge(GEN_HEAD(gcstate, i), GEN_HEAD(gcstate, generation));
+    }
+
+    /* handy references */
+    young = GEN_HEAD(gcstate, generation);
+    if (generation < NUM_GENERATIONS-1) {
+        old = GEN_HEAD(gcstate, generation+1);
+    }
+    else {
+        /* A full collection ends the current incremental cycle, if any */
+        gc_list_merge(&gcstate->old_visited, young);
+        gcstate->old_visited_size = 0;
+        gcstate->full_collection_due = 0;
+        old = young;
+    }
+
+    struct gc_generation_stats *stats = &gcstate->generation_stats[generation];
+    if (young == old && gcstate->tenure_threshold > 0) {
+        /* Keep the objects of each age apart, and age the survivors.
+           Tenured objects don't count as long lived: only the rest of
+           the generation drives the full collections. */
+        PyGC_Head *youngs[GC_MAX_TENURE_THRESHOLD + 1];
+        PyGC_Head *olds[GC_MAX_TENURE_THRESHOLD + 1];
+        Py_ssize_t counts[GC_MAX_TENURE_THRESHOLD + 1];
+        int nlists = tenuring_lists(gcstate, scan_tenured, youngs, olds);
+        gc_collect_region(tstate, youngs, olds, nlists, 1, stats, counts,
+                          &m, &n);
+        for (i = 0; i < nlists; i++) {
+            if (olds[i] != &gcstate->tenured.head) {
+                survivors += counts[i];
+            }
+        }
+    }
+    else {
+        gc_collect_region(tstate, &young, &old, 1, young == old, stats,
+                          generation >= NUM_GENERATIONS - 2 ? &survivors : NULL,
+                          &m, &n);
+    }
+    if (generation == NUM_GENERATIONS - 2) {
+        gcstate->long_lived_pending += survivors;
+    }
+    else if (generation == NUM_GENERATIONS - 1) {
+        gcstate->long_lived_pending = 0;
+        gcstate->long_lived_total = survivors;
+    }
+
+    if (gcstate->debug & DEBUG_STATS) {
+        double d = _PyTime_AsSecondsDouble(_PyTime_GetPerfCounter() - t1);
+        PySys_WriteStderr(
+            "gc: done, %zd unreachable, %zd uncollectable, %.4fs elapsed\n",
+            n+m, n, d);
+    }
+
     /* Clear free list only during the collection of the highest
      * generation */
     if (generation == NUM_GENERATIONS-1) {
         clear_freelists(tstate->interp);
+        if (gcstate->trim_memory) {
+            _PyObject_TrimMemory();
+        }
     }
 
     if (_PyErr_Occurred(tstate)) {
@@ -1343,7 +1537,6 @@ gc_collect_main(PyThreadState *tstate, int generation,
         *n_uncollectable = n;
     }
 
-    struct gc_generation_stats *stats = &gcstate->generation_stats[generation];
     stats->collections++;
     stats->collected += m;
     stats->uncollectable += n;
@@ -1356,13 +1549,162 @@ gc_collect_main(PyThreadState *tstate, int generation,
     return n + m;
 }
 
+/* Move the objects of the window ahead of the slice that the slice refers
+ * to into it (see gc_collect_increment()). */
+static int
+visit_add_to_increment(PyObject *op, PyGC_Head *increment)
+{
+    if (_PyObject_IS_GC(op)) {
+        PyGC_Head *gc = AS_GC(op);
+        if (gc_is_collecting(gc)) {
+            gc_clear_collecting(gc);
+            gc_list_move(gc, increment);
+        }
+    }
+    return 0;
+}
+
+/* Collect the younger generations along with a slice of the oldest one,
+ * sized to take about gcstate->pause_target.
+ *
+ * The slice is collected like a generation is: references from outside
+ * of it, including from the rest of the oldest generation, keep its
+ * objects alive.  So it needs no write barrier, and the program can run
+ * between slices as it pleases.  A garbage cycle is only found when it is
+ * entirely in one slice, so the slice also takes in the objects it refers
+ * to among the next ones in line (the "window"), which were most likely
+ * created along with it.  Cycles that still span several slices are left
+ * to a full collection, which gc_collect_generations() falls back to when
+ * the oldest generation keeps growing from one cycle to the next.
+ *
+ * The objects surviving a slice go to gcstate->old_visited, and back to
+ * the oldest generation once all of it was scanned.
+ */
+static Py_ssize_t
+gc_collect_increment(PyThreadState *tstate, Py_ssize_t *n_collected,
+                     Py_ssize_t *n_uncollectable, Py_ssize_t *n_scanned)
+{
+    GCState *gcstate = &tstate->interp->gc;
+    PyGC_Head *pending = GEN_HEAD(gcstate, NUM_GENERATIONS-1);
+    PyGC_Head increment;
+    PyGC_Head *gc;
+    Py_ssize_t m, n, survivors;
+    _PyTime_t t1 = _PyTime_GetPerfCounter();
+
+    assert(gcstate->garbage != NULL);
+    assert(!_PyErr_Occurred(tstate));
+
+#ifdef EXPERIMENTAL_ISOLATED_SUBINTERPRETERS
+    if (tstate->interp->config._isolated_interpreter) {
+        *n_collected = *n_uncollectable = *n_scanned = 0;
+        return 0;
+    }
+#endif
+
+    if (gcstate->debug & DEBUG_STATS) {
+        PySys_WriteStderr("gc: collecting a slice of generation %d...\n",
+                          NUM_GENERATIONS-1);
+        show_stats_each_generations(gcstate);
+    }
+
+    if (PyDTrace_GC_START_ENABLED())
+        PyDTrace_GC_START(NUM_GENERATIONS-1);
+
+    gc_list_init(&increment);
+    for (int i = 0; i < NUM_GENERATIONS; i++) {
+        gcstate->generations[i].count = 0;
+    }
+    for (int i = 0; i < NUM_GENERATIONS-1; i++) {
+        gc_list_merge(GEN_HEAD(gcstate, i), &increment);
+    }
+    Py_ssize_t young = gc_list_size(&increment);
+
+    /* Half of the budget goes to the slice and half to the window */
+    double budget = gcstate->scan_rate *
+                    _PyTime_AsSecondsDouble(gcstate->pause_target);
+    Py_ssize_t size = Py_MAX(((Py_ssize_t)budget - young) / 2, GC_MIN_SLICE);
+    Py_ssize_t seeds = 0;
+    while (seeds < size && !gc_list_is_empty(pending)) {
+        gc_list_move(GC_NEXT(pending), &increment);
+        seeds++;
+    }
+    Py_ssize_t window = 0;
+    for (gc = GC_NEXT(pending); gc != pending && window < size;
+         gc = GC_NEXT(gc))
+    {
+        gc->_gc_prev |= PREV_MASK_COLLECTING;
+        window++;
+    }
+    Py_ssize_t scanned = 0;
+    for (gc = GC_NEXT(&increment); gc != &increment; gc = GC_NEXT(gc)) {
+        PyObject *op = FROM_GC(gc);
+        traverseproc traverse = Py_TYPE(op)->tp_traverse;
+        (void) traverse(op, (visitproc)visit_add_to_increment, &increment);
+        scanned++;
+    }
+    /* What is left of the window is still at the head of the generation */
+    Py_ssize_t left = window - (scanned - young - seeds);
+    for (gc = GC_NEXT(pending); left > 0; gc = GC_NEXT(gc), left--) {
+        gc_clear_collecting(gc);
+    }
+
+    struct gc_generation_stats *stats =
+        &gcstate->generation_stats[NUM_GENERATIONS-1];
+    PyGC_Head *young_list = &increment, *old_list = &gcstate->old_visited;
+    gc_collect_region(tstate, &young_list, &old_list, 1, 1, stats,
+                      &survivors, &m, &n);
+    gcstate->old_visited_size += survivors;
+    if (gc_list_is_empty(pending)) {
+        /* The cycle is over: a full collection is due if the generation
+           grew like the heuristic in gc_collect_generations() wants */
+        Py_ssize_t total = gcstate->long_lived_total;
+        gcstate->full_collection_due =
+            gcstate->old_visited_size > total + total / 4;
+        gc_list_merge(&gcstate->old_visited, pending);
+        gcstate->old_visited_size = 0;
+        stats->collections++;
+    }
+    stats->collected += m;
+    stats->uncollectable += n;
+
+    _PyTime_t elapsed = _PyTime_GetPerfCounter() - t1;
+    if (elapsed > 0) {
+        double rate = scanned / _PyTime_AsSecondsDouble(elapsed);
+        gcstate->scan_rate = (gcstate->scan_rate + rate) / 2;
+    }
+
+    if (gcstate->debug & DEBUG_STATS) {
+        PySys_WriteStderr(
+            "gc: done, %zd objects scanned, %zd unreachable, "
+            "%zd uncollectable, %.4fs elapsed\n",
+            scanned, n+m, n, _PyTime_AsSecondsDouble(elapsed));
+    }
+
+    if (_PyErr_Occurred(tstate)) {
+        _PyErr_WriteUnraisableMsg("in garbage collection", NULL);
+    }
+
+    *n_collected = m;
+    *n_uncollectable = n;
+    *n_scanned = scanned;
+
+    if (PyDTrace_GC_DONE_ENABLED()) {
+        PyDTrace_GC_DONE(n + m);
+    }
+
+    assert(!_PyErr_Occurred(tstate));
+    return n + m;
+}
+
 /* Invoke progress callbacks to notify clients that garbage collection
- * is starting or stopping
+ * is starting or stopping.  The number of objects scanned and the
+ * duration are only reported when stopping.
  */
 static void
 invoke_gc_callback(PyThreadState *tstate, const char *phase,
                    int generation, Py_ssize_t collected,
-                   Py_ssize_t uncollectable)
+                   Py_ssize_t uncollectable, int incremental,
+                   Py_ssize_t scanned, _PyTime_t duration)
 {
     assert(!_PyErr_Occurred(tstate));
 
@@ -1376,10 +1718,30 @@ invoke_gc_callback(PyThreadState *tstate, const char *phase,
     assert(PyList_CheckExact(gcstate->callbacks));
     PyObject *info = NULL;
     if (PyList_GET_SIZE(gcstate->callbacks) != 0) {
-        info = Py_BuildValue("{sisnsn}",
+        info = Py_BuildValue("{sisnsnsO}",
             "generation", generation,
             "collected", collected,
-            "uncollectable", uncollectable);
+            "uncollectable", uncollectable,
+            "incremental", incremental ? Py_True : Py_False);
+        if (info != NULL && strcmp(phase, "stop") == 0) {
+            PyObject *value = PyFloat_FromDouble(
+                _PyTime_AsSecondsDouble(duration));
+            if (value == NULL
+                || PyDict_SetItemString(info, "duration", value) < 0)
+            {
+                Py_CLEAR(info);
+            }
+            Py_XDECREF(value);
+            if (info != NULL && incremental) {
+                value = PyLong_FromSsize_t(scanned);
+                if (value == NULL
+                    || PyDict_SetItemString(info, "objects", value) < 0)
+                {
+                    Py_CLEAR(info);
+                }
+                Py_XDECREF(value);
+            }
+        }
         if (info == NULL) {
             PyErr_WriteUnraisable(NULL);
             return;
@@ -1405,13 +1767,36 @@ invoke_gc_callback(PyThreadState *tstate, const char *phase,
  * progress callbacks.
  */
 static Py_ssize_t
-gc_collect_with_callback(PyThreadState *tstate, int generation)
+gc_collect_with_callback(PyThreadState *tstate, int generation,
+                         int scan_tenured)
 {
     assert(!_PyErr_Occurred(tstate));
     Py_ssize_t result, collected, uncollectable;
-    invoke_gc_callback(tstate, "start", generation, 0, 0);
-    result = gc_collect_main(tstate, generation, &collected, &uncollectable, 0);
-    invoke_gc_callback(tstate, "stop", generation, collected, uncollectable);
+    invoke_gc_callback(tstate, "start", generation, 0, 0, 0, 0, 0);
+    _PyTime_t t1 = _PyTime_GetPerfCounter();
+    result = gc_collect_main(tstate, generation, &collected, &uncollectable,
+                             scan_tenured, 0);
+    invoke_gc_callback(tstate, "stop", generation, collected, uncollectable,
+                       0, 0, _PyTime_GetPerfCounter() - t1);
+    assert(!_PyErr_Occurred(tstate));
+    return result;
+}
+
+/* Perform a slice of an incremental collection and invoke progress
+ * callbacks.
+ */
+static Py_ssize_t
+gc_collect_increment_with_callback(PyThreadState *tstate)
+{
+    assert(!_PyErr_Occurred(tstate));
+    Py_ssize_t result, collected, uncollectable, scanned;
+    invoke_gc_callback(tstate, "start", NUM_GENERATIONS - 1, 0, 0, 1, 0, 0);
+    _PyTime_t t1 = _PyTime_GetPerfCounter();
+    result = gc_collect_increment(tstate, &collected, &uncollectable,
+                                  &scanned);
+    invoke_gc_callback(tstate, "stop", NUM_GENERATIONS - 1, collected,
+                       uncollectable, 1, scanned,
+                       _PyTime_GetPerfCounter() - t1);
     assert(!_PyErr_Occurred(tstate));
     return result;
 }
@@ -1461,11 +1846,32 @@ gc_collect_generations(PyThreadState *tstate)
                This heuristic was suggested by Martin von Löwis on python-dev in
                June 2008. His original analysis and proposal can be found at:
                http://mail.python.org/pipermail/python-dev/2008-June/080579.html
+
+               With a pause target, the oldest generation is collected a
+               slice at a time instead, and the same ratio (measured at the
+               end of each pass over the generation) decides when a full
+               collection is needed to find the cycles that slices missed.
             */
-            if (i == NUM_GENERATIONS - 1
-                && gcstate->long_lived_pending < gcstate->long_lived_total / 4)
-                continue;
-            n = gc_collect_with_callback(tstate, i);
+            if (i == NUM_GENERATIONS - 1) {
+                if (gcstate->pause_target > 0) {
+                    if (!gcstate->full_collection_due) {
+                        n = gc_collect_increment_with_callback(tstate);
+                        break;
+                    }
+                }
+                else if (gcstate->long_lived_pending
+                         < gcstate->long_lived_total / 4) {
+                    continue;
+                }
+            }
+            /* Automatic full collections only examine the tenured
+               generation once in a while */
+            int scan_tenured = 1;
+            if (i == NUM_GENERATIONS - 1 && gcstate->tenure_threshold > 0) {
+                scan_tenured = (++gcstate->tenured.count
+                                >= gcstate->tenured.threshold);
+            }
+            n = gc_collect_with_callback(tstate, i, scan_tenured);
             break;
         }
     }
@@ -1548,7 +1954,7 @@ gc_collect_impl(PyObject *module, int generation)
     }
     else {
         gcstate->collecting = 1;
-        n = gc_collect_with_callback(tstate, generation);
+        n = gc_collect_with_callback(tstate, generation, 1);
         gcstate->collecting = 0;
     }
     return n;
@@ -1634,6 +2040,84 @@ gc_get_threshold_impl(PyObject *module)
                          gcstate->generations[2].threshold);
 }
 
+/*[clinic input]
+gc.set_pause_target
+
+    ms: object
+    /
+
+Set the pause target of automatic collections, in milliseconds.
+
+Automatic collections of the oldest generation then run in slices sized
+to take about that long.  Zero disables incremental collection.
+[clinic start generated code]*/
+
+static PyObject *
+gc_set_pause_target(PyObject *module, PyObject *ms)
+/*[clinic end generated code: output=3e59674fdbaaf0a4 input=301e4768f7653ddc]*/
+{
+    _PyTime_t target;
+    if (_PyTime_FromMillisecondsObject(&target, ms,
+                                       _PyTime_ROUND_CEILING) < 0) {
+        return NULL;
+    }
+    if (target < 0) {
+        PyErr_SetString(PyExc_ValueError,
+                        "pause target must be non-negative");
+        return NULL;
+    }
+    GCState *gcstate = get_gc_state();
+    gcstate->pause_target = target;
+    Py_RETURN_NONE;
+}
+
+/*[clinic input]
+gc.get_pause_target
+
+Return the pause target of automatic collections, in milliseconds.
+[clinic start generated code]*/
+
+static PyObject *
+gc_get_pause_target_impl(PyObject *module)
+/*[clinic end generated code: output=9c71aef7d13f27c1 input=0a306bed7b2d5c9e]*/
+{
+    GCState *gcstate = get_gc_state();
+    return PyFloat_FromDouble(
+        _PyTime_AsSecondsDouble(gcstate->pause_target) * 1e3);
+}
+
+/*[clinic input]
+gc.set_trim_memory
+
+    enabled: bool(accept={int})
+    /
+
+Set whether full collections give the free memory back to the system.
+[clinic start generated code]*/
+
+static PyObject *
+gc_set_trim_memory_impl(PyObject *module, int enabled)
+/*[clinic end generated code: output=33af5fc576c2e862 input=fe15c4eba6c929fd]*/
+{
+    GCState *gcstate = get_gc_state();
+    gcstate->trim_memory = enabled;
+    Py_RETURN_NONE;
+}
+
+/*[clinic input]
+gc.get_trim_memory -> bool
+
+Return whether full collections give the free memory back to the system.
+[clinic start generated code]*/
+
+static int
+gc_get_trim_memory_impl(PyObject *module)
+/*[clinic end generated code: output=ae2c0cf9fe1bcb2c input=3784adea2257d32b]*/
+{
+    GCState *gcstate = get_gc_state();
+    return gcstate->trim_memory;
+}
+
 /*[clinic input]
 gc.get_count
 
@@ -1703,6 +2187,14 @@ gc_get_referrers(PyObject *self, PyObject *args)
             return NULL;
         }
     }
+    PyGC_Head *old_lists[NUM_OLD_LISTS];
+    int n_old_lists = old_generation_lists(gcstate, old_lists);
+    for (int i = 0; i < n_old_lists; i++) {
+        if (!(gc_referrers_for(args, old_lists[i], result))) {
+            Py_DECREF(result);
+            return NULL;
+        }
+    }
     return result;
 }
 
@@ -1765,6 +2257,8 @@ gc_get_objects_impl(PyObject *module, Py_ssize_t generation)
     int i;
     PyObject* result;
     GCState *gcstate = &tstate->interp->gc;
+    PyGC_Head *old_lists[NUM_OLD_LISTS];
+    int n_old_lists = old_generation_lists(gcstate, old_lists);
 
     if (PySys_Audit("gc.get_objects", "n", generation) < 0) {
         return NULL;
@@ -1794,6 +2288,13 @@ gc_get_objects_impl(PyObject *module, Py_ssize_t generation)
         if (append_objects(result, GEN_HEAD(gcstate, generation))) {
             goto error;
         }
+        if (generation == NUM_GENERATIONS - 1) {
+            for (i = 0; i < n_old_lists; i++) {
+                if (append_objects(result, old_lists[i])) {
+                    goto error;
+                }
+            }
+        }
 
         return result;
     }
@@ -1804,6 +2305,11 @@ gc_get_objects_impl(PyObject *module, Py_ssize_t generation)
             goto error;
         }
     }
+    for (i = 0; i < n_old_lists; i++) {
+        if (append_objects(result, old_lists[i])) {
+            goto error;
+        }
+    }
     return result;
 
 error:
@@ -1811,15 +2317,110 @@ gc_get_objects_impl(PyObject *module, Py_ssize_t generation)
     return NULL;
 }
 
+/* Count the objects of a gc list by type in the dict "counts".
+ * Return 0 if all OK, < 0 if error.
+ */
+static int
+count_objects_by_type(PyGC_Head *gc_list, PyObject *counts)
+{
+    PyGC_Head *gc;
+    for (gc = GC_NEXT(gc_list); gc != gc_list; gc = GC_NEXT(gc)) {
+        PyObject *type = (PyObject *)Py_TYPE(FROM_GC(gc));
+        PyObject *count = PyDict_GetItemWithError(counts, type);
+        Py_ssize_t n = 0;
+        if (count != NULL) {
+            n = PyLong_AsSsize_t(count);
+        }
+        else if (PyErr_Occurred()) {
+            return -1;
+        }
+        count = PyLong_FromSsize_t(n + 1);
+        if (count == NULL) {
+            return -1;
+        }
+        if (PyDict_SetItem(counts, type, count) < 0) {
+            Py_DECREF(count);
+            return -1;
+        }
+        Py_DECREF(count);
+    }
+    return 0;
+}
+
+/* Add the detailed statistics of a generation to its dict */
+static int
+add_detailed_stats(GCState *gcstate, int generation,
+                   struct gc_generation_stats *st, PyObject *dict)
+{
+    PyObject *times = Py_BuildValue("{sdsdsdsdsdsdsd}",
+        "update_refs", _PyTime_AsSecondsDouble(st->update_refs_time),
+        "subtract_refs", _PyTime_AsSecondsDouble(st->subtract_refs_time),
+        "move_unreachable", _PyTime_AsSecondsDouble(st->move_unreachable_time),
+        "weakrefs", _PyTime_AsSecondsDouble(st->weakrefs_time),
+        "finalization", _PyTime_AsSecondsDouble(st->finalization_time),
+        "delete", _PyTime_AsSecondsDouble(st->delete_time),
+        "total", _PyTime_AsSecondsDouble(st->total_time));
+    if (times == NULL) {
+        return -1;
+    }
+    int err = PyDict_SetItemString(dict, "times", times);
+    Py_DECREF(times);
+    if (err < 0) {
+        return -1;
+    }
+
+    PyObject *visited = PyLong_FromSsize_t(st->visited);
+    if (visited == NULL) {
+        return -1;
+    }
+    err = PyDict_SetItemString(dict, "visited", visited);
+    Py_DECREF(visited);
+    if (err < 0) {
+        return -1;
+    }
+
+    /* The objects now in a generation are the survivors of its past
+       collections (and of the younger generations'), so they are counted
+       when asked rather than during the collections. */
+    PyObject *survivors = PyDict_New();
+    if (survivors == NULL) {
+        return -1;
+    }
+    if (count_objects_by_type(GEN_HEAD(gcstate, generation), survivors) < 0) {
+        Py_DECREF(survivors);
+        return -1;
+    }
+    if (generation == NUM_GENERATIONS - 1) {
+        PyGC_Head *old_lists[NUM_OLD_LISTS];
+        int n_old_lists = old_generation_lists(gcstate, old_lists);
+        for (int i = 0; i < n_old_lists; i++) {
+            if (count_objects_by_type(old_lists[i], survivors) < 0) {
+                Py_DECREF(survivors);
+                return -1;
+            }
+        }
+    }
+    err = PyDict_SetItemString(dict, "survivors", survivors);
+    Py_DECREF(survivors);
+    return err;
+}
+
 /*[clinic input]
 gc.get_stats
 
+    *
+    detailed: bool(accept={int}) = False
+
 Return a list of dictionaries containing per-generation statistics.
+
+With detailed=True, the dictionaries also hold the number of objects
+the collections examined, the time they spent in each phase, and the
+number of objects of each type now in the generation.
 [clinic start generated code]*/
 
 static PyObject *
-gc_get_stats_impl(PyObject *module)
-/*[clinic end generated code: output=a8ab1d8a5d26f3ab input=1ef4ed9d17b1a470]*/
+gc_get_stats_impl(PyObject *module, int detailed)
+/*[clinic end generated code: output=4e6e7abaf7d0108d input=1952372d0c1015f3]*/
 {
     int i;
     struct gc_generation_stats stats[NUM_GENERATIONS], *st;
@@ -1845,6 +2446,10 @@ gc_get_stats_impl(PyObject *module)
                             );
         if (dict == NULL)
             goto error;
+        if (detailed && add_detailed_stats(gcstate, i, st, dict) < 0) {
+            Py_DECREF(dict);
+            goto error;
+        }
         if (PyList_Append(result, dict)) {
             Py_DECREF(dict);
             goto error;
@@ -1903,25 +2508,187 @@ gc_is_finalized(PyObject *module, PyObject *obj)
     Py_RETURN_FALSE;
 }
 
+/* Take the objects of a gc list out of it, into gcstate->detached.
+ * Return 0 if all OK, < 0 if error (out of memory for list).
+ */
+static int
+detach_objects(GCState *gcstate, PyGC_Head *gc_list)
+{
+    while (!gc_list_is_empty(gc_list)) {
+        PyGC_Head *gc = GC_NEXT(gc_list);
+        if (PyList_Append(gcstate->detached, FROM_GC(gc)) < 0) {
+            return -1;
+        }
+        gc_list_remove(gc);
+        /* The object stays tracked, but linked to itself: untracking it
+           only writes to its own header, and no other list operation
+           writes to it. */
+        gc->_gc_next = (uintptr_t)gc;
+        _PyGCHead_SET_PREV(gc, gc);
+    }
+    return 0;
+}
+
+/* Put the objects frozen by gc.freeze(detach=True) back into the oldest
+ * generation, and release them. */
+static void
+reattach_objects(GCState *gcstate)
+{
+    PyObject *detached = gcstate->detached;
+    if (detached == NULL) {
+        return;
+    }
+    gcstate->detached = NULL;
+    for (Py_ssize_t i = 0; i < PyList_GET_SIZE(detached); i++) {
+        PyGC_Head *gc = AS_GC(PyList_GET_ITEM(detached, i));
+        /* Unless it was untracked since */
+        if (gc->_gc_next == (uintptr_t)gc) {
+            gc_list_append(gc, GEN_HEAD(gcstate, NUM_GENERATIONS-1));
+        }
+    }
+    Py_DECREF(detached);
+}
+
+/* Stack of the objects whose referents remain to be made immortal. */
+typedef struct {
+    PyObject **items;
+    Py_ssize_t size;
+    Py_ssize_t allocated;
+} immortal_stack;
+
+static int
+visit_immortalize(PyObject *op, immortal_stack *stack)
+{
+    if (_Py_IsImmortal(op)) {
+        return 0;
+    }
+    _Py_SetImmortal(op);
+    /* Tracked objects are reached through the permanent generation; only
+       descend into untracked containers (atomic tuples and dicts...) and
+       into code objects, which hold most of the names and constants. */
+    if (!PyCode_Check(op)
+        && (!_PyObject_IS_GC(op) || _PyObject_GC_IS_TRACKED(op))) {
+        return 0;
+    }
+    if (stack->size == stack->allocated) {
+        Py_ssize_t allocated = stack->allocated ? stack->allocated * 2 : 64;
+        PyObject **items = PyMem_Realloc(stack->items,
+                                         allocated * sizeof(PyObject *));
+        if (items == NULL) {
+            PyErr_NoMemory();
+            return -1;
+        }
+        stack->items = items;
+        stack->allocated = allocated;
+    }
+    stack->items[stack->size++] = op;
+    return 0;
+}
+
+/* Code objects don't support the gc protocol: visit their members here. */
+static int
+traverse_immortalize(PyObject *op, immortal_stack *stack)
+{
+    visitproc visit = (visitproc)visit_immortalize;
+    void *arg = stack;
+    if (PyCode_Check(op)) {
+        PyCodeObject *co = (PyCodeObject *)op;
+        Py_VISIT(co->co_consts);
+        Py_VISIT(co->co_names);
+        Py_VISIT(co->co_exceptiontable);
+        Py_VISIT(co->co_code);
+        Py_VISIT(co->co_localsplusnames);
+        Py_VISIT(co->co_localspluskinds);
+        Py_VISIT(co->co_filename);
+        Py_VISIT(co->co_name);
+        Py_VISIT(co->co_qualname);
+        Py_VISIT(co->co_linetable);
+        Py_VISIT(co->co_endlinetable);
+        Py_VISIT(co->co_columntable);
+        Py_VISIT(co->co_varnames);
+        Py_VISIT(co->co_cellvars);
+        Py_VISIT(co->co_freevars);
+        return 0;
+    }
+    return Py_TYPE(op)->tp_traverse(op, visit, arg);
+}
+
+/* Make immortal the objects of a gc list, and everything they refer to.
+ * Return 0 if all OK, < 0 if error (out of memory for the stack).
+ */
+static int
+immortalize_objects(PyGC_Head *gc_list)
+{
+    immortal_stack stack = {NULL, 0, 0};
+    int res = 0;
+    for (PyGC_Head *gc = GC_NEXT(gc_list); gc != gc_list; gc = GC_NEXT(gc)) {
+        PyObject *op = FROM_GC(gc);
+        _Py_SetImmortal(op);
+        res = traverse_immortalize(op, &stack);
+        while (res == 0 && stack.size > 0) {
+            res = traverse_immortalize(stack.items[--stack.size], &stack);
+        }
+        if (res < 0) {
+            break;
+        }
+    }
+    PyMem_Free(stack.items);
+    return res;
+}
+
 /*[clinic input]
 gc.freeze
 
+    *
+    detach: bool(accept={int}) = False
+    immortal: bool(accept={int}) = False
+
 Freeze all current tracked objects and ignore them for future collections.
 
 This can be used before a POSIX fork() call to make the gc copy-on-write friendly.
 Note: collection before a POSIX fork() call may free pages for future allocation
 which can cause copy-on-write.
+
+If detach is true, the frozen objects are also taken out of the collector's
+lists, so that it never writes to them again, and they are kept alive until
+unfreeze() is called.
+
+If immortal is true, the frozen objects and all the objects they refer to are
+made immortal: they will never be deallocated, and their reference counts are
+no longer updated, so that the pages holding them stay shared after fork().
 [clinic start generated code]*/
 
 static PyObject *
-gc_freeze_impl(PyObject *module)
-/*[clinic end generated code: output=502159d9cdc4c139 input=b602b16ac5febbe5]*/
+gc_freeze_impl(PyObject *module, int detach, int immortal)
+/*[clinic end generated code: output=a5c595ad9410759c input=3d27d6e851734514]*/
 {
     GCState *gcstate = get_gc_state();
+    PyGC_Head *permanent = &gcstate->permanent_generation.head;
+    PyGC_Head *old_lists[NUM_OLD_LISTS];
+    int n_old_lists = old_generation_lists(gcstate, old_lists);
     for (int i = 0; i < NUM_GENERATIONS; ++i) {
-        gc_list_merge(GEN_HEAD(gcstate, i), &gcstate->permanent_generation.head);
+        gc_list_merge(GEN_HEAD(gcstate, i), permanent);
         gcstate->generations[i].count = 0;
     }
+    for (int i = 0; i < n_old_lists; i++) {
+        gc_list_merge(old_lists[i], permanent);
+    }
+    gcstate->old_visited_size = 0;
+    if (immortal && immortalize_objects(permanent) < 0) {
+        return NULL;
+    }
+    if (detach) {
+        if (gcstate->detached == NULL) {
+            gcstate->detached = PyList_New(0);
+            if (gcstate->detached == NULL) {
+                return NULL;
+            }
+            PyObject_GC_UnTrack(gcstate->detached);
+        }
+        if (detach_objects(gcstate, permanent) < 0) {
+            return NULL;
+        }
+    }
     Py_RETURN_NONE;
 }
 
@@ -1940,6 +2707,7 @@ gc_unfreeze_impl(PyObject *module)
     GCState *gcstate = get_gc_state();
     gc_list_merge(&gcstate->permanent_generation.head,
                   GEN_HEAD(gcstate, NUM_GENERATIONS-1));
+    reattach_objects(gcstate);
     Py_RETURN_NONE;
 }
 
@@ -1954,7 +2722,87 @@ gc_get_freeze_count_impl(PyObject *module)
 /*[clinic end generated code: output=61cbd9f43aa032e1 input=45ffbc65cfe2a6ed]*/
 {
     GCState *gcstate = get_gc_state();
-    return gc_list_size(&gcstate->permanent_generation.head);
+    Py_ssize_t n = gc_list_size(&gcstate->permanent_generation.head);
+    if (gcstate->detached != NULL) {
+        for (Py_ssize_t i = 0; i < PyList_GET_SIZE(gcstate->detached); i++) {
+            PyGC_Head *gc = AS_GC(PyList_GET_ITEM(gcstate->detached, i));
+            n += (gc->_gc_next == (uintptr_t)gc);
+        }
+    }
+    return n;
+}
+
+/*[clinic input]
+gc.set_tenure_threshold
+
+    threshold: int
+    interval: int = 10
+    /
+
+Set the number of full collections after which objects are tenured.
+
+The objects of the oldest generation that survive that many full
+collections move to the tenured generation.  Only one in interval
+automatic full collections examines it, as do explicit ones.  A
+threshold of zero disables tenuring.
+[clinic start generated code]*/
+
+static PyObject *
+gc_set_tenure_threshold_impl(PyObject *module, int threshold, int interval)
+/*[clinic end generated code: output=a243f3db1abb0bcc input=9fbb63d9686e4374]*/
+{
+    if (threshold < 0 || threshold > GC_MAX_TENURE_THRESHOLD) {
+        PyErr_Format(PyExc_ValueError,
+                     "tenure threshold must be between 0 and %d",
+                     GC_MAX_TENURE_THRESHOLD);
+        return NULL;
+    }
+    if (interval < 1) {
+        PyErr_SetString(PyExc_ValueError, "interval must be positive");
+        return NULL;
+    }
+    GCState *gcstate = get_gc_state();
+    gcstate->tenure_threshold = threshold;
+    gcstate->tenured.threshold = interval;
+    if (threshold == 0) {
+        PyGC_Head *old = GEN_HEAD(gcstate, NUM_GENERATIONS-1);
+        for (int i = 0; i < GC_MAX_TENURE_THRESHOLD - 1; i++) {
+            gc_list_merge(&gcstate->aging[i], old);
+        }
+        gc_list_merge(&gcstate->tenured.head, old);
+        gcstate->tenured.count = 0;
+    }
+    Py_RETURN_NONE;
+}
+
+/*[clinic input]
+gc.get_tenure_threshold
+
+Return the tenure threshold and the interval of tenured collections.
+[clinic start generated code]*/
+
+static PyObject *
+gc_get_tenure_threshold_impl(PyObject *module)
+/*[clinic end generated code: output=83c91bb6d6ce1de9 input=96f6917accc850fe]*/
+{
+    GCState *gcstate = get_gc_state();
+    return Py_BuildValue("(ii)",
+                         gcstate->tenure_threshold,
+                         gcstate->tenured.threshold);
+}
+
+/*[clinic input]
+gc.get_tenured_count -> Py_ssize_t
+
+Return the number of objects in the tenured generation.
+[clinic start generated code]*/
+
+static Py_ssize_t
+gc_get_tenured_count_impl(PyObject *module)
+/*[clinic end generated code: output=5d2f09476749a841 input=2dac959168ed4253]*/
+{
+    GCState *gcstate = get_gc_state();
+    return gc_list_size(&gcstate->tenured.head);
 }
 
 
@@ -1971,6 +2819,10 @@ PyDoc_STRVAR(gc__doc__,
 "get_debug() -- Get debugging flags.\n"
 "set_threshold() -- Set the collection thresholds.\n"
 "get_threshold() -- Return the current the collection thresholds.\n"
+"set_pause_target() -- Set the pause target of incremental collection.\n"
+"get_pause_target() -- Return the pause target of incremental collection.\n"
+"set_trim_memory() -- Give the free memory back to the system after full collections.\n"
+"get_trim_memory() -- Return whether full collections give the free memory back.\n"
 "get_objects() -- Return a list of all objects tracked by the collector.\n"
 "is_tracked() -- Returns true if a given object is tracked.\n"
 "is_finalized() -- Returns true if a given object has been already finalized.\n"
@@ -1978,7 +2830,10 @@ PyDoc_STRVAR(gc__doc__,
 "get_referents() -- Return the list of objects that an object refers to.\n"
 "freeze() -- Freeze all tracked objects and ignore them for future collections.\n"
 "unfreeze() -- Unfreeze all objects in the permanent generation.\n"
-"get_freeze_count() -- Return the number of objects in the permanent generation.\n");
+"get_freeze_count() -- Return the number of objects in the permanent generation.\n"
+"set_tenure_threshold() -- Set the number of full collections before tenuring.\n"
+"get_tenure_threshold() -- Return the tenure threshold and interval.\n"
+"get_tenured_count() -- Return the number of objects in the tenured generation.\n");
 
 static PyMethodDef GcMethods[] = {
     GC_ENABLE_METHODDEF
@@ -1989,6 +2844,10 @@ static PyMethodDef GcMethods[] = {
     GC_GET_COUNT_METHODDEF
     {"set_threshold",  gc_set_threshold, METH_VARARGS, gc_set_thresh__doc__},
     GC_GET_THRESHOLD_METHODDEF
+    GC_SET_PAUSE_TARGET_METHODDEF
+    GC_GET_PAUSE_TARGET_METHODDEF
+    GC_SET_TRIM_MEMORY_METHODDEF
+    GC_GET_TRIM_MEMORY_METHODDEF
     GC_COLLECT_METHODDEF
     GC_GET_OBJECTS_METHODDEF
     GC_GET_STATS_METHODDEF
@@ -2001,6 +2860,9 @@ static PyMethodDef GcMethods[] = {
     GC_FREEZE_METHODDEF
     GC_UNFREEZE_METHODDEF
     GC_GET_FREEZE_COUNT_METHODDEF
+    GC_SET_TENURE_THRESHOLD_METHODDEF
+    GC_GET_TENURE_THRESHOLD_METHODDEF
+    GC_GET_TENURED_COUNT_METHODDEF
     {NULL,      NULL}           /* Sentinel */
 };
 
@@ -2096,7 +2958,7 @@ PyGC_Collect(void)
         PyObject *exc, *value, *tb;
         gcstate->collecting = 1;
         _PyErr_Fetch(tstate, &exc, &value, &tb);
-        n = gc_collect_with_callback(tstate, NUM_GENERATIONS - 1);
+        n = gc_collect_with_callback(tstate, NUM_GENERATIONS - 1, 1);
         _PyErr_Restore(tstate, exc, value, tb);
         gcstate->collecting = 0;
     }
@@ -2120,7 +2982,7 @@ _PyGC_CollectNoFail(PyThreadState *tstate)
 
     Py_ssize_t n;
     gcstate->collecting = 1;
-    n = gc_collect_main(tstate, NUM_GENERATIONS - 1, NULL, NULL, 1);
+    n = gc_collect_main(tstate, NUM_GENERATIONS - 1, NULL, NULL, 1, 1);
     gcstate->collecting = 0;
     return n;
 }
@@ -2166,6 +3028,7 @@ void
 _PyGC_Fini(PyInterpreterState *interp)
 {
     GCState *gcstate = &interp->gc;
+    reattach_objects(gcstate);
     Py_CLEAR(gcstate->garbage);
     Py_CLEAR(gcstate->callbacks);
 }
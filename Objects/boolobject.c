@@ -5,20 +5,12 @@
 
 /* We define bool_repr to return "False" or "True" */
 
-static PyObject *false_str = NULL;
-static PyObject *true_str = NULL;
-
 static PyObject *
 bool_repr(PyObject *self)
 {
-    PyObject *s;
-
-    if (self == Py_True)
-        s = true_str ? true_str :
-            (true_str = PyUnicode_InternFromString("True"));
-    else
-        s = false_str ? false_str :
-            (false_str = PyUnicode_InternFromString("False"));
+    _Py_IDENTIFIER(True);
+    _Py_IDENTIFIER(False);
+    PyObject *s = _PyUnicode_FromId(self == Py_True ? &PyId_True : &PyId_False);
     Py_XINCREF(s);
     return s;
 }
@@ -206,11 +198,11 @@ PyTypeObject PyBool_Type = {
 /* The objects representing bool values False and True */
 
 struct _longobject _Py_FalseStruct = {
-    PyVarObject_HEAD_INIT(&PyBool_Type, 0)
+    _PyVarObject_IMMORTAL_INIT(&PyBool_Type, 0)
     { 0 }
 };
 
 struct _longobject _Py_TrueStruct = {
-    PyVarObject_HEAD_INIT(&PyBool_Type, 1)
+    _PyVarObject_IMMORTAL_INIT(&PyBool_Type, 1)
     { 1 }
 };
@@ -4,6 +4,7 @@
 #include "pycore_call.h"          // _PyObject_VectorcallTstate()
 #include "pycore_object.h"
 #include "pycore_pyerrors.h"
+#include "pycore_pylifecycle.h"   // _PyMethod_Fini()
 #include "pycore_pystate.h"       // _PyThreadState_GET()
 #include "structmember.h"         // PyMemberDef
 
@@ -96,6 +97,53 @@ method_vectorcall(PyObject *method, PyObject *const *args,
    function.
 */
 
+#if PyMethod_MAXFREELIST > 0
+static struct _Py_method_state *
+get_method_state(void)
+{
+    PyInterpreterState *interp = _PyInterpreterState_GET();
+    return &interp->method;
+}
+#endif
+
+
+void
+_PyMethod_ClearFreeList(PyInterpreterState *interp)
+{
+#if PyMethod_MAXFREELIST > 0
+    struct _Py_method_state *state = &interp->method;
+    while (state->numfree) {
+        PyMethodObject *im = state->free_list[--state->numfree];
+        assert(PyMethod_Check(im));
+        PyObject_GC_Del(im);
+    }
+#endif
+}
+
+
+void
+_PyMethod_Fini(PyInterpreterState *interp)
+{
+    _PyMethod_ClearFreeList(interp);
+#if defined(Py_DEBUG) && PyMethod_MAXFREELIST > 0
+    struct _Py_method_state *state = &interp->method;
+    state->numfree = -1;
+#endif
+}
+
+
+/* Print summary info about the state of the optimized allocator */
+void
+_PyMethod_DebugMallocStats(FILE *out)
+{
+#if PyMethod_MAXFREELIST > 0
+    struct _Py_method_state *state = get_method_state();
+    _PyDebugAllocatorStats(out, "free PyMethodObject",
+                           state->numfree, sizeof(PyMethodObject));
+#endif
+}
+
+
 PyObject *
 PyMethod_New(PyObject *func, PyObject *self)
 {
@@ -103,9 +151,24 @@ PyMethod_New(PyObject *func, PyObject *self)
         PyErr_BadInternalCall();
         return NULL;
     }
-    PyMethodObject *im = PyObject_GC_New(PyMethodObject, &PyMethod_Type);
-    if (im == NULL) {
-        return NULL;
+    PyMethodObject *im;
+#if PyMethod_MAXFREELIST > 0
+    struct _Py_method_state *state = get_method_state();
+#ifdef Py_DEBUG
+    // PyMethod_New() must not be called after _PyMethod_Fini()
+    assert(state->numfree != -1);
+#endif
+    if (state->numfree) {
+        im = state->free_list[--state->numfree];
+        _Py_NewReference((PyObject *)im);
+    }
+    else
+#endif
+    {
+        im = PyObject_GC_New(PyMethodObject, &PyMethod_Type);
+        if (im == NULL) {
+            return NULL;
+        }
     }
     im->im_weakreflist = NULL;
     Py_INCREF(func);
@@ -240,6 +303,17 @@ method_dealloc(PyMethodObject *im)
         PyObject_ClearWeakRefs((PyObject *)im);
     Py_DECREF(im->im_func);
     Py_XDECREF(im->im_self);
+#if PyMethod_MAXFREELIST > 0
+    struct _Py_method_state *state = get_method_state();
+#ifdef Py_DEBUG
+    // method_dealloc() must not be called after _PyMethod_Fini()
+    assert(state->numfree != -1);
+#endif
+    if (state->numfree < PyMethod_MAXFREELIST) {
+        state->free_list[state->numfree++] = im;
+        return;
+    }
+#endif
     PyObject_GC_Del(im);
 }
 
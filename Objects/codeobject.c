@@ -6,6 +6,7 @@
 #include "structmember.h"         // PyMemberDef
 #include "pycore_code.h"          // _PyCodeConstructor
 #include "pycore_interp.h"        // PyInterpreterState.co_extra_freefuncs
+#include "pycore_optimizer.h"     // _PyOptimizer_ClearCode()
 #include "pycore_pystate.h"       // _PyInterpreterState_GET()
 #include "pycore_tuple.h"         // _PyTuple_ITEMS()
 #include "clinic/codeobject.c.h"
@@ -351,6 +352,8 @@ init_code(PyCodeObject *co, struct _PyCodeConstructor *con)
 
     co->co_warmup = QUICKENING_INITIAL_WARMUP_VALUE;
     co->co_quickened = NULL;
+    co->co_opstats = NULL;
+    co->co_tier2 = NULL;
 }
 
 /* The caller is responsible for ensuring that the given data is valid. */
@@ -1374,6 +1377,8 @@ code_dealloc(PyCodeObject *co)
         PyMem_Free(co->co_quickened);
         _Py_QuickenedCount--;
     }
+    PyMem_Free(co->co_opstats);
+    _PyOptimizer_ClearCode(co);
     PyObject_Free(co);
 }
 
@@ -1570,6 +1575,10 @@ code_sizeof(PyCodeObject *co, PyObject *Py_UNUSED(args))
             sizeof(SpecializedCacheEntry);
         res += count * sizeof(SpecializedCacheEntry);
     }
+    if (co->co_opstats != NULL) {
+        res += (PyBytes_GET_SIZE(co->co_code) / sizeof(_Py_CODEUNIT)) *
+               sizeof(_PyOpcodeStats);
+    }
 
     return PyLong_FromSsize_t(res);
 }
@@ -263,6 +263,9 @@ _PyDict_ClearFreeList(PyInterpreterState *interp)
     while (state->keys_numfree) {
         PyObject_Free(state->keys_free_list[--state->keys_numfree]);
     }
+    while (state->view_numfree) {
+        PyObject_GC_Del(state->view_free_list[--state->view_numfree]);
+    }
 #endif
 }
 
@@ -275,6 +278,7 @@ _PyDict_Fini(PyInterpreterState *interp)
     struct _Py_dict_state *state = &interp->dict_state;
     state->numfree = -1;
     state->keys_numfree = -1;
+    state->view_numfree = -1;
 #endif
 }
 
@@ -287,6 +291,8 @@ _PyDict_DebugMallocStats(FILE *out)
     struct _Py_dict_state *state = get_dict_state();
     _PyDebugAllocatorStats(out, "free PyDictObject",
                            state->numfree, sizeof(PyDictObject));
+    _PyDebugAllocatorStats(out, "free dict view",
+                           state->view_numfree, sizeof(_PyDictViewObject));
 #endif
 }
 
@@ -4133,6 +4139,23 @@ dictview_dealloc(_PyDictViewObject *dv)
     /* bpo-31095: UnTrack is needed before calling any callbacks */
     _PyObject_GC_UNTRACK(dv);
     Py_XDECREF(dv->dv_dict);
+#if PyDict_MAXFREELIST > 0
+    struct _Py_dict_state *state = get_dict_state();
+#ifdef Py_DEBUG
+    // dictview_dealloc() must not be called after _PyDict_Fini()
+    assert(state->view_numfree != -1);
+#endif
+    /* Views of the three types have the same size: the type is set again
+       when the view is reused */
+    if (state->view_numfree < PyDict_MAXFREELIST
+        && (Py_IS_TYPE(dv, &PyDictKeys_Type)
+            || Py_IS_TYPE(dv, &PyDictValues_Type)
+            || Py_IS_TYPE(dv, &PyDictItems_Type)))
+    {
+        state->view_free_list[state->view_numfree++] = dv;
+        return;
+    }
+#endif
     PyObject_GC_Del(dv);
 }
 
@@ -4167,9 +4190,27 @@ _PyDictView_New(PyObject *dict, PyTypeObject *type)
                      type->tp_name, Py_TYPE(dict)->tp_name);
         return NULL;
     }
-    dv = PyObject_GC_New(_PyDictViewObject, type);
-    if (dv == NULL)
-        return NULL;
+#if PyDict_MAXFREELIST > 0
+    struct _Py_dict_state *state = get_dict_state();
+#ifdef Py_DEBUG
+    // _PyDictView_New() must not be called after _PyDict_Fini()
+    assert(state->view_numfree != -1);
+#endif
+    if (state->view_numfree
+        && (type == &PyDictKeys_Type || type == &PyDictValues_Type
+            || type == &PyDictItems_Type))
+    {
+        dv = state->view_free_list[--state->view_numfree];
+        Py_SET_TYPE(dv, type);
+        _Py_NewReference((PyObject *)dv);
+    }
+    else
+#endif
+    {
+        dv = PyObject_GC_New(_PyDictViewObject, type);
+        if (dv == NULL)
+            return NULL;
+    }
     Py_INCREF(dict);
     dv->dv_dict = (PyDictObject *)dict;
     _PyObject_GC_TRACK(dv);
@@ -3,6 +3,7 @@
 #include "Python.h"
 #include "pycore_abstract.h"      // _PyIndex_Check()
 #include "pycore_interp.h"        // PyInterpreterState.list
+#include "pycore_list.h"          // _PyListIterObject
 #include "pycore_object.h"        // _PyObject_GC_TRACK()
 #include "pycore_tuple.h"         // _PyTuple_FromArray()
 #include <stddef.h>
@@ -111,6 +112,11 @@ _PyList_ClearFreeList(PyInterpreterState *interp)
         assert(PyList_CheckExact(op));
         PyObject_GC_Del(op);
     }
+    while (state->iter_numfree) {
+        PyObject *it = state->iter_free_list[--state->iter_numfree];
+        assert(Py_IS_TYPE(it, &PyListIter_Type));
+        PyObject_GC_Del(it);
+    }
 #endif
 }
 
@@ -121,6 +127,7 @@ _PyList_Fini(PyInterpreterState *interp)
 #if defined(Py_DEBUG) && PyList_MAXFREELIST > 0
     struct _Py_list_state *state = &interp->list;
     state->numfree = -1;
+    state->iter_numfree = -1;
 #endif
 }
 
@@ -133,6 +140,9 @@ _PyList_DebugMallocStats(FILE *out)
     _PyDebugAllocatorStats(out,
                            "free PyListObject",
                            state->numfree, sizeof(PyListObject));
+    _PyDebugAllocatorStats(out,
+                           "free list_iterator",
+                           state->iter_numfree, sizeof(_PyListIterObject));
 #endif
 }
 
@@ -223,7 +233,8 @@ valid_index(Py_ssize_t i, Py_ssize_t limit)
     return (size_t) i < (size_t) limit;
 }
 
-static PyObject *indexerr = NULL;
+/* The message is created once per interpreter */
+_Py_static_string(PyId_indexerr, "list index out of range");
 
 PyObject *
 PyList_GetItem(PyObject *op, Py_ssize_t i)
@@ -233,12 +244,9 @@ PyList_GetItem(PyObject *op, Py_ssize_t i)
         return NULL;
     }
     if (!valid_index(i, Py_SIZE(op))) {
-        if (indexerr == NULL) {
-            indexerr = PyUnicode_FromString(
-                "list index out of range");
-            if (indexerr == NULL)
-                return NULL;
-        }
+        PyObject *indexerr = _PyUnicode_FromId(&PyId_indexerr);
+        if (indexerr == NULL)
+            return NULL;
         PyErr_SetObject(PyExc_IndexError, indexerr);
         return NULL;
     }
@@ -320,6 +328,21 @@ app1(PyListObject *self, PyObject *v)
     return 0;
 }
 
+/* The slow path of _PyList_AppendTakeRef() */
+int
+_PyList_AppendTakeRefListResize(PyListObject *self, PyObject *newitem)
+{
+    Py_ssize_t n = PyList_GET_SIZE(self);
+    assert(self->allocated == -1 || self->allocated == n);
+    assert((size_t)n + 1 < PY_SSIZE_T_MAX);
+    if (list_resize(self, n+1) < 0) {
+        Py_DECREF(newitem);
+        return -1;
+    }
+    PyList_SET_ITEM(self, n, newitem);
+    return 0;
+}
+
 int
 PyList_Append(PyObject *op, PyObject *newitem)
 {
@@ -447,12 +470,9 @@ static PyObject *
 list_item(PyListObject *a, Py_ssize_t i)
 {
     if (!valid_index(i, Py_SIZE(a))) {
-        if (indexerr == NULL) {
-            indexerr = PyUnicode_FromString(
-                "list index out of range");
-            if (indexerr == NULL)
-                return NULL;
-        }
+        PyObject *indexerr = _PyUnicode_FromId(&PyId_indexerr);
+        if (indexerr == NULL)
+            return NULL;
         PyErr_SetObject(PyExc_IndexError, indexerr);
         return NULL;
     }
@@ -3189,19 +3209,13 @@ PyTypeObject PyList_Type = {
 
 /*********************** List Iterator **************************/
 
-typedef struct {
-    PyObject_HEAD
-    Py_ssize_t it_index;
-    PyListObject *it_seq; /* Set to NULL when iterator is exhausted */
-} listiterobject;
-
-static void listiter_dealloc(listiterobject *);
-static int listiter_traverse(listiterobject *, visitproc, void *);
-static PyObject *listiter_next(listiterobject *);
-static PyObject *listiter_len(listiterobject *, PyObject *);
+static void listiter_dealloc(_PyListIterObject *);
+static int listiter_traverse(_PyListIterObject *, visitproc, void *);
+static PyObject *listiter_next(_PyListIterObject *);
+static PyObject *listiter_len(_PyListIterObject *, PyObject *);
 static PyObject *listiter_reduce_general(void *_it, int forward);
-static PyObject *listiter_reduce(listiterobject *, PyObject *);
-static PyObject *listiter_setstate(listiterobject *, PyObject *state);
+static PyObject *listiter_reduce(_PyListIterObject *, PyObject *);
+static PyObject *listiter_setstate(_PyListIterObject *, PyObject *state);
 
 PyDoc_STRVAR(length_hint_doc, "Private method returning an estimate of len(list(it)).");
 PyDoc_STRVAR(reduce_doc, "Return state information for pickling.");
@@ -3217,7 +3231,7 @@ static PyMethodDef listiter_methods[] = {
 PyTypeObject PyListIter_Type = {
     PyVarObject_HEAD_INIT(&PyType_Type, 0)
     "list_iterator",                            /* tp_name */
-    sizeof(listiterobject),                     /* tp_basicsize */
+    sizeof(_PyListIterObject),                  /* tp_basicsize */
     0,                                          /* tp_itemsize */
     /* methods */
     (destructor)listiter_dealloc,               /* tp_dealloc */
@@ -3251,15 +3265,29 @@ PyTypeObject PyListIter_Type = {
 static PyObject *
 list_iter(PyObject *seq)
 {
-    listiterobject *it;
+    _PyListIterObject *it;
 
     if (!PyList_Check(seq)) {
         PyErr_BadInternalCall();
         return NULL;
     }
-    it = PyObject_GC_New(listiterobject, &PyListIter_Type);
-    if (it == NULL)
-        return NULL;
+#if PyList_MAXFREELIST > 0
+    struct _Py_list_state *state = get_list_state();
+#ifdef Py_DEBUG
+    // list_iter() must not be called after _PyList_Fini()
+    assert(state->iter_numfree != -1);
+#endif
+    if (state->iter_numfree) {
+        it = (_PyListIterObject *)state->iter_free_list[--state->iter_numfree];
+        _Py_NewReference((PyObject *)it);
+    }
+    else
+#endif
+    {
+        it = PyObject_GC_New(_PyListIterObject, &PyListIter_Type);
+        if (it == NULL)
+            return NULL;
+    }
     it->it_index = 0;
     Py_INCREF(seq);
     it->it_seq = (PyListObject *)seq;
@@ -3268,22 +3296,33 @@ list_iter(PyObject *seq)
 }
 
 static void
-listiter_dealloc(listiterobject *it)
+listiter_dealloc(_PyListIterObject *it)
 {
     _PyObject_GC_UNTRACK(it);
     Py_XDECREF(it->it_seq);
+#if PyList_MAXFREELIST > 0
+    struct _Py_list_state *state = get_list_state();
+#ifdef Py_DEBUG
+    // listiter_dealloc() must not be called after _PyList_Fini()
+    assert(state->iter_numfree != -1);
+#endif
+    if (state->iter_numfree < PyList_MAXFREELIST) {
+        state->iter_free_list[state->iter_numfree++] = (PyObject *)it;
+        return;
+    }
+#endif
     PyObject_GC_Del(it);
 }
 
 static int
-listiter_traverse(listiterobject *it, visitproc visit, void *arg)
+listiter_traverse(_PyListIterObject *it, visitproc visit, void *arg)
 {
     Py_VISIT(it->it_seq);
     return 0;
 }
 
 static PyObject *
-listiter_next(listiterobject *it)
+listiter_next(_PyListIterObject *it)
 {
     PyListObject *seq;
     PyObject *item;
@@ -3307,7 +3346,7 @@ listiter_next(listiterobject *it)
 }
 
 static PyObject *
-listiter_len(listiterobject *it, PyObject *Py_UNUSED(ignored))
+listiter_len(_PyListIterObject *it, PyObject *Py_UNUSED(ignored))
 {
     Py_ssize_t len;
     if (it->it_seq) {
@@ -3319,13 +3358,13 @@ listiter_len(listiterobject *it, PyObject *Py_UNUSED(ignored))
 }
 
 static PyObject *
-listiter_reduce(listiterobject *it, PyObject *Py_UNUSED(ignored))
+listiter_reduce(_PyListIterObject *it, PyObject *Py_UNUSED(ignored))
 {
     return listiter_reduce_general(it, 1);
 }
 
 static PyObject *
-listiter_setstate(listiterobject *it, PyObject *state)
+listiter_setstate(_PyListIterObject *it, PyObject *state)
 {
     Py_ssize_t index = PyLong_AsSsize_t(state);
     if (index == -1 && PyErr_Occurred())
@@ -3502,7 +3541,7 @@ listiter_reduce_general(void *_it, int forward)
 
     /* the objects are not the same, index is of different types! */
     if (forward) {
-        listiterobject *it = (listiterobject *)_it;
+        _PyListIterObject *it = (_PyListIterObject *)_it;
         if (it->it_seq)
             return Py_BuildValue("N(O)n", _PyEval_GetBuiltinId(&PyId_iter),
                                  it->it_seq, it->it_index);
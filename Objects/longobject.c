@@ -109,6 +109,75 @@ long_normalize(PyLongObject *v)
 #define MAX_LONG_DIGITS \
     ((PY_SSIZE_T_MAX - offsetof(PyLongObject, ob_digit))/sizeof(digit))
 
+#if PyLong_MAXFREELIST > 0
+static struct _Py_long_state *
+get_long_state(void)
+{
+    PyInterpreterState *interp = _PyInterpreterState_GET();
+    return &interp->long_state;
+}
+#endif
+
+void
+_PyLong_ClearFreeList(PyInterpreterState *interp)
+{
+#if PyLong_MAXFREELIST > 0
+    struct _Py_long_state *state = &interp->long_state;
+    while (state->numfree) {
+        PyObject_Free(state->free_list[--state->numfree]);
+    }
+#endif
+}
+
+/* Print summary info about the state of the optimized allocator */
+void
+_PyLong_DebugMallocStats(FILE *out)
+{
+#if PyLong_MAXFREELIST > 0
+    struct _Py_long_state *state = get_long_state();
+    _PyDebugAllocatorStats(out, "free PyLongObject",
+                           state->numfree, sizeof(PyLongObject));
+#endif
+}
+
+/* Allocate the memory of an integer of a single digit (or zero) */
+static PyLongObject *
+long_alloc_single_digit(void)
+{
+#if PyLong_MAXFREELIST > 0
+    struct _Py_long_state *state = get_long_state();
+#ifdef Py_DEBUG
+    // _PyLong_New() must not be called after _PyLong_Fini()
+    assert(state->numfree != -1);
+#endif
+    if (state->numfree) {
+        return state->free_list[--state->numfree];
+    }
+#endif
+    return PyObject_Malloc(sizeof(PyLongObject));
+}
+
+static void
+long_dealloc(PyObject *self)
+{
+#if PyLong_MAXFREELIST > 0
+    /* Integers of more digits may have been normalized to a single digit:
+       their memory block is larger, which is fine for reuse */
+    if (PyLong_CheckExact(self) && IS_MEDIUM_VALUE(self)) {
+        struct _Py_long_state *state = get_long_state();
+#ifdef Py_DEBUG
+        // long_dealloc() must not be called after _PyLong_Fini()
+        assert(state->numfree != -1);
+#endif
+        if (state->numfree < PyLong_MAXFREELIST) {
+            state->free_list[state->numfree++] = (PyLongObject *)self;
+            return;
+        }
+    }
+#endif
+    Py_TYPE(self)->tp_free(self);
+}
+
 PyLongObject *
 _PyLong_New(Py_ssize_t size)
 {
@@ -126,8 +195,13 @@ _PyLong_New(Py_ssize_t size)
        sizeof(PyVarObject) instead of the offsetof, but this risks being
        incorrect in the presence of padding between the PyVarObject header
        and the digits. */
-    result = PyObject_Malloc(offsetof(PyLongObject, ob_digit) +
-                             ndigits*sizeof(digit));
+    if (ndigits == 1) {
+        result = long_alloc_single_digit();
+    }
+    else {
+        result = PyObject_Malloc(offsetof(PyLongObject, ob_digit) +
+                                 ndigits*sizeof(digit));
+    }
     if (!result) {
         PyErr_NoMemory();
         return NULL;
@@ -167,8 +241,7 @@ _PyLong_FromMedium(sdigit x)
 {
     assert(!IS_SMALL_INT(x));
     assert(is_medium_int(x));
-    /* We could use a freelist here */
-    PyLongObject *v = PyObject_Malloc(sizeof(PyLongObject));
+    PyLongObject *v = long_alloc_single_digit();
     if (v == NULL) {
         PyErr_NoMemory();
         return NULL;
@@ -3156,13 +3229,11 @@ long_add(PyLongObject *a, PyLongObject *b)
 }
 
 
-static PyObject *
-long_sub(PyLongObject *a, PyLongObject *b)
+PyObject *
+_PyLong_Subtract(PyLongObject *a, PyLongObject *b)
 {
     PyLongObject *z;
 
-    CHECK_BINOP(a, b);
-
     if (IS_MEDIUM_VALUE(a) && IS_MEDIUM_VALUE(b)) {
         return _PyLong_FromSTwoDigits(medium_value(a) - medium_value(b));
     }
@@ -3187,6 +3258,13 @@ long_sub(PyLongObject *a, PyLongObject *b)
     return (PyObject *)z;
 }
 
+static PyObject *
+long_sub(PyLongObject *a, PyLongObject *b)
+{
+    CHECK_BINOP(a, b);
+    return _PyLong_Subtract(a, b);
+}
+
 /* Grade school multiplication, ignoring the signs.
  * Returns the absolute value of the product, or NULL if error.
  */
@@ -5745,7 +5823,7 @@ PyTypeObject PyLong_Type = {
     "int",                                      /* tp_name */
     offsetof(PyLongObject, ob_digit),           /* tp_basicsize */
     sizeof(digit),                              /* tp_itemsize */
-    0,                                          /* tp_dealloc */
+    long_dealloc,                               /* tp_dealloc */
     0,                                          /* tp_vectorcall_offset */
     0,                                          /* tp_getattr */
     0,                                          /* tp_setattr */
@@ -5831,7 +5909,7 @@ _PyLong_Init(PyInterpreterState *interp)
         for (Py_ssize_t i=0; i < _PY_NSMALLNEGINTS + _PY_NSMALLPOSINTS; i++) {
             sdigit ival = (sdigit)i - _PY_NSMALLNEGINTS;
             int size = (ival < 0) ? -1 : ((ival == 0) ? 0 : 1);
-            _PyRuntime.small_ints[i].ob_base.ob_base.ob_refcnt = 1;
+            _PyRuntime.small_ints[i].ob_base.ob_base.ob_refcnt = _Py_IMMORTAL_REFCNT;
             _PyRuntime.small_ints[i].ob_base.ob_base.ob_type = &PyLong_Type;
             _PyRuntime.small_ints[i].ob_base.ob_size = size;
             _PyRuntime.small_ints[i].ob_digit[0] = (digit)abs(ival);
@@ -5854,5 +5932,9 @@ _PyLong_InitTypes(void)
 void
 _PyLong_Fini(PyInterpreterState *interp)
 {
-    (void)interp;
+    _PyLong_ClearFreeList(interp);
+#if defined(Py_DEBUG) && PyLong_MAXFREELIST > 0
+    struct _Py_long_state *state = &interp->long_state;
+    state->numfree = -1;
+#endif
 }
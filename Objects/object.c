@@ -1741,7 +1741,7 @@ PyTypeObject _PyNone_Type = {
 
 PyObject _Py_NoneStruct = {
   _PyObject_EXTRA_INIT
-  1, &_PyNone_Type
+  _Py_IMMORTAL_REFCNT, &_PyNone_Type
 };
 
 /* NotImplemented is an object that can be used to signal that an
@@ -1842,7 +1842,7 @@ PyTypeObject _PyNotImplemented_Type = {
 
 PyObject _Py_NotImplementedStruct = {
     _PyObject_EXTRA_INIT
-    1, &_PyNotImplemented_Type
+    _Py_IMMORTAL_REFCNT, &_PyNotImplemented_Type
 };
 
 PyStatus
@@ -1950,6 +1950,7 @@ _PyTypes_Init(void)
     INIT_TYPE(_PyNamespace_Type);
     INIT_TYPE(_PyNone_Type);
     INIT_TYPE(_PyNotImplemented_Type);
+    INIT_TYPE(_PySharedBuffer_Type);
     INIT_TYPE(_PyWeakref_CallableProxyType);
     INIT_TYPE(_PyWeakref_ProxyType);
     INIT_TYPE(_PyWeakref_RefType);
@@ -1976,6 +1977,20 @@ _Py_NewReference(PyObject *op)
 }
 
 
+void
+_Py_SetImmortal(PyObject *op)
+{
+    if (_Py_IsImmortal(op)) {
+        return;
+    }
+#ifdef Py_REF_DEBUG
+    /* The references held so far will never be released. */
+    _Py_RefTotal -= Py_REFCNT(op);
+#endif
+    Py_SET_REFCNT(op, _Py_IMMORTAL_REFCNT);
+}
+
+
 #ifdef Py_TRACE_REFS
 void
 _Py_ForgetReference(PyObject *op)
@@ -2082,6 +2097,10 @@ _PyObject_DebugTypeStats(FILE *out)
     _PyFloat_DebugMallocStats(out);
     _PyFrame_DebugMallocStats(out);
     _PyList_DebugMallocStats(out);
+    _PyLong_DebugMallocStats(out);
+    _PyMethod_DebugMallocStats(out);
+    _PyRangeIter_DebugMallocStats(out);
+    _PySlice_DebugMallocStats(out);
     _PyTuple_DebugMallocStats(out);
 }
 
@@ -1,5 +1,7 @@
 #include "Python.h"
+#include "pycore_interp.h"         // PyInterpreterState.obmalloc
 #include "pycore_pymem.h"         // _PyTraceMalloc_Config
+#include "pycore_pystate.h"       // _PyThreadState_GET()
 
 #include <stdbool.h>
 #include <stdlib.h>               // malloc()
@@ -1143,36 +1145,6 @@ on that C doesn't insert any padding anywhere in a pool_header at or before
 the prevpool member.
 **************************************************************************** */
 
-#define PTA(x)  ((poolp )((uint8_t *)&(usedpools[2*(x)]) - 2*sizeof(block *)))
-#define PT(x)   PTA(x), PTA(x)
-
-static poolp usedpools[2 * ((NB_SMALL_SIZE_CLASSES + 7) / 8) * 8] = {
-    PT(0), PT(1), PT(2), PT(3), PT(4), PT(5), PT(6), PT(7)
-#if NB_SMALL_SIZE_CLASSES > 8
-    , PT(8), PT(9), PT(10), PT(11), PT(12), PT(13), PT(14), PT(15)
-#if NB_SMALL_SIZE_CLASSES > 16
-    , PT(16), PT(17), PT(18), PT(19), PT(20), PT(21), PT(22), PT(23)
-#if NB_SMALL_SIZE_CLASSES > 24
-    , PT(24), PT(25), PT(26), PT(27), PT(28), PT(29), PT(30), PT(31)
-#if NB_SMALL_SIZE_CLASSES > 32
-    , PT(32), PT(33), PT(34), PT(35), PT(36), PT(37), PT(38), PT(39)
-#if NB_SMALL_SIZE_CLASSES > 40
-    , PT(40), PT(41), PT(42), PT(43), PT(44), PT(45), PT(46), PT(47)
-#if NB_SMALL_SIZE_CLASSES > 48
-    , PT(48), PT(49), PT(50), PT(51), PT(52), PT(53), PT(54), PT(55)
-#if NB_SMALL_SIZE_CLASSES > 56
-    , PT(56), PT(57), PT(58), PT(59), PT(60), PT(61), PT(62), PT(63)
-#if NB_SMALL_SIZE_CLASSES > 64
-#error "NB_SMALL_SIZE_CLASSES should be less than 64"
-#endif /* NB_SMALL_SIZE_CLASSES > 64 */
-#endif /* NB_SMALL_SIZE_CLASSES > 56 */
-#endif /* NB_SMALL_SIZE_CLASSES > 48 */
-#endif /* NB_SMALL_SIZE_CLASSES > 40 */
-#endif /* NB_SMALL_SIZE_CLASSES > 32 */
-#endif /* NB_SMALL_SIZE_CLASSES > 24 */
-#endif /* NB_SMALL_SIZE_CLASSES > 16 */
-#endif /* NB_SMALL_SIZE_CLASSES >  8 */
-};
 
 /*==========================================================================
 Arena management.
@@ -1221,56 +1193,261 @@ with nfp free pools.  This is NULL if and only if there is no arena with
 nfp free pools in usable_arenas.
 */
 
-/* Array of objects used to track chunks of memory (arenas). */
-static struct arena_object* arenas = NULL;
-/* Number of slots currently allocated in the `arenas` vector. */
-static uint maxarenas = 0;
-
-/* The head of the singly-linked, NULL-terminated list of available
- * arena_objects.
+/* How many arena_objects do we initially allocate?
+ * 16 = can allocate 16 arenas = 16 * ARENA_SIZE = 4MB before growing the
+ * `arenas` vector.
  */
-static struct arena_object* unused_arena_objects = NULL;
+#define INITIAL_ARENA_OBJECTS 16
 
-/* The head of the doubly-linked, NULL-terminated at each end, list of
- * arena_objects associated with arenas that have pools available.
+/* The pools and arenas of the allocator.  All the interpreters share
+ * obmalloc_state_main, except in builds with isolated subinterpreters, where
+ * each subinterpreter has its own, so that the interpreters can allocate
+ * memory in parallel.  The arena map and the arena allocator remain shared.
  */
-static struct arena_object* usable_arenas = NULL;
+struct _obmalloc_state {
+    /* The pool table: see "Major obscurity" above */
+    poolp usedpools[2 * ((NB_SMALL_SIZE_CLASSES + 7) / 8) * 8];
 
-/* nfp2lasta[nfp] is the last arena in usable_arenas with nfp free pools */
-static struct arena_object* nfp2lasta[MAX_POOLS_IN_ARENA + 1] = { NULL };
+    /* Array of objects used to track chunks of memory (arenas). */
+    struct arena_object* arenas;
+    /* Number of slots currently allocated in the `arenas` vector. */
+    uint maxarenas;
 
-/* How many arena_objects do we initially allocate?
- * 16 = can allocate 16 arenas = 16 * ARENA_SIZE = 4MB before growing the
- * `arenas` vector.
+    /* The head of the singly-linked, NULL-terminated list of available
+     * arena_objects.
+     */
+    struct arena_object* unused_arena_objects;
+
+    /* The head of the doubly-linked, NULL-terminated at each end, list of
+     * arena_objects associated with arenas that have pools available.
+     */
+    struct arena_object* usable_arenas;
+
+    /* nfp2lasta[nfp] is the last arena in usable_arenas with nfp free pools */
+    struct arena_object* nfp2lasta[MAX_POOLS_IN_ARENA + 1];
+
+    /* Number of arenas allocated that haven't been free()'d. */
+    size_t narenas_currently_allocated;
+
+    /* Total number of times malloc() called to allocate an arena. */
+    size_t ntimes_arena_allocated;
+    /* High water mark (max value ever seen) for narenas_currently_allocated. */
+    size_t narenas_highwater;
+
+    /* Number of blocks too large for pymalloc, given to the raw allocator */
+    Py_ssize_t raw_allocated_blocks;
+};
+
+#define PTA(x)  ((poolp )((uint8_t *)&(obmalloc_state_main.usedpools[2*(x)]) - 2*sizeof(block *)))
+#define PT(x)   PTA(x), PTA(x)
+
+static struct _obmalloc_state obmalloc_state_main = {
+    .usedpools = {
+        PT(0), PT(1), PT(2), PT(3), PT(4), PT(5), PT(6), PT(7)
+#if NB_SMALL_SIZE_CLASSES > 8
+        , PT(8), PT(9), PT(10), PT(11), PT(12), PT(13), PT(14), PT(15)
+#if NB_SMALL_SIZE_CLASSES > 16
+        , PT(16), PT(17), PT(18), PT(19), PT(20), PT(21), PT(22), PT(23)
+#if NB_SMALL_SIZE_CLASSES > 24
+        , PT(24), PT(25), PT(26), PT(27), PT(28), PT(29), PT(30), PT(31)
+#if NB_SMALL_SIZE_CLASSES > 32
+        , PT(32), PT(33), PT(34), PT(35), PT(36), PT(37), PT(38), PT(39)
+#if NB_SMALL_SIZE_CLASSES > 40
+        , PT(40), PT(41), PT(42), PT(43), PT(44), PT(45), PT(46), PT(47)
+#if NB_SMALL_SIZE_CLASSES > 48
+        , PT(48), PT(49), PT(50), PT(51), PT(52), PT(53), PT(54), PT(55)
+#if NB_SMALL_SIZE_CLASSES > 56
+        , PT(56), PT(57), PT(58), PT(59), PT(60), PT(61), PT(62), PT(63)
+#if NB_SMALL_SIZE_CLASSES > 64
+#error "NB_SMALL_SIZE_CLASSES should be less than 64"
+#endif /* NB_SMALL_SIZE_CLASSES > 64 */
+#endif /* NB_SMALL_SIZE_CLASSES > 56 */
+#endif /* NB_SMALL_SIZE_CLASSES > 48 */
+#endif /* NB_SMALL_SIZE_CLASSES > 40 */
+#endif /* NB_SMALL_SIZE_CLASSES > 32 */
+#endif /* NB_SMALL_SIZE_CLASSES > 24 */
+#endif /* NB_SMALL_SIZE_CLASSES > 16 */
+#endif /* NB_SMALL_SIZE_CLASSES >  8 */
+    },
+};
+
+#undef PTA
+#undef PT
+
+/* Return the allocator state of the current interpreter */
+static inline struct _obmalloc_state *
+get_state(void)
+{
+#ifdef EXPERIMENTAL_ISOLATED_SUBINTERPRETERS
+    PyThreadState *tstate = _PyThreadState_GET();
+    if (tstate != NULL && tstate->interp->obmalloc != NULL) {
+        return tstate->interp->obmalloc;
+    }
+#endif
+    return &obmalloc_state_main;
+}
+
+/* The functions using the state get it once, in a local variable */
+#define usedpools (state->usedpools)
+#define allarenas (state->arenas)
+#define maxarenas (state->maxarenas)
+#define unused_arena_objects (state->unused_arena_objects)
+#define usable_arenas (state->usable_arenas)
+#define nfp2lasta (state->nfp2lasta)
+#define narenas_currently_allocated (state->narenas_currently_allocated)
+#define ntimes_arena_allocated (state->ntimes_arena_allocated)
+#define narenas_highwater (state->narenas_highwater)
+#define raw_allocated_blocks (state->raw_allocated_blocks)
+
+#ifdef EXPERIMENTAL_ISOLATED_SUBINTERPRETERS
+/* Serialize the changes to the arena map and the calls to the arena
+ * allocator, which all the interpreters share.  The lock doesn't exist yet
+ * when the runtime is being initialized, in a single thread. */
+#define ARENAS_LOCK() \
+    if (_PyRuntime.obmalloc_mutex != NULL) { \
+        PyThread_acquire_lock(_PyRuntime.obmalloc_mutex, WAIT_LOCK); \
+    }
+#define ARENAS_UNLOCK() \
+    if (_PyRuntime.obmalloc_mutex != NULL) { \
+        PyThread_release_lock(_PyRuntime.obmalloc_mutex); \
+    }
+#else
+#define ARENAS_LOCK()
+#define ARENAS_UNLOCK()
+#endif
+
+/*==========================================================================*/
+/* Per-thread caches of free blocks.
+ *
+ * Each thread state has a cache of the blocks its thread freed, with a list
+ * per size class, and the thread allocates from it first.  Neither path
+ * writes to the pool headers or to usedpools, which other threads use too.
+ * A size class holds at most THREAD_CACHE_BYTES bytes of blocks: when it is
+ * full, the older half of its blocks goes back to their pools at once.
+ *
+ * The blocks of a cache count as allocated for their pools, so a cache can
+ * keep an arena alive; PyThreadState_Clear() and _PyObject_TrimMemory()
+ * give the blocks back to the pools.
  */
-#define INITIAL_ARENA_OBJECTS 16
+#define THREAD_CACHE_BYTES      4096
+
+struct _PyObject_ThreadCache {
+    block *free[NB_SMALL_SIZE_CLASSES];
+    uint count[NB_SMALL_SIZE_CLASSES];
+};
+
+static inline struct _PyObject_ThreadCache *
+current_thread_cache(void)
+{
+    PyThreadState *tstate = _PyThreadState_GET();
+    return tstate != NULL ? tstate->obmalloc_cache : NULL;
+}
+
+static void flush_thread_cache(struct _PyObject_ThreadCache *cache,
+                               uint size, uint keep);
+
+struct _PyObject_ThreadCache *
+_PyObject_NewThreadCache(void)
+{
+    /* Before the allocators are set up, or with another allocator than
+       pymalloc, the thread has no cache */
+    if (!_PyMem_PymallocEnabled()) {
+        return NULL;
+    }
+    return PyMem_RawCalloc(1, sizeof(struct _PyObject_ThreadCache));
+}
+
+/* Give the blocks of the cache of a thread state back to the pools, and
+ * delete the cache.  Must be called with the GIL held. */
+void
+_PyObject_ClearThreadCache(PyThreadState *tstate)
+{
+    struct _PyObject_ThreadCache *cache = tstate->obmalloc_cache;
+    if (cache == NULL) {
+        return;
+    }
+    tstate->obmalloc_cache = NULL;
+    for (uint i = 0; i < NB_SMALL_SIZE_CLASSES; i++) {
+        flush_thread_cache(cache, i, 0);
+    }
+    PyMem_RawFree(cache);
+}
 
-/* Number of arenas allocated that haven't been free()'d. */
-static size_t narenas_currently_allocated = 0;
+/* Call func on the cache of each thread state that has one.  The lists of
+ * thread states are locked, since threads may delete their thread state
+ * without holding the GIL.  With isolated subinterpreters, only the threads
+ * of the current interpreter share its allocator state. */
+static void
+foreach_thread_cache(void (*func)(struct _PyObject_ThreadCache *, void *),
+                     void *arg)
+{
+    PyThread_type_lock mutex = _PyRuntime.interpreters.mutex;
+    if (mutex != NULL) {
+        PyThread_acquire_lock(mutex, WAIT_LOCK);
+    }
+#ifdef EXPERIMENTAL_ISOLATED_SUBINTERPRETERS
+    PyThreadState *current = _PyThreadState_GET();
+    PyInterpreterState *interp = current != NULL ? current->interp : NULL;
+    for (; interp != NULL; interp = NULL) {
+#else
+    PyInterpreterState *interp = PyInterpreterState_Head();
+    for (; interp != NULL; interp = PyInterpreterState_Next(interp)) {
+#endif
+        PyThreadState *tstate = PyInterpreterState_ThreadHead(interp);
+        for (; tstate != NULL; tstate = PyThreadState_Next(tstate)) {
+            if (tstate->obmalloc_cache != NULL) {
+                func(tstate->obmalloc_cache, arg);
+            }
+        }
+    }
+    if (mutex != NULL) {
+        PyThread_release_lock(mutex);
+    }
+}
+
+static void
+count_cached_blocks(struct _PyObject_ThreadCache *cache, void *arg)
+{
+    for (uint i = 0; i < NB_SMALL_SIZE_CLASSES; i++) {
+        *(size_t *)arg += cache->count[i];
+    }
+}
 
-/* Total number of times malloc() called to allocate an arena. */
-static size_t ntimes_arena_allocated = 0;
-/* High water mark (max value ever seen) for narenas_currently_allocated. */
-static size_t narenas_highwater = 0;
+static void
+flush_cached_blocks(struct _PyObject_ThreadCache *cache, void *arg)
+{
+    for (uint i = 0; i < NB_SMALL_SIZE_CLASSES; i++) {
+        flush_thread_cache(cache, i, 0);
+    }
+}
 
-static Py_ssize_t raw_allocated_blocks;
+/* Return the number of blocks in the caches of all the threads */
+static size_t
+blocks_in_thread_caches(void)
+{
+    size_t n = 0;
+    foreach_thread_cache(count_cached_blocks, &n);
+    return n;
+}
 
 Py_ssize_t
 _Py_GetAllocatedBlocks(void)
 {
-    Py_ssize_t n = raw_allocated_blocks;
+    struct _obmalloc_state *state = get_state();
+    /* The blocks of the thread caches are free for their owners */
+    Py_ssize_t n = raw_allocated_blocks - (Py_ssize_t)blocks_in_thread_caches();
     /* add up allocated blocks for used pools */
     for (uint i = 0; i < maxarenas; ++i) {
         /* Skip arenas which are not allocated. */
-        if (arenas[i].address == 0) {
+        if (allarenas[i].address == 0) {
             continue;
         }
 
-        uintptr_t base = (uintptr_t)_Py_ALIGN_UP(arenas[i].address, POOL_SIZE);
+        uintptr_t base = (uintptr_t)_Py_ALIGN_UP(allarenas[i].address, POOL_SIZE);
 
         /* visit every pool in the arena */
-        assert(base <= (uintptr_t) arenas[i].pool_address);
-        for (; base < (uintptr_t) arenas[i].pool_address; base += POOL_SIZE) {
+        assert(base <= (uintptr_t) allarenas[i].pool_address);
+        for (; base < (uintptr_t) allarenas[i].pool_address; base += POOL_SIZE) {
             poolp p = (poolp)base;
             n += p->ref.count;
         }
@@ -1278,6 +1455,86 @@ _Py_GetAllocatedBlocks(void)
     return n;
 }
 
+/* Give the memory of the free pools back to the system, except for the
+ * first page of each pool: the pool header there links the pool in the
+ * free list of its arena.  A trimmed pool gets DUMMY_SIZE_IDX as size class,
+ * so that it is initialized again when it is used, and it isn't trimmed
+ * twice.  Return the number of bytes released.
+ */
+size_t
+_PyObject_TrimMemory(void)
+{
+    struct _obmalloc_state *state = get_state();
+    size_t released = 0;
+#if defined(ARENAS_USE_MMAP) && defined(MADV_DONTNEED)
+    static size_t page_size = 0;
+    if (page_size == 0) {
+        page_size = (size_t)sysconf(_SC_PAGESIZE);
+    }
+    if (page_size >= POOL_SIZE) {
+        return 0;
+    }
+    /* Let the pools of the cached blocks become free */
+    foreach_thread_cache(flush_cached_blocks, NULL);
+    for (uint i = 0; i < maxarenas; ++i) {
+        /* Skip arenas which are not allocated. */
+        if (allarenas[i].address == 0) {
+            continue;
+        }
+        for (poolp p = allarenas[i].freepools; p != NULL; p = p->nextpool) {
+            if (p->szidx == DUMMY_SIZE_IDX) {
+                continue;
+            }
+            if (madvise((block *)p + page_size, POOL_SIZE - page_size,
+                        MADV_DONTNEED) == 0)
+            {
+                p->szidx = DUMMY_SIZE_IDX;
+                released += POOL_SIZE - page_size;
+            }
+        }
+    }
+#endif
+    return released;
+}
+
+#ifdef EXPERIMENTAL_ISOLATED_SUBINTERPRETERS
+/* Create the allocator state of a subinterpreter */
+int
+_PyObject_InitAllocatorState(PyInterpreterState *interp)
+{
+    struct _obmalloc_state *state = PyMem_RawCalloc(1, sizeof(*state));
+    if (state == NULL) {
+        return -1;
+    }
+    /* Each pair of usedpools[] entries starts as an empty pool list: see
+       the PTA() macro above */
+    for (uint i = 0; i < NB_SMALL_SIZE_CLASSES; i++) {
+        poolp head = (poolp)((uint8_t *)&usedpools[2*i] - 2*sizeof(block *));
+        usedpools[2*i] = usedpools[2*i+1] = head;
+    }
+    interp->obmalloc = state;
+    return 0;
+}
+
+/* Delete the allocator state of a subinterpreter.  Its arenas are only
+   released once all their blocks are free: if some objects of the
+   interpreter leaked, the state leaks with them. */
+void
+_PyObject_FiniAllocatorState(PyInterpreterState *interp)
+{
+    struct _obmalloc_state *state = interp->obmalloc;
+    if (state == NULL) {
+        return;
+    }
+    interp->obmalloc = NULL;
+    if (narenas_currently_allocated != 0) {
+        return;
+    }
+    PyMem_RawFree(allarenas);
+    PyMem_RawFree(state);
+}
+#endif
+
 #if WITH_PYMALLOC_RADIX_TREE
 /*==========================================================================*/
 /* radix tree for tracking arena usage.  If enabled, used to implement
@@ -1552,6 +1809,245 @@ arena_map_is_used(block *p)
 #endif /* WITH_PYMALLOC_RADIX_TREE */
 
 
+/*==========================================================================*/
+/* Huge-page arenas.
+ *
+ * If PYTHONMALLOCARENA is "hugepages" or "hugepages_numa", the arenas are
+ * carved out of chunks of ARENA_CHUNK_SIZE bytes, aligned on huge page
+ * boundaries and backed by huge pages: pages of the hugetlbfs pool
+ * (MAP_HUGETLB) if it has enough free ones, else transparent huge pages
+ * (MADV_HUGEPAGE).  A few huge pages then map all the hot objects, instead
+ * of thousands of small pages.
+ *
+ * With "hugepages_numa", the memory of a chunk is bound to the NUMA node of
+ * the thread that allocated it (MPOL_PREFERRED: the kernel falls back to the
+ * other nodes when the node is full), and new arenas are only taken from the
+ * chunks of the node of the calling thread.
+ */
+#if defined(ARENAS_USE_MMAP) && defined(__linux__) \
+    && (defined(MAP_HUGETLB) || defined(MADV_HUGEPAGE))
+#define WITH_ARENA_CHUNKS
+#endif
+
+#ifdef WITH_ARENA_CHUNKS
+#include <sys/syscall.h>          // SYS_mbind, SYS_getcpu
+#include <unistd.h>               // syscall()
+
+#define HUGE_PAGE_SIZE          (2 * 1024 * 1024)
+#define ARENA_CHUNK_SIZE        (16 * 1024 * 1024)
+#define ARENAS_IN_CHUNK         (ARENA_CHUNK_SIZE / ARENA_SIZE)
+#if ARENAS_IN_CHUNK > 64
+#   error "a chunk must not hold more than 64 arenas"
+#endif
+#define ARENA_CHUNK_FULL        (~(uint64_t)0 >> (64 - ARENAS_IN_CHUNK))
+
+/* MPOL_PREFERRED of <numaif.h>, which comes with libnuma */
+#define ARENA_MPOL_PREFERRED    1
+/* Chunks are only bound to the nodes that fit in the node mask */
+#define ARENA_MAX_NUMA_NODES    (8 * sizeof(unsigned long))
+
+struct arena_chunk {
+    struct arena_chunk *next;
+    uintptr_t address;
+    /* bit i is set if the i-th arena of the chunk is allocated */
+    uint64_t used;
+    /* the chunk is backed by the hugetlbfs pool */
+    int hugetlb;
+    /* the NUMA node the chunk is bound to, or -1 */
+    int node;
+};
+
+static struct arena_chunk *arena_chunks = NULL;
+static int arena_chunks_numa = 0;
+
+/* Return the NUMA node of the CPU the calling thread runs on, or -1 */
+static int
+current_numa_node(void)
+{
+#ifdef SYS_getcpu
+    unsigned int cpu, node;
+    if (syscall(SYS_getcpu, &cpu, &node, NULL) == 0
+        && node < ARENA_MAX_NUMA_NODES)
+    {
+        return (int)node;
+    }
+#endif
+    return -1;
+}
+
+/* Map a new chunk, return NULL if out of memory */
+static void *
+arena_chunk_map(int *hugetlb)
+{
+    void *ptr;
+#ifdef MAP_HUGETLB
+    ptr = mmap(NULL, ARENA_CHUNK_SIZE, PROT_READ|PROT_WRITE,
+               MAP_PRIVATE|MAP_ANONYMOUS|MAP_HUGETLB, -1, 0);
+    if (ptr != MAP_FAILED) {
+        *hugetlb = 1;
+        return ptr;
+    }
+#endif
+    *hugetlb = 0;
+    /* Map one more huge page, and trim the mapping so that the chunk
+       starts on a huge page boundary */
+    size_t size = ARENA_CHUNK_SIZE + HUGE_PAGE_SIZE;
+    ptr = mmap(NULL, size, PROT_READ|PROT_WRITE,
+               MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+    if (ptr == MAP_FAILED) {
+        return NULL;
+    }
+    uintptr_t start = (uintptr_t)_Py_ALIGN_UP(ptr, HUGE_PAGE_SIZE);
+    uintptr_t end = start + ARENA_CHUNK_SIZE;
+    if (start != (uintptr_t)ptr) {
+        munmap(ptr, start - (uintptr_t)ptr);
+    }
+    if (end != (uintptr_t)ptr + size) {
+        munmap((void *)end, (uintptr_t)ptr + size - end);
+    }
+#ifdef MADV_HUGEPAGE
+    (void)madvise((void *)start, ARENA_CHUNK_SIZE, MADV_HUGEPAGE);
+#endif
+    return (void *)start;
+}
+
+static void *
+_PyObject_ArenaChunkAlloc(void *ctx, size_t size)
+{
+    if (size != ARENA_SIZE) {
+        /* _PyObject_VirtualAlloc() */
+        return _PyObject_ArenaMmap(ctx, size);
+    }
+    int node = arena_chunks_numa ? current_numa_node() : -1;
+    struct arena_chunk *chunk;
+    for (chunk = arena_chunks; chunk != NULL; chunk = chunk->next) {
+        if (chunk->used != ARENA_CHUNK_FULL && chunk->node == node) {
+            break;
+        }
+    }
+    if (chunk == NULL) {
+        chunk = PyMem_RawMalloc(sizeof(struct arena_chunk));
+        if (chunk == NULL) {
+            return NULL;
+        }
+        void *address = arena_chunk_map(&chunk->hugetlb);
+        if (address == NULL) {
+            PyMem_RawFree(chunk);
+            return NULL;
+        }
+#ifdef SYS_mbind
+        if (node >= 0) {
+            unsigned long nodemask = 1UL << node;
+            /* The kernel counts one more node than the mask has */
+            (void)syscall(SYS_mbind, address, ARENA_CHUNK_SIZE,
+                          ARENA_MPOL_PREFERRED, &nodemask,
+                          ARENA_MAX_NUMA_NODES + 1, 0);
+        }
+#endif
+        chunk->address = (uintptr_t)address;
+        chunk->used = 0;
+        chunk->node = node;
+        chunk->next = arena_chunks;
+        arena_chunks = chunk;
+    }
+    int i = 0;
+    while (chunk->used & ((uint64_t)1 << i)) {
+        i++;
+    }
+    chunk->used |= (uint64_t)1 << i;
+    return (void *)(chunk->address + (uintptr_t)i * ARENA_SIZE);
+}
+
+static void
+_PyObject_ArenaChunkFree(void *ctx, void *ptr, size_t size)
+{
+    if (size != ARENA_SIZE) {
+        _PyObject_ArenaMunmap(ctx, ptr, size);
+        return;
+    }
+    struct arena_chunk **link = &arena_chunks, *chunk;
+    while ((chunk = *link) != NULL
+           && (uintptr_t)ptr - chunk->address >= ARENA_CHUNK_SIZE)
+    {
+        link = &chunk->next;
+    }
+    if (chunk == NULL) {
+        /* Mapped before the allocator was selected */
+        _PyObject_ArenaMunmap(ctx, ptr, size);
+        return;
+    }
+    int i = (int)(((uintptr_t)ptr - chunk->address) / ARENA_SIZE);
+    assert(chunk->used & ((uint64_t)1 << i));
+    chunk->used &= ~((uint64_t)1 << i);
+    if (chunk->used == 0) {
+        *link = chunk->next;
+        munmap((void *)chunk->address, ARENA_CHUNK_SIZE);
+        PyMem_RawFree(chunk);
+    }
+    else if (!chunk->hugetlb) {
+        /* Give the pages back: this splits the huge page the arena is
+           part of, but the next arena in its place starts empty anyway */
+        (void)madvise(ptr, ARENA_SIZE, MADV_DONTNEED);
+    }
+}
+#endif /* WITH_ARENA_CHUNKS */
+
+/* Select the arena allocator named by PYTHONMALLOCARENA.  Called before
+ * allocating the first arena. */
+static void
+set_arena_allocator(void)
+{
+#ifdef WITH_ARENA_CHUNKS
+    const char *opt = Py_GETENV("PYTHONMALLOCARENA");
+    if (opt == NULL) {
+        return;
+    }
+    /* Don't replace an allocator set by PyObject_SetArenaAllocator() */
+    if (_PyObject_Arena.alloc != _PyObject_ArenaMmap) {
+        return;
+    }
+    if (strcmp(opt, "hugepages") == 0) {
+        arena_chunks_numa = 0;
+    }
+    else if (strcmp(opt, "hugepages_numa") == 0) {
+        arena_chunks_numa = 1;
+    }
+    else {
+        /* "default" and unknown names */
+        return;
+    }
+    _PyObject_Arena.alloc = _PyObject_ArenaChunkAlloc;
+    _PyObject_Arena.free = _PyObject_ArenaChunkFree;
+#endif
+}
+
+/* Return the name of the arena allocator, for _PyObject_DebugMallocStats() */
+static const char *
+arena_allocator_name(void)
+{
+#ifdef WITH_ARENA_CHUNKS
+    if (_PyObject_Arena.alloc == _PyObject_ArenaChunkAlloc) {
+        return arena_chunks_numa ? "hugepages_numa" : "hugepages";
+    }
+#endif
+#ifdef MS_WINDOWS
+    if (_PyObject_Arena.alloc == _PyObject_ArenaVirtualAlloc) {
+        return "default";
+    }
+#elif defined(ARENAS_USE_MMAP)
+    if (_PyObject_Arena.alloc == _PyObject_ArenaMmap) {
+        return "default";
+    }
+#else
+    if (_PyObject_Arena.alloc == _PyObject_ArenaMalloc) {
+        return "default";
+    }
+#endif
+    return "custom";
+}
+
+/*==========================================================================*/
+
 /* Allocate a new arena.  If we run out of memory, return NULL.  Else
  * allocate a new arena, and return the address of an arena_object
  * describing the new arena.  It's expected that the caller will set
@@ -1560,6 +2056,7 @@ arena_map_is_used(block *p)
 static struct arena_object*
 new_arena(void)
 {
+    struct _obmalloc_state *state = get_state();
     struct arena_object* arenaobj;
     uint excess;        /* number of bytes above pool alignment */
     void *address;
@@ -1568,6 +2065,7 @@ new_arena(void)
     if (debug_stats == -1) {
         const char *opt = Py_GETENV("PYTHONMALLOCSTATS");
         debug_stats = (opt != NULL && *opt != '\0');
+        set_arena_allocator();
     }
     if (debug_stats)
         _PyObject_DebugMallocStats(stderr);
@@ -1584,14 +2082,14 @@ new_arena(void)
         if (numarenas <= maxarenas)
             return NULL;                /* overflow */
 #if SIZEOF_SIZE_T <= SIZEOF_INT
-        if (numarenas > SIZE_MAX / sizeof(*arenas))
+        if (numarenas > SIZE_MAX / sizeof(*allarenas))
             return NULL;                /* overflow */
 #endif
-        nbytes = numarenas * sizeof(*arenas);
-        arenaobj = (struct arena_object *)PyMem_RawRealloc(arenas, nbytes);
+        nbytes = numarenas * sizeof(*allarenas);
+        arenaobj = (struct arena_object *)PyMem_RawRealloc(allarenas, nbytes);
         if (arenaobj == NULL)
             return NULL;
-        arenas = arenaobj;
+        allarenas = arenaobj;
 
         /* We might need to fix pointers that were copied.  However,
          * new_arena only gets called when all the pages in the
@@ -1604,13 +2102,13 @@ new_arena(void)
 
         /* Put the new arenas on the unused_arena_objects list. */
         for (i = maxarenas; i < numarenas; ++i) {
-            arenas[i].address = 0;              /* mark as unassociated */
-            arenas[i].nextarena = i < numarenas - 1 ?
-                                   &arenas[i+1] : NULL;
+            allarenas[i].address = 0;              /* mark as unassociated */
+            allarenas[i].nextarena = i < numarenas - 1 ?
+                                   &allarenas[i+1] : NULL;
         }
 
         /* Update globals. */
-        unused_arena_objects = &arenas[maxarenas];
+        unused_arena_objects = &allarenas[maxarenas];
         maxarenas = numarenas;
     }
 
@@ -1619,6 +2117,7 @@ new_arena(void)
     arenaobj = unused_arena_objects;
     unused_arena_objects = arenaobj->nextarena;
     assert(arenaobj->address == 0);
+    ARENAS_LOCK();
     address = _PyObject_Arena.alloc(_PyObject_Arena.ctx, ARENA_SIZE);
 #if WITH_PYMALLOC_RADIX_TREE
     if (address != NULL) {
@@ -1629,6 +2128,7 @@ new_arena(void)
         }
     }
 #endif
+    ARENAS_UNLOCK();
     if (address == NULL) {
         /* The allocation failed: return NULL after putting the
          * arenaobj back.
@@ -1750,6 +2250,7 @@ static bool _Py_NO_SANITIZE_ADDRESS
             _Py_NO_SANITIZE_MEMORY
 address_in_range(void *p, poolp pool)
 {
+    struct _obmalloc_state *state = get_state();
     // Since address_in_range may be reading from memory which was not allocated
     // by Python, it is important that pool->arenaindex is read only once, as
     // another thread may be concurrently modifying the value without holding
@@ -1757,8 +2258,8 @@ address_in_range(void *p, poolp pool)
     // only once.
     uint arenaindex = *((volatile uint *)&pool->arenaindex);
     return arenaindex < maxarenas &&
-        (uintptr_t)p - arenas[arenaindex].address < ARENA_SIZE &&
-        arenas[arenaindex].address != 0;
+        (uintptr_t)p - allarenas[arenaindex].address < ARENA_SIZE &&
+        allarenas[arenaindex].address != 0;
 }
 
 #endif /* !WITH_PYMALLOC_RADIX_TREE */
@@ -1792,6 +2293,7 @@ pymalloc_pool_extend(poolp pool, uint size)
 static void*
 allocate_from_new_pool(uint size)
 {
+    struct _obmalloc_state *state = get_state();
     /* There isn't a pool of the right size class immediately
      * available:  use a free pool.
      */
@@ -1865,8 +2367,8 @@ allocate_from_new_pool(uint size)
         pool = (poolp)usable_arenas->pool_address;
         assert((block*)pool <= (block*)usable_arenas->address +
                                  ARENA_SIZE - POOL_SIZE);
-        pool->arenaindex = (uint)(usable_arenas - arenas);
-        assert(&arenas[pool->arenaindex] == usable_arenas);
+        pool->arenaindex = (uint)(usable_arenas - allarenas);
+        assert(&allarenas[pool->arenaindex] == usable_arenas);
         pool->szidx = DUMMY_SIZE_IDX;
         usable_arenas->pool_address += POOL_SIZE;
         --usable_arenas->nfreepools;
@@ -1928,6 +2430,7 @@ allocate_from_new_pool(uint size)
 static inline void*
 pymalloc_alloc(void *ctx, size_t nbytes)
 {
+    struct _obmalloc_state *state = get_state();
 #ifdef WITH_VALGRIND
     if (UNLIKELY(running_on_valgrind == -1)) {
         running_on_valgrind = RUNNING_ON_VALGRIND;
@@ -1945,9 +2448,17 @@ pymalloc_alloc(void *ctx, size_t nbytes)
     }
 
     uint size = (uint)(nbytes - 1) >> ALIGNMENT_SHIFT;
-    poolp pool = usedpools[size + size];
     block *bp;
 
+    struct _PyObject_ThreadCache *cache = current_thread_cache();
+    if (cache != NULL && cache->free[size] != NULL) {
+        bp = cache->free[size];
+        cache->free[size] = *(block **)bp;
+        cache->count[size]--;
+        return (void *)bp;
+    }
+
+    poolp pool = usedpools[size + size];
     if (LIKELY(pool != pool->nextpool)) {
         /*
          * There is a used pool for this size class.
@@ -1983,6 +2494,7 @@ _PyObject_Malloc(void *ctx, size_t nbytes)
 
     ptr = PyMem_RawMalloc(nbytes);
     if (ptr != NULL) {
+        struct _obmalloc_state *state = get_state();
         raw_allocated_blocks++;
     }
     return ptr;
@@ -2003,6 +2515,7 @@ _PyObject_Calloc(void *ctx, size_t nelem, size_t elsize)
 
     ptr = PyMem_RawCalloc(nelem, elsize);
     if (ptr != NULL) {
+        struct _obmalloc_state *state = get_state();
         raw_allocated_blocks++;
     }
     return ptr;
@@ -2012,6 +2525,7 @@ _PyObject_Calloc(void *ctx, size_t nelem, size_t elsize)
 static void
 insert_to_usedpool(poolp pool)
 {
+    struct _obmalloc_state *state = get_state();
     assert(pool->ref.count > 0);            /* else the pool is empty */
 
     uint size = pool->szidx;
@@ -2028,6 +2542,7 @@ insert_to_usedpool(poolp pool)
 static void
 insert_to_freepool(poolp pool)
 {
+    struct _obmalloc_state *state = get_state();
     poolp next = pool->nextpool;
     poolp prev = pool->prevpool;
     next->prevpool = prev;
@@ -2036,7 +2551,7 @@ insert_to_freepool(poolp pool)
     /* Link the pool to freepools.  This is a singly-linked
      * list, and pool->prevpool isn't used there.
      */
-    struct arena_object *ao = &arenas[pool->arenaindex];
+    struct arena_object *ao = &allarenas[pool->arenaindex];
     pool->nextpool = ao->freepools;
     ao->freepools = pool;
     uint nf = ao->nfreepools;
@@ -2107,6 +2622,7 @@ insert_to_freepool(poolp pool)
         ao->nextarena = unused_arena_objects;
         unused_arena_objects = ao;
 
+        ARENAS_LOCK();
 #if WITH_PYMALLOC_RADIX_TREE
         /* mark arena region as not under control of obmalloc */
         arena_map_mark_used(ao->address, 0);
@@ -2115,6 +2631,7 @@ insert_to_freepool(poolp pool)
         /* Free the entire arena. */
         _PyObject_Arena.free(_PyObject_Arena.ctx,
                              (void *)ao->address, ARENA_SIZE);
+        ARENAS_UNLOCK();
         ao->address = 0;                        /* mark unassociated */
         --narenas_currently_allocated;
 
@@ -2192,26 +2709,10 @@ insert_to_freepool(poolp pool)
            || ao->prevarena->nextarena == ao);
 }
 
-/* Free a memory block allocated by pymalloc_alloc().
-   Return 1 if it was freed.
-   Return 0 if the block was not allocated by pymalloc_alloc(). */
-static inline int
-pymalloc_free(void *ctx, void *p)
+/* Give the block p back to its pool */
+static void
+free_block(poolp pool, block *p)
 {
-    assert(p != NULL);
-
-#ifdef WITH_VALGRIND
-    if (UNLIKELY(running_on_valgrind > 0)) {
-        return 0;
-    }
-#endif
-
-    poolp pool = POOL_ADDR(p);
-    if (UNLIKELY(!address_in_range(p, pool))) {
-        return 0;
-    }
-    /* We allocated this address. */
-
     /* Link p to the start of the pool's freeblock list.  Since
      * the pool had at least the p block outstanding, the pool
      * wasn't empty (so it's already in a usedpools[] list, or
@@ -2232,7 +2733,7 @@ pymalloc_free(void *ctx, void *p)
          * blocks of the same size class.
          */
         insert_to_usedpool(pool);
-        return 1;
+        return;
     }
 
     /* freeblock wasn't NULL, so the pool wasn't full,
@@ -2240,7 +2741,7 @@ pymalloc_free(void *ctx, void *p)
      */
     if (LIKELY(pool->ref.count != 0)) {
         /* pool isn't empty:  leave it in usedpools */
-        return 1;
+        return;
     }
 
     /* Pool is now empty:  unlink from usedpools, and
@@ -2249,6 +2750,84 @@ pymalloc_free(void *ctx, void *p)
      * (being not referenced, they are perhaps paged out).
      */
     insert_to_freepool(pool);
+}
+
+/* Give all but the "keep" most recently freed blocks of a size class of a
+ * thread cache back to their pools. */
+static void
+flush_thread_cache(struct _PyObject_ThreadCache *cache, uint size, uint keep)
+{
+    block **link = &cache->free[size];
+    for (uint i = 0; i < keep; i++) {
+        link = (block **)*link;
+    }
+    block *bp = *link;
+    *link = NULL;
+    while (bp != NULL) {
+        block *next = *(block **)bp;
+        free_block(POOL_ADDR(bp), bp);
+        bp = next;
+    }
+    cache->count[size] = keep;
+}
+
+#ifdef EXPERIMENTAL_ISOLATED_SUBINTERPRETERS
+/* Return true if the pool of the block p belongs to the allocator state of
+   the current interpreter */
+static inline bool
+pool_is_owned(void *p, poolp pool)
+{
+    struct _obmalloc_state *state = get_state();
+    uint arenaindex = pool->arenaindex;
+    return arenaindex < maxarenas &&
+        (uintptr_t)p - allarenas[arenaindex].address < ARENA_SIZE;
+}
+#endif
+
+/* Free a memory block allocated by pymalloc_alloc().
+   Return 1 if it was freed.
+   Return 0 if the block was not allocated by pymalloc_alloc(). */
+static inline int
+pymalloc_free(void *ctx, void *p)
+{
+    assert(p != NULL);
+
+#ifdef WITH_VALGRIND
+    if (UNLIKELY(running_on_valgrind > 0)) {
+        return 0;
+    }
+#endif
+
+    poolp pool = POOL_ADDR(p);
+    if (UNLIKELY(!address_in_range(p, pool))) {
+        return 0;
+    }
+    /* We allocated this address. */
+#ifdef EXPERIMENTAL_ISOLATED_SUBINTERPRETERS
+    if (UNLIKELY(!pool_is_owned(p, pool))) {
+        /* Objects shared by the interpreters, like the module dict copies
+           of Python/import.c, can be freed by another interpreter than the
+           one which allocated them.  The pools of the owner may be in use
+           in parallel: leak the block rather than corrupting them. */
+        return 1;
+    }
+#endif
+
+    struct _PyObject_ThreadCache *cache = current_thread_cache();
+    if (cache != NULL) {
+        uint size = pool->szidx;
+        if (UNLIKELY(cache->count[size] * INDEX2SIZE(size)
+                     >= THREAD_CACHE_BYTES))
+        {
+            flush_thread_cache(cache, size, cache->count[size] / 2);
+        }
+        *(block **)p = cache->free[size];
+        cache->free[size] = (block *)p;
+        cache->count[size]++;
+    }
+    else {
+        free_block(pool, (block *)p);
+    }
     return 1;
 }
 
@@ -2263,6 +2842,7 @@ _PyObject_Free(void *ctx, void *p)
 
     if (UNLIKELY(!pymalloc_free(ctx, p))) {
         /* pymalloc didn't allocate this address */
+        struct _obmalloc_state *state = get_state();
         PyMem_RawFree(p);
         raw_allocated_blocks--;
     }
@@ -2367,6 +2947,37 @@ _Py_GetAllocatedBlocks(void)
     return 0;
 }
 
+size_t
+_PyObject_TrimMemory(void)
+{
+    return 0;
+}
+
+struct _PyObject_ThreadCache *
+_PyObject_NewThreadCache(void)
+{
+    return NULL;
+}
+
+void
+_PyObject_ClearThreadCache(PyThreadState *tstate)
+{
+    assert(tstate->obmalloc_cache == NULL);
+}
+
+#ifdef EXPERIMENTAL_ISOLATED_SUBINTERPRETERS
+int
+_PyObject_InitAllocatorState(PyInterpreterState *interp)
+{
+    return 0;
+}
+
+void
+_PyObject_FiniAllocatorState(PyInterpreterState *interp)
+{
+}
+#endif
+
 #endif /* WITH_PYMALLOC */
 
 
@@ -2938,6 +3549,7 @@ pool_is_in_list(const poolp target, poolp list)
 int
 _PyObject_DebugMallocStats(FILE *out)
 {
+    struct _obmalloc_state *state = get_state();
     if (!_PyMem_PymallocEnabled()) {
         return 0;
     }
@@ -2954,6 +3566,8 @@ _PyObject_DebugMallocStats(FILE *out)
     size_t available_bytes = 0;
     /* # of free pools + pools not yet carved out of current arena */
     uint numfreepools = 0;
+    /* # of free pools given back to the system by _PyObject_TrimMemory() */
+    size_t numtrimmedpools = 0;
     /* # of bytes for arena alignment padding */
     size_t arena_alignment = 0;
     /* # of bytes in used and full pools used for pool_headers */
@@ -2981,14 +3595,14 @@ _PyObject_DebugMallocStats(FILE *out)
      */
     for (i = 0; i < maxarenas; ++i) {
         uint j;
-        uintptr_t base = arenas[i].address;
+        uintptr_t base = allarenas[i].address;
 
         /* Skip arenas which are not allocated. */
-        if (arenas[i].address == (uintptr_t)NULL)
+        if (allarenas[i].address == (uintptr_t)NULL)
             continue;
         narenas += 1;
 
-        numfreepools += arenas[i].nfreepools;
+        numfreepools += allarenas[i].nfreepools;
 
         /* round up to pool alignment */
         if (base & (uintptr_t)POOL_SIZE_MASK) {
@@ -2998,8 +3612,8 @@ _PyObject_DebugMallocStats(FILE *out)
         }
 
         /* visit every pool in the arena */
-        assert(base <= (uintptr_t) arenas[i].pool_address);
-        for (j = 0; base < (uintptr_t) arenas[i].pool_address;
+        assert(base <= (uintptr_t) allarenas[i].pool_address);
+        for (j = 0; base < (uintptr_t) allarenas[i].pool_address;
              ++j, base += POOL_SIZE) {
             poolp p = (poolp)base;
             const uint sz = p->szidx;
@@ -3008,8 +3622,9 @@ _PyObject_DebugMallocStats(FILE *out)
             if (p->ref.count == 0) {
                 /* currently unused */
 #ifdef Py_DEBUG
-                assert(pool_is_in_list(p, arenas[i].freepools));
+                assert(pool_is_in_list(p, allarenas[i].freepools));
 #endif
+                numtrimmedpools += (sz == DUMMY_SIZE_IDX);
                 continue;
             }
             ++numpools[sz];
@@ -3051,15 +3666,46 @@ _PyObject_DebugMallocStats(FILE *out)
         (void)printone(out, "# times object malloc called", serialno);
     }
 #endif
-    (void)printone(out, "# arenas allocated total", ntimes_arena_allocated);
-    (void)printone(out, "# arenas reclaimed", ntimes_arena_allocated - narenas);
-    (void)printone(out, "# arenas highwater mark", narenas_highwater);
-    (void)printone(out, "# arenas allocated current", narenas);
+    (void)printone(out, "# allarenas allocated total", ntimes_arena_allocated);
+    (void)printone(out, "# allarenas reclaimed", ntimes_arena_allocated - narenas);
+    (void)printone(out, "# allarenas highwater mark", narenas_highwater);
+    (void)printone(out, "# allarenas allocated current", narenas);
 
     PyOS_snprintf(buf, sizeof(buf),
-                  "%zu arenas * %d bytes/arena",
+                  "%zu allarenas * %d bytes/arena",
                   narenas, ARENA_SIZE);
     (void)printone(out, buf, narenas * ARENA_SIZE);
+    (void)printone(out, "# unused pools trimmed", numtrimmedpools);
+    (void)printone(out, "# blocks in thread caches",
+                   blocks_in_thread_caches());
+    fprintf(out, "%-35s=%21s\n", "arena allocator", arena_allocator_name());
+#ifdef WITH_ARENA_CHUNKS
+    if (arena_chunks != NULL) {
+        size_t nchunks = 0, nhugetlb = 0;
+        size_t pernode[ARENA_MAX_NUMA_NODES] = {0};
+        for (struct arena_chunk *chunk = arena_chunks; chunk != NULL;
+             chunk = chunk->next)
+        {
+            nchunks++;
+            nhugetlb += chunk->hugetlb;
+            if (chunk->node >= 0) {
+                pernode[chunk->node]++;
+            }
+        }
+        PyOS_snprintf(buf, sizeof(buf),
+                      "%zu chunks * %d bytes/chunk",
+                      nchunks, ARENA_CHUNK_SIZE);
+        (void)printone(out, buf, nchunks * ARENA_CHUNK_SIZE);
+        (void)printone(out, "# arena chunks in hugetlb pages", nhugetlb);
+        for (i = 0; i < ARENA_MAX_NUMA_NODES; i++) {
+            if (pernode[i]) {
+                PyOS_snprintf(buf, sizeof(buf),
+                              "# arena chunks on node %u", i);
+                (void)printone(out, buf, pernode[i]);
+            }
+        }
+    }
+#endif
 
     fputc('\n', out);
 
@@ -3,6 +3,9 @@
 #include "Python.h"
 #include "pycore_abstract.h"      // _PyIndex_Check()
 #include "pycore_long.h"          // _PyLong_GetZero()
+#include "pycore_pylifecycle.h"   // _PyRange_Fini()
+#include "pycore_pystate.h"       // _PyInterpreterState_GET()
+#include "pycore_range.h"         // _PyRangeIterObject
 #include "pycore_tuple.h"         // _PyTuple_ITEMS()
 #include "structmember.h"         // PyMemberDef
 
@@ -764,16 +767,8 @@ PyTypeObject PyRange_Type = {
    in the normal case, but possible for any numeric value.
 */
 
-typedef struct {
-        PyObject_HEAD
-        long    index;
-        long    start;
-        long    step;
-        long    len;
-} rangeiterobject;
-
 static PyObject *
-rangeiter_next(rangeiterobject *r)
+rangeiter_next(_PyRangeIterObject *r)
 {
     if (r->index < r->len)
         /* cast to unsigned to avoid possible signed overflow
@@ -784,7 +779,7 @@ rangeiter_next(rangeiterobject *r)
 }
 
 static PyObject *
-rangeiter_len(rangeiterobject *r, PyObject *Py_UNUSED(ignored))
+rangeiter_len(_PyRangeIterObject *r, PyObject *Py_UNUSED(ignored))
 {
     return PyLong_FromLong(r->len - r->index);
 }
@@ -793,7 +788,7 @@ PyDoc_STRVAR(length_hint_doc,
              "Private method returning an estimate of len(list(it)).");
 
 static PyObject *
-rangeiter_reduce(rangeiterobject *r, PyObject *Py_UNUSED(ignored))
+rangeiter_reduce(_PyRangeIterObject *r, PyObject *Py_UNUSED(ignored))
 {
     PyObject *start=NULL, *stop=NULL, *step=NULL;
     PyObject *range;
@@ -823,7 +818,7 @@ rangeiter_reduce(rangeiterobject *r, PyObject *Py_UNUSED(ignored))
 }
 
 static PyObject *
-rangeiter_setstate(rangeiterobject *r, PyObject *state)
+rangeiter_setstate(_PyRangeIterObject *r, PyObject *state)
 {
     long index = PyLong_AsLong(state);
     if (index == -1 && PyErr_Occurred())
@@ -850,13 +845,73 @@ static PyMethodDef rangeiter_methods[] = {
     {NULL,              NULL}           /* sentinel */
 };
 
+#if PyRangeIter_MAXFREELIST > 0
+static struct _Py_range_state *
+get_range_state(void)
+{
+    PyInterpreterState *interp = _PyInterpreterState_GET();
+    return &interp->range;
+}
+#endif
+
+void
+_PyRangeIter_ClearFreeList(PyInterpreterState *interp)
+{
+#if PyRangeIter_MAXFREELIST > 0
+    struct _Py_range_state *state = &interp->range;
+    while (state->iter_numfree) {
+        PyObject *it = state->iter_free_list[--state->iter_numfree];
+        assert(Py_IS_TYPE(it, &PyRangeIter_Type));
+        PyObject_Free(it);
+    }
+#endif
+}
+
+void
+_PyRange_Fini(PyInterpreterState *interp)
+{
+    _PyRangeIter_ClearFreeList(interp);
+#if defined(Py_DEBUG) && PyRangeIter_MAXFREELIST > 0
+    struct _Py_range_state *state = &interp->range;
+    state->iter_numfree = -1;
+#endif
+}
+
+/* Print summary info about the state of the optimized allocator */
+void
+_PyRangeIter_DebugMallocStats(FILE *out)
+{
+#if PyRangeIter_MAXFREELIST > 0
+    struct _Py_range_state *state = get_range_state();
+    _PyDebugAllocatorStats(out, "free range_iterator",
+                           state->iter_numfree, sizeof(_PyRangeIterObject));
+#endif
+}
+
+static void
+rangeiter_dealloc(_PyRangeIterObject *it)
+{
+#if PyRangeIter_MAXFREELIST > 0
+    struct _Py_range_state *state = get_range_state();
+#ifdef Py_DEBUG
+    // rangeiter_dealloc() must not be called after _PyRange_Fini()
+    assert(state->iter_numfree != -1);
+#endif
+    if (state->iter_numfree < PyRangeIter_MAXFREELIST) {
+        state->iter_free_list[state->iter_numfree++] = (PyObject *)it;
+        return;
+    }
+#endif
+    PyObject_Free(it);
+}
+
 PyTypeObject PyRangeIter_Type = {
         PyVarObject_HEAD_INIT(&PyType_Type, 0)
         "range_iterator",                        /* tp_name */
-        sizeof(rangeiterobject),                /* tp_basicsize */
+        sizeof(_PyRangeIterObject),             /* tp_basicsize */
         0,                                      /* tp_itemsize */
         /* methods */
-        (destructor)PyObject_Del,               /* tp_dealloc */
+        (destructor)rangeiter_dealloc,          /* tp_dealloc */
         0,                                      /* tp_vectorcall_offset */
         0,                                      /* tp_getattr */
         0,                                      /* tp_setattr */
@@ -917,9 +972,24 @@ get_len_of_range(long lo, long hi, long step)
 static PyObject *
 fast_range_iter(long start, long stop, long step, long len)
 {
-    rangeiterobject *it = PyObject_New(rangeiterobject, &PyRangeIter_Type);
-    if (it == NULL)
-        return NULL;
+    _PyRangeIterObject *it;
+#if PyRangeIter_MAXFREELIST > 0
+    struct _Py_range_state *state = get_range_state();
+#ifdef Py_DEBUG
+    // fast_range_iter() must not be called after _PyRange_Fini()
+    assert(state->iter_numfree != -1);
+#endif
+    if (state->iter_numfree) {
+        it = (_PyRangeIterObject *)state->iter_free_list[--state->iter_numfree];
+        _Py_NewReference((PyObject *)it);
+    }
+    else
+#endif
+    {
+        it = PyObject_New(_PyRangeIterObject, &PyRangeIter_Type);
+        if (it == NULL)
+            return NULL;
+    }
     it->start = start;
     it->step = step;
     it->len = len;
@@ -90,20 +90,55 @@ PyTypeObject PyEllipsis_Type = {
 
 PyObject _Py_EllipsisObject = {
     _PyObject_EXTRA_INIT
-    1, &PyEllipsis_Type
+    _Py_IMMORTAL_REFCNT, &PyEllipsis_Type
 };
 
 
 /* Slice object implementation */
 
 
-void _PySlice_Fini(PyInterpreterState *interp)
+/* A free list is very effective since typically a slice is created and
+   then deleted again. */
+#if PySlice_MAXFREELIST > 0
+static struct _Py_slice_state *
+get_slice_state(void)
+{
+    PyInterpreterState *interp = _PyInterpreterState_GET();
+    return &interp->slice;
+}
+#endif
+
+void
+_PySlice_ClearFreeList(PyInterpreterState *interp)
 {
-    PySliceObject *obj = interp->slice_cache;
-    if (obj != NULL) {
-        interp->slice_cache = NULL;
+#if PySlice_MAXFREELIST > 0
+    struct _Py_slice_state *state = &interp->slice;
+    while (state->numfree) {
+        PySliceObject *obj = state->free_list[--state->numfree];
+        assert(PySlice_Check(obj));
         PyObject_GC_Del(obj);
     }
+#endif
+}
+
+void _PySlice_Fini(PyInterpreterState *interp)
+{
+    _PySlice_ClearFreeList(interp);
+#if defined(Py_DEBUG) && PySlice_MAXFREELIST > 0
+    struct _Py_slice_state *state = &interp->slice;
+    state->numfree = -1;
+#endif
+}
+
+/* Print summary info about the state of the optimized allocator */
+void
+_PySlice_DebugMallocStats(FILE *out)
+{
+#if PySlice_MAXFREELIST > 0
+    struct _Py_slice_state *state = get_slice_state();
+    _PyDebugAllocatorStats(out, "free PySliceObject",
+                           state->numfree, sizeof(PySliceObject));
+#endif
 }
 
 /* start, stop, and step are python objects with None indicating no
@@ -123,14 +158,20 @@ PySlice_New(PyObject *start, PyObject *stop, PyObject *step)
         stop = Py_None;
     }
 
-    PyInterpreterState *interp = _PyInterpreterState_GET();
     PySliceObject *obj;
-    if (interp->slice_cache != NULL) {
-        obj = interp->slice_cache;
-        interp->slice_cache = NULL;
+#if PySlice_MAXFREELIST > 0
+    struct _Py_slice_state *state = get_slice_state();
+#ifdef Py_DEBUG
+    // PySlice_New() must not be called after _PySlice_Fini()
+    assert(state->numfree != -1);
+#endif
+    if (state->numfree) {
+        obj = state->free_list[--state->numfree];
         _Py_NewReference((PyObject *)obj);
     }
-    else {
+    else
+#endif
+    {
         obj = PyObject_GC_New(PySliceObject, &PySlice_Type);
         if (obj == NULL) {
             return NULL;
@@ -330,17 +371,22 @@ Create a slice object.  This is used for extended slicing (e.g. a[0:10:2]).");
 static void
 slice_dealloc(PySliceObject *r)
 {
-    PyInterpreterState *interp = _PyInterpreterState_GET();
     _PyObject_GC_UNTRACK(r);
     Py_DECREF(r->step);
     Py_DECREF(r->start);
     Py_DECREF(r->stop);
-    if (interp->slice_cache == NULL) {
-        interp->slice_cache = r;
-    }
-    else {
-        PyObject_GC_Del(r);
-    }
+#if PySlice_MAXFREELIST > 0
+    struct _Py_slice_state *state = get_slice_state();
+#ifdef Py_DEBUG
+    // slice_dealloc() must not be called after _PySlice_Fini()
+    assert(state->numfree != -1);
+#endif
+    if (state->numfree < PySlice_MAXFREELIST) {
+        state->free_list[state->numfree++] = r;
+        return;
+    }
+#endif
+    PyObject_GC_Del(r);
 }
 
 static PyObject *
@@ -6431,6 +6431,26 @@ type_ready(PyTypeObject *type)
 }
 
 
+/* Static types are shared by all the interpreters, which may run in
+   parallel: make them immortal, with their dict, keys and values included,
+   so that using them never writes to their reference counts. */
+static void
+type_set_immortal(PyTypeObject *type)
+{
+    _Py_SetImmortal((PyObject *)type);
+    _Py_SetImmortal(type->tp_bases);
+    _Py_SetImmortal(type->tp_mro);
+    _Py_SetImmortal(type->tp_dict);
+
+    Py_ssize_t pos = 0;
+    PyObject *key, *value;
+    while (PyDict_Next(type->tp_dict, &pos, &key, &value)) {
+        _Py_SetImmortal(key);
+        _Py_SetImmortal(value);
+    }
+}
+
+
 int
 PyType_Ready(PyTypeObject *type)
 {
@@ -6456,16 +6476,37 @@ PyType_Ready(PyTypeObject *type)
     /* All done -- set the ready flag */
     type->tp_flags = (type->tp_flags & ~Py_TPFLAGS_READYING) | Py_TPFLAGS_READY;
     assert(_PyType_CheckConsistency(type));
+
+    if (!(type->tp_flags & Py_TPFLAGS_HEAPTYPE)) {
+        type_set_immortal(type);
+    }
     return 0;
 }
 
 
+#ifdef EXPERIMENTAL_ISOLATED_SUBINTERPRETERS
+/* The list of subclasses of a static type is only kept for the main
+   interpreter: the others would modify it in parallel.  Static types are
+   immutable, so they never have to notify their subclasses of changes. */
+static inline int
+skip_subclass(PyTypeObject *base)
+{
+    return (!(base->tp_flags & Py_TPFLAGS_HEAPTYPE)
+            && !_Py_IsMainInterpreter(_PyInterpreterState_GET()));
+}
+#endif
+
 static int
 add_subclass(PyTypeObject *base, PyTypeObject *type)
 {
     int result = -1;
     PyObject *dict, *key, *newobj;
 
+#ifdef EXPERIMENTAL_ISOLATED_SUBINTERPRETERS
+    if (skip_subclass(base)) {
+        return 0;
+    }
+#endif
     dict = base->tp_subclasses;
     if (dict == NULL) {
         base->tp_subclasses = dict = PyDict_New();
@@ -6508,6 +6549,11 @@ remove_subclass(PyTypeObject *base, PyTypeObject *type)
 {
     PyObject *dict, *key;
 
+#ifdef EXPERIMENTAL_ISOLATED_SUBINTERPRETERS
+    if (skip_subclass(base)) {
+        return;
+    }
+#endif
     dict = base->tp_subclasses;
     if (dict == NULL) {
         return;
@@ -8,12 +8,12 @@
  * See ast.unparse for a full unparser (written in Python)
  */
 
-static PyObject *_str_open_br;
-static PyObject *_str_dbl_open_br;
-static PyObject *_str_close_br;
-static PyObject *_str_dbl_close_br;
-static PyObject *_str_inf;
-static PyObject *_str_replace_inf;
+/* Interned once per interpreter */
+_Py_static_string(PyId_open_br, "{");
+_Py_static_string(PyId_dbl_open_br, "{{");
+_Py_static_string(PyId_close_br, "}");
+_Py_static_string(PyId_dbl_close_br, "}}");
+_Py_static_string(PyId_inf, "inf");
 
 /* Forward declarations for recursion via helper functions. */
 static PyObject *
@@ -78,12 +78,14 @@ append_repr(_PyUnicodeWriter *writer, PyObject *obj)
     if ((PyFloat_CheckExact(obj) && Py_IS_INFINITY(PyFloat_AS_DOUBLE(obj))) ||
        PyComplex_CheckExact(obj))
     {
-        PyObject *new_repr = PyUnicode_Replace(
-            repr,
-            _str_inf,
-            _str_replace_inf,
-            -1
-        );
+        PyObject *str_inf = _PyUnicode_FromId(&PyId_inf);
+        PyObject *replace_inf = PyUnicode_FromFormat("1e%d",
+                                                     1 + DBL_MAX_10_EXP);
+        PyObject *new_repr = NULL;
+        if (str_inf != NULL && replace_inf != NULL) {
+            new_repr = PyUnicode_Replace(repr, str_inf, replace_inf, -1);
+        }
+        Py_XDECREF(replace_inf);
         Py_DECREF(repr);
         if (!new_repr) {
             return -1;
@@ -575,11 +577,18 @@ escape_braces(PyObject *orig)
 {
     PyObject *temp;
     PyObject *result;
-    temp = PyUnicode_Replace(orig, _str_open_br, _str_dbl_open_br, -1);
+    PyObject *open_br = _PyUnicode_FromId(&PyId_open_br);
+    PyObject *dbl_open_br = _PyUnicode_FromId(&PyId_dbl_open_br);
+    PyObject *close_br = _PyUnicode_FromId(&PyId_close_br);
+    PyObject *dbl_close_br = _PyUnicode_FromId(&PyId_dbl_close_br);
+    if (!open_br || !dbl_open_br || !close_br || !dbl_close_br) {
+        return NULL;
+    }
+    temp = PyUnicode_Replace(orig, open_br, dbl_open_br, -1);
     if (!temp) {
         return NULL;
     }
-    result = PyUnicode_Replace(temp, _str_close_br, _str_dbl_close_br, -1);
+    result = PyUnicode_Replace(temp, close_br, dbl_close_br, -1);
     Py_DECREF(temp);
     return result;
 }
@@ -673,7 +682,9 @@ append_formattedvalue(_PyUnicodeWriter *writer, expr_ty e)
     if (!temp_fv_str) {
         return -1;
     }
-    if (PyUnicode_Find(temp_fv_str, _str_open_br, 0, 1, 1) == 0) {
+    if (PyUnicode_GET_LENGTH(temp_fv_str) > 0 &&
+        PyUnicode_READ_CHAR(temp_fv_str, 0) == '{')
+    {
         /* Expression starts with a brace, split it with a space from the outer
            one. */
         outer_brace = "{ ";
@@ -924,36 +935,6 @@ append_ast_expr(_PyUnicodeWriter *writer, expr_ty e, int level)
     return -1;
 }
 
-static int
-maybe_init_static_strings(void)
-{
-    if (!_str_open_br &&
-        !(_str_open_br = PyUnicode_InternFromString("{"))) {
-        return -1;
-    }
-    if (!_str_dbl_open_br &&
-        !(_str_dbl_open_br = PyUnicode_InternFromString("{{"))) {
-        return -1;
-    }
-    if (!_str_close_br &&
-        !(_str_close_br = PyUnicode_InternFromString("}"))) {
-        return -1;
-    }
-    if (!_str_dbl_close_br &&
-        !(_str_dbl_close_br = PyUnicode_InternFromString("}}"))) {
-        return -1;
-    }
-    if (!_str_inf &&
-        !(_str_inf = PyUnicode_FromString("inf"))) {
-        return -1;
-    }
-    if (!_str_replace_inf &&
-        !(_str_replace_inf = PyUnicode_FromFormat("1e%d", 1 + DBL_MAX_10_EXP))) {
-        return -1;
-    }
-    return 0;
-}
-
 static PyObject *
 expr_as_unicode(expr_ty e, int level)
 {
@@ -961,9 +942,7 @@ expr_as_unicode(expr_ty e, int level)
     _PyUnicodeWriter_Init(&writer);
     writer.min_length = 256;
     writer.overallocate = 1;
-    if (-1 == maybe_init_static_strings() ||
-        -1 == append_ast_expr(&writer, e, level))
-    {
+    if (-1 == append_ast_expr(&writer, e, level)) {
         _PyUnicodeWriter_Dealloc(&writer);
         return NULL;
     }
@@ -15,13 +15,16 @@
 #include "pycore_ceval.h"         // _PyEval_SignalAsyncExc()
 #include "pycore_code.h"
 #include "pycore_initconfig.h"    // _PyStatus_OK()
+#include "pycore_list.h"          // _PyList_AppendTakeRef()
 #include "pycore_long.h"          // _PyLong_GetZero()
 #include "pycore_object.h"        // _PyObject_GC_TRACK()
+#include "pycore_optimizer.h"     // _PyOptimizer_RunLoop()
 #include "pycore_moduleobject.h"  // PyModuleObject
 #include "pycore_pyerrors.h"      // _PyErr_Fetch()
 #include "pycore_pylifecycle.h"   // _PyErr_Print()
 #include "pycore_pymem.h"         // _PyMem_IsPtrFreed()
 #include "pycore_pystate.h"       // _PyInterpreterState_GET()
+#include "pycore_range.h"         // _PyRangeIterObject
 #include "pycore_sysmodule.h"     // _PySys_Audit()
 #include "pycore_tuple.h"         // _PyTuple_ITEMS()
 
@@ -102,6 +105,12 @@ _PyEvalFramePushAndInit(PyThreadState *tstate, PyFrameConstructor *con,
                         size_t argcount, PyObject *kwnames);
 static int
 _PyEvalFrameClearAndPop(PyThreadState *tstate, InterpreterFrame * frame);
+static int
+exit_inlined_generator(PyThreadState *tstate, InterpreterFrame *frame,
+                       PyObject *retval);
+static InterpreterFrame *
+push_specialized_py_frame(PyThreadState *tstate, PyFunctionObject *func,
+                          PyObject **args, int argcount, _PyCallCache *cache);
 
 #define NAME_ERROR_MSG \
     "name '%.200s' is not defined"
@@ -1450,6 +1459,19 @@ eval_frame_handle_pending(PyThreadState *tstate)
 
 #define UPDATE_PREV_INSTR_OPARG(instr, oparg) ((uint8_t*)(instr))[-1] = (oparg)
 
+/* Specialization stats are counted per family in stats builds, and per
+ * instruction for code objects that keep them (-X specialization_stats) */
+#define STAT_INC(opname, name) \
+    do { \
+        GLOBAL_STAT_INC(opname, name); \
+        CODE_STAT_INC(co, frame->f_lasti, name); \
+    } while (0)
+#define STAT_DEC(opname, name) \
+    do { \
+        GLOBAL_STAT_DEC(opname, name); \
+        CODE_STAT_DEC(co, frame->f_lasti, name); \
+    } while (0)
+
 
 #define GLOBALS() frame->f_globals
 #define BUILTINS() frame->f_builtins
@@ -1457,6 +1479,79 @@ eval_frame_handle_pending(PyThreadState *tstate)
 
 /* Shared opcode macros */
 
+/* The specialized arithmetic instructions store their result into an
+ * operand that nothing but the value stack refers to, instead of boxing
+ * it anew.  The intermediate results of a*b + c*d are then never
+ * allocated: only the value the expression finally produces is. */
+
+// shared by the BINARY_OP_*_FLOAT instructions
+#define BINARY_OP_FLOAT(OP) \
+    do { \
+        PyObject *left = SECOND(); \
+        PyObject *right = TOP(); \
+        DEOPT_IF(!PyFloat_CheckExact(left), BINARY_OP); \
+        DEOPT_IF(Py_TYPE(right) != Py_TYPE(left), BINARY_OP); \
+        STAT_INC(BINARY_OP, hit); \
+        double dres = ((PyFloatObject *)left)->ob_fval OP \
+            ((PyFloatObject *)right)->ob_fval; \
+        PyObject *res; \
+        if (Py_REFCNT(left) == 1) { \
+            ((PyFloatObject *)left)->ob_fval = dres; \
+            Py_DECREF(right); \
+            res = left; \
+        } \
+        else if (Py_REFCNT(right) == 1) { \
+            ((PyFloatObject *)right)->ob_fval = dres; \
+            Py_DECREF(left); \
+            res = right; \
+        } \
+        else { \
+            res = PyFloat_FromDouble(dres); \
+            Py_DECREF(right); \
+            Py_DECREF(left); \
+        } \
+        SET_SECOND(res); \
+        STACK_SHRINK(1); \
+        if (res == NULL) { \
+            goto error; \
+        } \
+    } while (0)
+
+// shared by the BINARY_OP_*_INT instructions
+#define BINARY_OP_INT(OP, FUNC) \
+    do { \
+        PyObject *left = SECOND(); \
+        PyObject *right = TOP(); \
+        DEOPT_IF(!PyLong_CheckExact(left), BINARY_OP); \
+        DEOPT_IF(Py_TYPE(right) != Py_TYPE(left), BINARY_OP); \
+        STAT_INC(BINARY_OP, hit); \
+        PyObject *res = NULL; \
+        if (_PyLong_IsMedium(left) && _PyLong_IsMedium(right)) { \
+            stwodigits ival = _PyLong_MediumValue(left) OP \
+                _PyLong_MediumValue(right); \
+            if (_PyLong_CanStoreInPlace(left, ival)) { \
+                _PyLong_StoreInPlace(left, ival); \
+                Py_DECREF(right); \
+                res = left; \
+            } \
+            else if (_PyLong_CanStoreInPlace(right, ival)) { \
+                _PyLong_StoreInPlace(right, ival); \
+                Py_DECREF(left); \
+                res = right; \
+            } \
+        } \
+        if (res == NULL) { \
+            res = FUNC((PyLongObject *)left, (PyLongObject *)right); \
+            Py_DECREF(right); \
+            Py_DECREF(left); \
+        } \
+        SET_SECOND(res); \
+        STACK_SHRINK(1); \
+        if (res == NULL) { \
+            goto error; \
+        } \
+    } while (0)
+
 // shared by LOAD_ATTR_MODULE and LOAD_METHOD_MODULE
 #define LOAD_MODULE_ATTR_OR_METHOD(attr_or_method) \
     SpecializedCacheEntry *caches = GET_CACHE(); \
@@ -1920,38 +2015,22 @@ _PyEval_EvalFrameDefault(PyThreadState *tstate, InterpreterFrame *frame, int thr
         }
 
         TARGET(BINARY_OP_MULTIPLY_INT) {
-            PyObject *left = SECOND();
-            PyObject *right = TOP();
-            DEOPT_IF(!PyLong_CheckExact(left), BINARY_OP);
-            DEOPT_IF(!PyLong_CheckExact(right), BINARY_OP);
-            STAT_INC(BINARY_OP, hit);
-            PyObject *prod = _PyLong_Multiply((PyLongObject *)left, (PyLongObject *)right);
-            SET_SECOND(prod);
-            Py_DECREF(right);
-            Py_DECREF(left);
-            STACK_SHRINK(1);
-            if (prod == NULL) {
-                goto error;
-            }
+            BINARY_OP_INT(*, _PyLong_Multiply);
+            DISPATCH();
+        }
+
+        TARGET(BINARY_OP_SUBTRACT_INT) {
+            BINARY_OP_INT(-, _PyLong_Subtract);
             DISPATCH();
         }
 
         TARGET(BINARY_OP_MULTIPLY_FLOAT) {
-            PyObject *left = SECOND();
-            PyObject *right = TOP();
-            DEOPT_IF(!PyFloat_CheckExact(left), BINARY_OP);
-            DEOPT_IF(!PyFloat_CheckExact(right), BINARY_OP);
-            STAT_INC(BINARY_OP, hit);
-            double dprod = ((PyFloatObject *)left)->ob_fval *
-                ((PyFloatObject *)right)->ob_fval;
-            PyObject *prod = PyFloat_FromDouble(dprod);
-            SET_SECOND(prod);
-            Py_DECREF(right);
-            Py_DECREF(left);
-            STACK_SHRINK(1);
-            if (prod == NULL) {
-                goto error;
-            }
+            BINARY_OP_FLOAT(*);
+            DISPATCH();
+        }
+
+        TARGET(BINARY_OP_SUBTRACT_FLOAT) {
+            BINARY_OP_FLOAT(-);
             DISPATCH();
         }
 
@@ -2001,38 +2080,12 @@ _PyEval_EvalFrameDefault(PyThreadState *tstate, InterpreterFrame *frame, int thr
         }
 
         TARGET(BINARY_OP_ADD_FLOAT) {
-            PyObject *left = SECOND();
-            PyObject *right = TOP();
-            DEOPT_IF(!PyFloat_CheckExact(left), BINARY_OP);
-            DEOPT_IF(Py_TYPE(right) != Py_TYPE(left), BINARY_OP);
-            STAT_INC(BINARY_OP, hit);
-            double dsum = ((PyFloatObject *)left)->ob_fval +
-                ((PyFloatObject *)right)->ob_fval;
-            PyObject *sum = PyFloat_FromDouble(dsum);
-            SET_SECOND(sum);
-            Py_DECREF(right);
-            Py_DECREF(left);
-            STACK_SHRINK(1);
-            if (sum == NULL) {
-                goto error;
-            }
+            BINARY_OP_FLOAT(+);
             DISPATCH();
         }
 
         TARGET(BINARY_OP_ADD_INT) {
-            PyObject *left = SECOND();
-            PyObject *right = TOP();
-            DEOPT_IF(!PyLong_CheckExact(left), BINARY_OP);
-            DEOPT_IF(Py_TYPE(right) != Py_TYPE(left), BINARY_OP);
-            STAT_INC(BINARY_OP, hit);
-            PyObject *sum = _PyLong_Add((PyLongObject *)left, (PyLongObject *)right);
-            SET_SECOND(sum);
-            Py_DECREF(right);
-            Py_DECREF(left);
-            STACK_SHRINK(1);
-            if (sum == NULL) {
-                goto error;
-            }
+            BINARY_OP_INT(+, _PyLong_Add);
             DISPATCH();
         }
 
@@ -2159,6 +2212,8 @@ _PyEval_EvalFrameDefault(PyThreadState *tstate, InterpreterFrame *frame, int thr
         }
 
         TARGET(STORE_SUBSCR) {
+            PREDICTED(STORE_SUBSCR);
+            STAT_INC(STORE_SUBSCR, unquickened);
             PyObject *sub = TOP();
             PyObject *container = SECOND();
             PyObject *v = THIRD();
@@ -2174,6 +2229,69 @@ _PyEval_EvalFrameDefault(PyThreadState *tstate, InterpreterFrame *frame, int thr
             DISPATCH();
         }
 
+        TARGET(STORE_SUBSCR_ADAPTIVE) {
+            if (oparg == 0) {
+                PyObject *sub = TOP();
+                PyObject *container = SECOND();
+                next_instr--;
+                if (_Py_Specialize_StoreSubscr(container, sub, next_instr) < 0) {
+                    goto error;
+                }
+                DISPATCH();
+            }
+            else {
+                STAT_INC(STORE_SUBSCR, deferred);
+                // oparg is the adaptive cache counter
+                UPDATE_PREV_INSTR_OPARG(next_instr, oparg - 1);
+                assert(_Py_OPCODE(next_instr[-1]) == STORE_SUBSCR_ADAPTIVE);
+                assert(_Py_OPARG(next_instr[-1]) == oparg - 1);
+                STAT_DEC(STORE_SUBSCR, unquickened);
+                JUMP_TO_INSTRUCTION(STORE_SUBSCR);
+            }
+        }
+
+        TARGET(STORE_SUBSCR_LIST_INT) {
+            PyObject *sub = TOP();
+            PyObject *list = SECOND();
+            PyObject *value = THIRD();
+            DEOPT_IF(!PyLong_CheckExact(sub), STORE_SUBSCR);
+            DEOPT_IF(!PyList_CheckExact(list), STORE_SUBSCR);
+
+            // Deopt unless 0 <= sub < PyList_Size(list)
+            Py_ssize_t signed_magnitude = Py_SIZE(sub);
+            DEOPT_IF(((size_t)signed_magnitude) > 1, STORE_SUBSCR);
+            assert(((PyLongObject *)_PyLong_GetZero())->ob_digit[0] == 0);
+            Py_ssize_t index = ((PyLongObject*)sub)->ob_digit[0];
+            DEOPT_IF(index >= PyList_GET_SIZE(list), STORE_SUBSCR);
+            STAT_INC(STORE_SUBSCR, hit);
+
+            PyObject *old_value = PyList_GET_ITEM(list, index);
+            PyList_SET_ITEM(list, index, value);
+            STACK_SHRINK(3);
+            assert(old_value != NULL);
+            Py_DECREF(old_value);
+            Py_DECREF(sub);
+            Py_DECREF(list);
+            DISPATCH();
+        }
+
+        TARGET(STORE_SUBSCR_DICT) {
+            PyObject *sub = TOP();
+            PyObject *dict = SECOND();
+            PyObject *value = THIRD();
+            DEOPT_IF(!PyDict_CheckExact(dict), STORE_SUBSCR);
+            STAT_INC(STORE_SUBSCR, hit);
+            STACK_SHRINK(3);
+            int err = PyDict_SetItem(dict, sub, value);
+            Py_DECREF(value);
+            Py_DECREF(dict);
+            Py_DECREF(sub);
+            if (err != 0) {
+                goto error;
+            }
+            DISPATCH();
+        }
+
         TARGET(DELETE_SUBSCR) {
             PyObject *sub = TOP();
             PyObject *container = SECOND();
@@ -2631,6 +2749,7 @@ _PyEval_EvalFrameDefault(PyThreadState *tstate, InterpreterFrame *frame, int thr
 
         TARGET(UNPACK_SEQUENCE) {
             PREDICTED(UNPACK_SEQUENCE);
+            STAT_INC(UNPACK_SEQUENCE, unquickened);
             PyObject *seq = POP(), *item, **items;
             if (PyTuple_CheckExact(seq) &&
                 PyTuple_GET_SIZE(seq) == oparg) {
@@ -2660,6 +2779,65 @@ _PyEval_EvalFrameDefault(PyThreadState *tstate, InterpreterFrame *frame, int thr
             DISPATCH();
         }
 
+        TARGET(UNPACK_SEQUENCE_ADAPTIVE) {
+            assert(cframe.use_tracing == 0);
+            SpecializedCacheEntry *cache = GET_CACHE();
+            if (cache->adaptive.counter == 0) {
+                PyObject *seq = TOP();
+                next_instr--;
+                _Py_Specialize_UnpackSequence(seq, next_instr, cache);
+                DISPATCH();
+            }
+            else {
+                STAT_INC(UNPACK_SEQUENCE, deferred);
+                cache->adaptive.counter--;
+                oparg = cache->adaptive.original_oparg;
+                STAT_DEC(UNPACK_SEQUENCE, unquickened);
+                JUMP_TO_INSTRUCTION(UNPACK_SEQUENCE);
+            }
+        }
+
+        TARGET(UNPACK_SEQUENCE_TWO_TUPLE) {
+            PyObject *seq = TOP();
+            DEOPT_IF(!PyTuple_CheckExact(seq), UNPACK_SEQUENCE);
+            DEOPT_IF(PyTuple_GET_SIZE(seq) != 2, UNPACK_SEQUENCE);
+            STAT_INC(UNPACK_SEQUENCE, hit);
+            SET_TOP(Py_NewRef(PyTuple_GET_ITEM(seq, 1)));
+            PUSH(Py_NewRef(PyTuple_GET_ITEM(seq, 0)));
+            Py_DECREF(seq);
+            DISPATCH();
+        }
+
+        TARGET(UNPACK_SEQUENCE_TUPLE) {
+            PyObject *seq = TOP();
+            int len = GET_CACHE()->adaptive.original_oparg;
+            DEOPT_IF(!PyTuple_CheckExact(seq), UNPACK_SEQUENCE);
+            DEOPT_IF(PyTuple_GET_SIZE(seq) != len, UNPACK_SEQUENCE);
+            STAT_INC(UNPACK_SEQUENCE, hit);
+            STACK_SHRINK(1);
+            PyObject **items = _PyTuple_ITEMS(seq);
+            while (len--) {
+                PUSH(Py_NewRef(items[len]));
+            }
+            Py_DECREF(seq);
+            DISPATCH();
+        }
+
+        TARGET(UNPACK_SEQUENCE_LIST) {
+            PyObject *seq = TOP();
+            int len = GET_CACHE()->adaptive.original_oparg;
+            DEOPT_IF(!PyList_CheckExact(seq), UNPACK_SEQUENCE);
+            DEOPT_IF(PyList_GET_SIZE(seq) != len, UNPACK_SEQUENCE);
+            STAT_INC(UNPACK_SEQUENCE, hit);
+            STACK_SHRINK(1);
+            PyObject **items = _PyList_ITEMS(seq);
+            while (len--) {
+                PUSH(Py_NewRef(items[len]));
+            }
+            Py_DECREF(seq);
+            DISPATCH();
+        }
+
         TARGET(UNPACK_EX) {
             int totalargs = 1 + (oparg & 0xFF) + (oparg >> 8);
             PyObject *seq = POP();
@@ -3486,6 +3664,8 @@ _PyEval_EvalFrameDefault(PyThreadState *tstate, InterpreterFrame *frame, int thr
         }
 
         TARGET(COMPARE_OP) {
+            PREDICTED(COMPARE_OP);
+            STAT_INC(COMPARE_OP, unquickened);
             assert(oparg <= Py_GE);
             PyObject *right = POP();
             PyObject *left = TOP();
@@ -3500,6 +3680,128 @@ _PyEval_EvalFrameDefault(PyThreadState *tstate, InterpreterFrame *frame, int thr
             DISPATCH();
         }
 
+        TARGET(COMPARE_OP_ADAPTIVE) {
+            assert(cframe.use_tracing == 0);
+            SpecializedCacheEntry *cache = GET_CACHE();
+            if (cache->adaptive.counter == 0) {
+                PyObject *right = TOP();
+                PyObject *left = SECOND();
+                next_instr--;
+                _Py_Specialize_CompareOp(left, right, next_instr, cache);
+                DISPATCH();
+            }
+            else {
+                STAT_INC(COMPARE_OP, deferred);
+                cache->adaptive.counter--;
+                oparg = cache->adaptive.original_oparg;
+                STAT_DEC(COMPARE_OP, unquickened);
+                JUMP_TO_INSTRUCTION(COMPARE_OP);
+            }
+        }
+
+        TARGET(COMPARE_OP_FLOAT_JUMP) {
+            assert(cframe.use_tracing == 0);
+            // Combined: COMPARE_OP (float ? float) + POP_JUMP_IF_(true/false)
+            SpecializedCacheEntry *caches = GET_CACHE();
+            int when_to_jump_mask = caches[0].adaptive.index;
+            PyObject *right = TOP();
+            PyObject *left = SECOND();
+            DEOPT_IF(!PyFloat_CheckExact(left), COMPARE_OP);
+            DEOPT_IF(!PyFloat_CheckExact(right), COMPARE_OP);
+            double dleft = PyFloat_AS_DOUBLE(left);
+            double dright = PyFloat_AS_DOUBLE(right);
+            // NaNs compare unordered, which the sign below can't express
+            DEOPT_IF(isnan(dleft), COMPARE_OP);
+            DEOPT_IF(isnan(dright), COMPARE_OP);
+            STAT_INC(COMPARE_OP, hit);
+            int sign = (dleft > dright) - (dleft < dright);
+            NEXTOPARG();
+            STACK_SHRINK(2);
+            Py_DECREF(left);
+            Py_DECREF(right);
+            assert(opcode == POP_JUMP_IF_TRUE || opcode == POP_JUMP_IF_FALSE);
+            int jump = (1 << (sign + 1)) & when_to_jump_mask;
+            if (!jump) {
+                next_instr++;
+                NOTRACE_DISPATCH();
+            }
+            else {
+                JUMPTO(oparg);
+                CHECK_EVAL_BREAKER();
+                NOTRACE_DISPATCH();
+            }
+        }
+
+        TARGET(COMPARE_OP_INT_JUMP) {
+            assert(cframe.use_tracing == 0);
+            // Combined: COMPARE_OP (int ? int) + POP_JUMP_IF_(true/false)
+            SpecializedCacheEntry *caches = GET_CACHE();
+            int when_to_jump_mask = caches[0].adaptive.index;
+            PyObject *right = TOP();
+            PyObject *left = SECOND();
+            DEOPT_IF(!PyLong_CheckExact(left), COMPARE_OP);
+            DEOPT_IF(!PyLong_CheckExact(right), COMPARE_OP);
+            // Deopt unless both operands fit in a single digit
+            DEOPT_IF((size_t)(Py_SIZE(left) + 1) > 2, COMPARE_OP);
+            DEOPT_IF((size_t)(Py_SIZE(right) + 1) > 2, COMPARE_OP);
+            STAT_INC(COMPARE_OP, hit);
+            assert(((PyLongObject *)_PyLong_GetZero())->ob_digit[0] == 0);
+            Py_ssize_t ileft = Py_SIZE(left) * ((PyLongObject *)left)->ob_digit[0];
+            Py_ssize_t iright = Py_SIZE(right) * ((PyLongObject *)right)->ob_digit[0];
+            int sign = (ileft > iright) - (ileft < iright);
+            NEXTOPARG();
+            STACK_SHRINK(2);
+            Py_DECREF(left);
+            Py_DECREF(right);
+            assert(opcode == POP_JUMP_IF_TRUE || opcode == POP_JUMP_IF_FALSE);
+            int jump = (1 << (sign + 1)) & when_to_jump_mask;
+            if (!jump) {
+                next_instr++;
+                NOTRACE_DISPATCH();
+            }
+            else {
+                JUMPTO(oparg);
+                CHECK_EVAL_BREAKER();
+                NOTRACE_DISPATCH();
+            }
+        }
+
+        TARGET(COMPARE_OP_STR_JUMP) {
+            assert(cframe.use_tracing == 0);
+            // Combined: COMPARE_OP (str == str or str != str) + POP_JUMP_IF_(true/false)
+            SpecializedCacheEntry *caches = GET_CACHE();
+            int when_to_jump_mask = caches[0].adaptive.index;
+            PyObject *right = TOP();
+            PyObject *left = SECOND();
+            DEOPT_IF(!PyUnicode_CheckExact(left), COMPARE_OP);
+            DEOPT_IF(!PyUnicode_CheckExact(right), COMPARE_OP);
+            STAT_INC(COMPARE_OP, hit);
+            int res = _PyUnicode_Equal(left, right);
+            if (res < 0) {
+                goto error;
+            }
+            assert(caches[0].adaptive.original_oparg == Py_EQ ||
+                   caches[0].adaptive.original_oparg == Py_NE);
+            NEXTOPARG();
+            STACK_SHRINK(2);
+            Py_DECREF(left);
+            Py_DECREF(right);
+            assert(opcode == POP_JUMP_IF_TRUE || opcode == POP_JUMP_IF_FALSE);
+            // Unequal strings are reported as "greater than", which
+            // selects the same jump as "less than" for both == and !=.
+            int sign = !res;
+            int jump = (1 << (sign + 1)) & when_to_jump_mask;
+            if (!jump) {
+                next_instr++;
+                NOTRACE_DISPATCH();
+            }
+            else {
+                JUMPTO(oparg);
+                CHECK_EVAL_BREAKER();
+                NOTRACE_DISPATCH();
+            }
+        }
+
         TARGET(IS_OP) {
             PyObject *right = POP();
             PyObject *left = TOP();
@@ -3753,6 +4055,20 @@ _PyEval_EvalFrameDefault(PyThreadState *tstate, InterpreterFrame *frame, int thr
             assert(oparg < INSTR_OFFSET());
             JUMPTO(oparg);
             CHECK_EVAL_BREAKER();
+            if (tstate->interp->optimizer.enabled) {
+                assert(cframe.use_tracing == 0);
+                int resume;
+                int err = _PyOptimizer_RunLoop(tstate, frame, oparg,
+                                               &stack_pointer, &resume);
+                if (err) {
+                    JUMPTO(resume);
+                    if (err < 0) {
+                        frame->f_lasti = resume;
+                        next_instr++;
+                        goto error;
+                    }
+                }
+            }
             DISPATCH();
         }
 
@@ -3874,6 +4190,7 @@ _PyEval_EvalFrameDefault(PyThreadState *tstate, InterpreterFrame *frame, int thr
 
         TARGET(FOR_ITER) {
             PREDICTED(FOR_ITER);
+            STAT_INC(FOR_ITER, unquickened);
             /* before: [iter]; after: [iter, iter()] *or* [] */
             PyObject *iter = TOP();
             PyObject *next = (*Py_TYPE(iter)->tp_iternext)(iter);
@@ -3899,6 +4216,130 @@ _PyEval_EvalFrameDefault(PyThreadState *tstate, InterpreterFrame *frame, int thr
             DISPATCH();
         }
 
+        TARGET(FOR_ITER_ADAPTIVE) {
+            assert(cframe.use_tracing == 0);
+            SpecializedCacheEntry *cache = GET_CACHE();
+            if (cache->adaptive.counter == 0) {
+                PyObject *iter = TOP();
+                next_instr--;
+                _Py_Specialize_ForIter(iter, next_instr, cache);
+                DISPATCH();
+            }
+            else {
+                STAT_INC(FOR_ITER, deferred);
+                cache->adaptive.counter--;
+                oparg = cache->adaptive.original_oparg;
+                STAT_DEC(FOR_ITER, unquickened);
+                JUMP_TO_INSTRUCTION(FOR_ITER);
+            }
+        }
+
+        TARGET(FOR_ITER_LIST) {
+            assert(cframe.use_tracing == 0);
+            _PyListIterObject *it = (_PyListIterObject *)TOP();
+            DEOPT_IF(Py_TYPE(it) != &PyListIter_Type, FOR_ITER);
+            STAT_INC(FOR_ITER, hit);
+            PyListObject *seq = it->it_seq;
+            if (seq != NULL) {
+                if (it->it_index < PyList_GET_SIZE(seq)) {
+                    PyObject *next = PyList_GET_ITEM(seq, it->it_index++);
+                    Py_INCREF(next);
+                    PUSH(next);
+                    PREDICT(STORE_FAST);
+                    PREDICT(UNPACK_SEQUENCE);
+                    DISPATCH();
+                }
+                it->it_seq = NULL;
+                Py_DECREF(seq);
+            }
+            STACK_SHRINK(1);
+            Py_DECREF(it);
+            JUMPBY(GET_CACHE()->adaptive.original_oparg);
+            DISPATCH();
+        }
+
+        TARGET(FOR_ITER_TUPLE) {
+            assert(cframe.use_tracing == 0);
+            _PyTupleIterObject *it = (_PyTupleIterObject *)TOP();
+            DEOPT_IF(Py_TYPE(it) != &PyTupleIter_Type, FOR_ITER);
+            STAT_INC(FOR_ITER, hit);
+            PyTupleObject *seq = it->it_seq;
+            if (seq != NULL) {
+                if (it->it_index < PyTuple_GET_SIZE(seq)) {
+                    PyObject *next = PyTuple_GET_ITEM(seq, it->it_index++);
+                    Py_INCREF(next);
+                    PUSH(next);
+                    PREDICT(STORE_FAST);
+                    PREDICT(UNPACK_SEQUENCE);
+                    DISPATCH();
+                }
+                it->it_seq = NULL;
+                Py_DECREF(seq);
+            }
+            STACK_SHRINK(1);
+            Py_DECREF(it);
+            JUMPBY(GET_CACHE()->adaptive.original_oparg);
+            DISPATCH();
+        }
+
+        TARGET(FOR_ITER_RANGE) {
+            assert(cframe.use_tracing == 0);
+            _PyRangeIterObject *r = (_PyRangeIterObject *)TOP();
+            DEOPT_IF(Py_TYPE(r) != &PyRangeIter_Type, FOR_ITER);
+            STAT_INC(FOR_ITER, hit);
+            if (r->index < r->len) {
+                /* cast to unsigned to avoid possible signed overflow
+                   in intermediate calculations. */
+                long value = (long)(r->start +
+                                    (unsigned long)(r->index++) * r->step);
+                PyObject *next = PyLong_FromLong(value);
+                if (next == NULL) {
+                    goto error;
+                }
+                PUSH(next);
+                PREDICT(STORE_FAST);
+                DISPATCH();
+            }
+            STACK_SHRINK(1);
+            Py_DECREF(r);
+            JUMPBY(GET_CACHE()->adaptive.original_oparg);
+            DISPATCH();
+        }
+
+        TARGET(FOR_ITER_GEN) {
+            assert(cframe.use_tracing == 0);
+            PyGenObject *gen = (PyGenObject *)TOP();
+            DEOPT_IF(Py_TYPE(gen) != &PyGen_Type, FOR_ITER);
+            /* PEP 523 */
+            DEOPT_IF(tstate->interp->eval_frame != NULL, FOR_ITER);
+            InterpreterFrame *gen_frame = gen->gi_xframe;
+            if (gen_frame == NULL) {
+                /* The generator is exhausted */
+                STAT_INC(FOR_ITER, hit);
+                STACK_SHRINK(1);
+                Py_DECREF(gen);
+                JUMPBY(GET_CACHE()->adaptive.original_oparg);
+                DISPATCH();
+            }
+            /* Let gen_iternext() report "generator already executing" */
+            DEOPT_IF(!_PyFrame_IsRunnable(gen_frame), FOR_ITER);
+            STAT_INC(FOR_ITER, hit);
+            /* Resume the generator frame in this loop, doing the work of
+             * gen_send_ex2(). exit_inlined_generator() undoes it when
+             * the generator yields, returns or raises. */
+            assert(gen_frame->generator == (PyObject *)gen);
+            assert(gen_frame->depth == 0);
+            Py_INCREF(Py_None);
+            _PyFrame_StackPush(gen_frame, Py_None);
+            gen->gi_exc_state.previous_item = tstate->exc_info;
+            tstate->exc_info = &gen->gi_exc_state;
+            _PyFrame_SetStackPointer(frame, stack_pointer);
+            gen_frame->previous = frame;
+            gen_frame->depth = frame->depth + 1;
+            frame = cframe.current_frame = gen_frame;
+            goto start_frame;
+        }
+
         TARGET(BEFORE_ASYNC_WITH) {
             _Py_IDENTIFIER(__aenter__);
             _Py_IDENTIFIER(__aexit__);
@@ -4175,6 +4616,8 @@ _PyEval_EvalFrameDefault(PyThreadState *tstate, InterpreterFrame *frame, int thr
         }
 
         TARGET(CALL_METHOD) {
+            PREDICTED(CALL_METHOD);
+            STAT_INC(CALL_METHOD, unquickened);
             /* Designed to work in tamdem with LOAD_METHOD. */
             /* `meth` is NULL when LOAD_METHOD thinks that it's not
                 a method call.
@@ -4221,6 +4664,8 @@ _PyEval_EvalFrameDefault(PyThreadState *tstate, InterpreterFrame *frame, int thr
         }
 
         TARGET(CALL_FUNCTION_KW) {
+            PREDICTED(CALL_FUNCTION_KW);
+            STAT_INC(CALL_FUNCTION_KW, unquickened);
             kwnames = POP();
             nargs = oparg - (int)PyTuple_GET_SIZE(kwnames);
             postcall_shrink = 1;
@@ -4338,6 +4783,7 @@ _PyEval_EvalFrameDefault(PyThreadState *tstate, InterpreterFrame *frame, int thr
             size_t size = code->co_nlocalsplus + code->co_stacksize + FRAME_SPECIALS_SIZE;
             InterpreterFrame *new_frame = _PyThreadState_BumpFramePointer(tstate, size);
             if (new_frame == NULL) {
+                PyErr_NoMemory();
                 goto error;
             }
             _PyFrame_InitializeSpecials(new_frame, PyFunction_AS_FRAME_CONSTRUCTOR(func),
@@ -4346,13 +4792,7 @@ _PyEval_EvalFrameDefault(PyThreadState *tstate, InterpreterFrame *frame, int thr
             for (int i = 0; i < argcount; i++) {
                 new_frame->localsplus[i] = stack_pointer[i];
             }
-            int deflen = cache1->defaults_len;
-            for (int i = 0; i < deflen; i++) {
-                PyObject *def = PyTuple_GET_ITEM(func->func_defaults, cache1->defaults_start+i);
-                Py_INCREF(def);
-                new_frame->localsplus[argcount+i] = def;
-            }
-            for (int i = argcount+deflen; i < code->co_nlocalsplus; i++) {
+            for (int i = argcount; i < code->co_nlocalsplus; i++) {
                 new_frame->localsplus[i] = NULL;
             }
             STACK_SHRINK(1);
@@ -4364,6 +4804,108 @@ _PyEval_EvalFrameDefault(PyThreadState *tstate, InterpreterFrame *frame, int thr
             goto start_frame;
         }
 
+        TARGET(CALL_FUNCTION_PY_WITH_DEFAULTS) {
+            SpecializedCacheEntry *caches = GET_CACHE();
+            int argcount = caches[0].adaptive.original_oparg;
+            _PyCallCache *cache1 = &caches[-1].call;
+            PyObject *callable = PEEK(argcount+1);
+            DEOPT_IF(!PyFunction_Check(callable), CALL_FUNCTION);
+            PyFunctionObject *func = (PyFunctionObject *)callable;
+            DEOPT_IF(func->func_version != cache1->func_version, CALL_FUNCTION);
+            /* PEP 523 */
+            DEOPT_IF(tstate->interp->eval_frame != NULL, CALL_FUNCTION);
+            STAT_INC(CALL_FUNCTION, hit);
+            InterpreterFrame *new_frame = push_specialized_py_frame(
+                tstate, func, stack_pointer - argcount, argcount, cache1);
+            if (new_frame == NULL) {
+                goto error;
+            }
+            STACK_SHRINK(argcount + 1);
+            Py_DECREF(func);
+            _PyFrame_SetStackPointer(frame, stack_pointer);
+            new_frame->previous = frame;
+            frame = cframe.current_frame = new_frame;
+            new_frame->depth = frame->depth + 1;
+            goto start_frame;
+        }
+
+        TARGET(CALL_FUNCTION_BOUND_METHOD) {
+            SpecializedCacheEntry *caches = GET_CACHE();
+            int argcount = caches[0].adaptive.original_oparg;
+            _PyCallCache *cache1 = &caches[-1].call;
+            PyObject *callable = PEEK(argcount+1);
+            DEOPT_IF(!Py_IS_TYPE(callable, &PyMethod_Type), CALL_FUNCTION);
+            PyObject *im_func = ((PyMethodObject *)callable)->im_func;
+            DEOPT_IF(!PyFunction_Check(im_func), CALL_FUNCTION);
+            PyFunctionObject *func = (PyFunctionObject *)im_func;
+            DEOPT_IF(func->func_version != cache1->func_version, CALL_FUNCTION);
+            /* PEP 523 */
+            DEOPT_IF(tstate->interp->eval_frame != NULL, CALL_FUNCTION);
+            STAT_INC(CALL_FUNCTION, hit);
+            /* Replace the bound method with self, which becomes
+               the first argument. */
+            PEEK(argcount+1) = Py_NewRef(((PyMethodObject *)callable)->im_self);
+            InterpreterFrame *new_frame = push_specialized_py_frame(
+                tstate, func, stack_pointer - argcount - 1, argcount + 1, cache1);
+            Py_DECREF(callable);
+            if (new_frame == NULL) {
+                goto error;
+            }
+            STACK_SHRINK(argcount + 1);
+            _PyFrame_SetStackPointer(frame, stack_pointer);
+            new_frame->previous = frame;
+            frame = cframe.current_frame = new_frame;
+            new_frame->depth = frame->depth + 1;
+            goto start_frame;
+        }
+
+        TARGET(CALL_FUNCTION_CLASS_INIT) {
+            SpecializedCacheEntry *caches = GET_CACHE();
+            int argcount = caches[0].adaptive.original_oparg;
+            _PyCallCache *cache1 = &caches[-1].call;
+            PyObject *callable = PEEK(argcount+1);
+            DEOPT_IF(!Py_IS_TYPE(callable, &PyType_Type), CALL_FUNCTION);
+            PyTypeObject *tp = (PyTypeObject *)callable;
+            DEOPT_IF(!(tp->tp_flags & Py_TPFLAGS_HEAPTYPE), CALL_FUNCTION);
+            PyHeapTypeObject *ht = (PyHeapTypeObject *)tp;
+            /* The version check guarantees that tp_new, tp_alloc and
+               __init__ are unchanged since specialization. */
+            DEOPT_IF(ht->_ht_init == NULL, CALL_FUNCTION);
+            DEOPT_IF(ht->_ht_init_version != tp->tp_version_tag, CALL_FUNCTION);
+            PyFunctionObject *init = (PyFunctionObject *)ht->_ht_init;
+            DEOPT_IF(init->func_version != cache1->func_version, CALL_FUNCTION);
+            /* PEP 523 */
+            DEOPT_IF(tstate->interp->eval_frame != NULL, CALL_FUNCTION);
+            STAT_INC(CALL_FUNCTION, hit);
+            PyObject *self = tp->tp_alloc(tp, 0);
+            if (self == NULL) {
+                goto error;
+            }
+            /* As in object_new() */
+            if (_PyObject_InitializeDict(self)) {
+                Py_DECREF(self);
+                goto error;
+            }
+            /* self replaces the class on the stack and stays there as the
+               result of the call; the __init__ frame gets its own reference. */
+            PEEK(argcount+1) = self;
+            Py_INCREF(self);
+            InterpreterFrame *new_frame = push_specialized_py_frame(
+                tstate, init, stack_pointer - argcount - 1, argcount + 1, cache1);
+            Py_DECREF(tp);
+            if (new_frame == NULL) {
+                Py_DECREF(self);
+                goto error;
+            }
+            new_frame->f_inlined_init = 1;
+            STACK_SHRINK(argcount);
+            _PyFrame_SetStackPointer(frame, stack_pointer);
+            new_frame->previous = frame;
+            frame = cframe.current_frame = new_frame;
+            new_frame->depth = frame->depth + 1;
+            goto start_frame;
+        }
+
         TARGET(CALL_FUNCTION_BUILTIN_O) {
             assert(cframe.use_tracing == 0);
             /* Builtin METH_O functions */
@@ -4489,6 +5031,230 @@ _PyEval_EvalFrameDefault(PyThreadState *tstate, InterpreterFrame *frame, int thr
             DISPATCH();
         }
 
+        TARGET(CALL_FUNCTION_KW_ADAPTIVE) {
+            SpecializedCacheEntry *cache = GET_CACHE();
+            if (cache->adaptive.counter == 0) {
+                next_instr--;
+                PyObject *names = TOP();
+                nargs = cache->adaptive.original_oparg -
+                        (int)PyTuple_GET_SIZE(names);
+                if (_Py_Specialize_CallFunctionKw(
+                    PEEK(cache->adaptive.original_oparg + 2), next_instr,
+                    nargs, names, cache) < 0) {
+                    goto error;
+                }
+                DISPATCH();
+            }
+            else {
+                STAT_INC(CALL_FUNCTION_KW, deferred);
+                cache->adaptive.counter--;
+                oparg = cache->adaptive.original_oparg;
+                STAT_DEC(CALL_FUNCTION_KW, unquickened);
+                JUMP_TO_INSTRUCTION(CALL_FUNCTION_KW);
+            }
+        }
+
+        TARGET(CALL_FUNCTION_KW_PY) {
+            SpecializedCacheEntry *caches = GET_CACHE();
+            /* The keyword names are a constant, so their number cannot
+               change once specialized. */
+            int argcount = caches[0].adaptive.original_oparg;
+            assert(PyTuple_CheckExact(TOP()));
+            _PyCallCache *cache1 = &caches[-1].call;
+            PyObject *callable = PEEK(argcount+2);
+            DEOPT_IF(!PyFunction_Check(callable), CALL_FUNCTION_KW);
+            PyFunctionObject *func = (PyFunctionObject *)callable;
+            DEOPT_IF(func->func_version != cache1->func_version, CALL_FUNCTION_KW);
+            /* PEP 523 */
+            DEOPT_IF(tstate->interp->eval_frame != NULL, CALL_FUNCTION_KW);
+            STAT_INC(CALL_FUNCTION_KW, hit);
+            InterpreterFrame *new_frame = push_specialized_py_frame(
+                tstate, func, stack_pointer - argcount - 1, argcount, cache1);
+            if (new_frame == NULL) {
+                goto error;
+            }
+            PyObject *names = POP();
+            Py_DECREF(names);
+            STACK_SHRINK(argcount + 1);
+            Py_DECREF(func);
+            _PyFrame_SetStackPointer(frame, stack_pointer);
+            new_frame->previous = frame;
+            frame = cframe.current_frame = new_frame;
+            new_frame->depth = frame->depth + 1;
+            goto start_frame;
+        }
+
+        TARGET(CALL_METHOD_ADAPTIVE) {
+            SpecializedCacheEntry *cache = GET_CACHE();
+            nargs = cache->adaptive.original_oparg;
+            if (cache->adaptive.counter == 0) {
+                next_instr--;
+                if (_Py_Specialize_CallMethod(
+                    PEEK(nargs + 2), PEEK(nargs + 1), next_instr,
+                    nargs, cache) < 0) {
+                    goto error;
+                }
+                DISPATCH();
+            }
+            else {
+                STAT_INC(CALL_METHOD, deferred);
+                cache->adaptive.counter--;
+                oparg = nargs;
+                STAT_DEC(CALL_METHOD, unquickened);
+                JUMP_TO_INSTRUCTION(CALL_METHOD);
+            }
+        }
+
+        TARGET(CALL_METHOD_PY) {
+            SpecializedCacheEntry *caches = GET_CACHE();
+            int argcount = caches[0].adaptive.original_oparg;
+            _PyCallCache *cache1 = &caches[-1].call;
+            PyObject *meth = PEEK(argcount+2);
+            DEOPT_IF(meth == NULL, CALL_METHOD);
+            DEOPT_IF(!PyFunction_Check(meth), CALL_METHOD);
+            PyFunctionObject *func = (PyFunctionObject *)meth;
+            DEOPT_IF(func->func_version != cache1->func_version, CALL_METHOD);
+            /* PEP 523 */
+            DEOPT_IF(tstate->interp->eval_frame != NULL, CALL_METHOD);
+            STAT_INC(CALL_METHOD, hit);
+            /* self is the first argument */
+            InterpreterFrame *new_frame = push_specialized_py_frame(
+                tstate, func, stack_pointer - argcount - 1, argcount + 1, cache1);
+            if (new_frame == NULL) {
+                goto error;
+            }
+            STACK_SHRINK(argcount + 2);
+            Py_DECREF(func);
+            _PyFrame_SetStackPointer(frame, stack_pointer);
+            new_frame->previous = frame;
+            frame = cframe.current_frame = new_frame;
+            new_frame->depth = frame->depth + 1;
+            goto start_frame;
+        }
+
+        TARGET(CALL_METHOD_DESCRIPTOR_NOARGS) {
+            assert(cframe.use_tracing == 0);
+            /* Method descriptors for METH_NOARGS methods, such as str.lower */
+            assert(GET_CACHE()->adaptive.original_oparg == 0);
+            PyObject *callable = SECOND();
+            DEOPT_IF(callable == NULL, CALL_METHOD);
+            DEOPT_IF(!Py_IS_TYPE(callable, &PyMethodDescr_Type), CALL_METHOD);
+            PyMethodDescrObject *descr = (PyMethodDescrObject *)callable;
+            DEOPT_IF(descr->d_method->ml_flags != METH_NOARGS, CALL_METHOD);
+            PyObject *self = TOP();
+            DEOPT_IF(!Py_IS_TYPE(self, descr->d_common.d_type), CALL_METHOD);
+            STAT_INC(CALL_METHOD, hit);
+
+            PyCFunction cfunc = descr->d_method->ml_meth;
+            // This is slower but CPython promises to check all non-vectorcall
+            // function calls.
+            if (_Py_EnterRecursiveCall(tstate, " while calling a Python object")) {
+                goto error;
+            }
+            PyObject *res = cfunc(self, NULL);
+            _Py_LeaveRecursiveCall(tstate);
+            assert((res != NULL) ^ (_PyErr_Occurred(tstate) != NULL));
+
+            /* Clear the stack of the method and self. */
+            Py_DECREF(self);
+            STACK_SHRINK(1);
+            Py_DECREF(callable);
+            SET_TOP(res);
+            if (res == NULL) {
+                goto error;
+            }
+            DISPATCH();
+        }
+
+        TARGET(CALL_METHOD_DESCRIPTOR_O) {
+            assert(cframe.use_tracing == 0);
+            /* Method descriptors for METH_O methods, such as str.join */
+            assert(GET_CACHE()->adaptive.original_oparg == 1);
+            PyObject *callable = THIRD();
+            DEOPT_IF(callable == NULL, CALL_METHOD);
+            DEOPT_IF(!Py_IS_TYPE(callable, &PyMethodDescr_Type), CALL_METHOD);
+            PyMethodDescrObject *descr = (PyMethodDescrObject *)callable;
+            DEOPT_IF(descr->d_method->ml_flags != METH_O, CALL_METHOD);
+            PyObject *self = SECOND();
+            DEOPT_IF(!Py_IS_TYPE(self, descr->d_common.d_type), CALL_METHOD);
+            STAT_INC(CALL_METHOD, hit);
+
+            PyCFunction cfunc = descr->d_method->ml_meth;
+            // This is slower but CPython promises to check all non-vectorcall
+            // function calls.
+            if (_Py_EnterRecursiveCall(tstate, " while calling a Python object")) {
+                goto error;
+            }
+            PyObject *arg = POP();
+            PyObject *res = cfunc(self, arg);
+            _Py_LeaveRecursiveCall(tstate);
+            assert((res != NULL) ^ (_PyErr_Occurred(tstate) != NULL));
+
+            /* Clear the stack of the method, self and the argument. */
+            Py_DECREF(arg);
+            Py_DECREF(self);
+            STACK_SHRINK(1);
+            Py_DECREF(callable);
+            SET_TOP(res);
+            if (res == NULL) {
+                goto error;
+            }
+            DISPATCH();
+        }
+
+        TARGET(CALL_METHOD_DESCRIPTOR_FAST) {
+            assert(cframe.use_tracing == 0);
+            /* Method descriptors for METH_FASTCALL methods, without keywords */
+            int nargs = GET_CACHE()->adaptive.original_oparg;
+            PyObject **pfunc = &PEEK(nargs + 2);
+            PyObject *callable = *pfunc;
+            DEOPT_IF(callable == NULL, CALL_METHOD);
+            DEOPT_IF(!Py_IS_TYPE(callable, &PyMethodDescr_Type), CALL_METHOD);
+            PyMethodDescrObject *descr = (PyMethodDescrObject *)callable;
+            DEOPT_IF(descr->d_method->ml_flags != METH_FASTCALL, CALL_METHOD);
+            PyObject *self = PEEK(nargs + 1);
+            DEOPT_IF(!Py_IS_TYPE(self, descr->d_common.d_type), CALL_METHOD);
+            STAT_INC(CALL_METHOD, hit);
+
+            _PyCFunctionFast cfunc =
+                (_PyCFunctionFast)(void(*)(void))descr->d_method->ml_meth;
+            PyObject *res = cfunc(self, &PEEK(nargs), nargs);
+            assert((res != NULL) ^ (_PyErr_Occurred(tstate) != NULL));
+
+            /* Clear the stack of the method, self and the arguments. */
+            while (stack_pointer > pfunc) {
+                PyObject *x = POP();
+                Py_DECREF(x);
+            }
+            PUSH(res);
+            if (res == NULL) {
+                goto error;
+            }
+            DISPATCH();
+        }
+
+        TARGET(CALL_METHOD_LIST_APPEND) {
+            assert(cframe.use_tracing == 0);
+            SpecializedCacheEntry *caches = GET_CACHE();
+            assert(caches[0].adaptive.original_oparg == 1);
+            _PyObjectCache *cache1 = &caches[-1].obj;
+            PyObject *callable = THIRD();
+            DEOPT_IF(callable != cache1->obj, CALL_METHOD);
+            PyObject *list = SECOND();
+            DEOPT_IF(!PyList_CheckExact(list), CALL_METHOD);
+            STAT_INC(CALL_METHOD, hit);
+            PyObject *arg = POP();
+            if (_PyList_AppendTakeRef((PyListObject *)list, arg) < 0) {
+                goto error;
+            }
+            Py_DECREF(list);
+            STACK_SHRINK(1);
+            Py_DECREF(callable);
+            Py_INCREF(Py_None);
+            SET_TOP(Py_None);
+            DISPATCH();
+        }
+
         TARGET(CALL_FUNCTION_EX) {
             PREDICTED(CALL_FUNCTION_EX);
             PyObject *func, *callargs, *kwargs = NULL, *result;
@@ -4890,8 +5656,14 @@ MISS_WITH_CACHE(STORE_ATTR)
 MISS_WITH_CACHE(LOAD_GLOBAL)
 MISS_WITH_CACHE(LOAD_METHOD)
 MISS_WITH_CACHE(CALL_FUNCTION)
+MISS_WITH_CACHE(CALL_FUNCTION_KW)
+MISS_WITH_CACHE(CALL_METHOD)
 MISS_WITH_CACHE(BINARY_OP)
+MISS_WITH_CACHE(COMPARE_OP)
+MISS_WITH_CACHE(FOR_ITER)
+MISS_WITH_CACHE(UNPACK_SEQUENCE)
 MISS_WITH_OPARG_COUNTER(BINARY_SUBSCR)
+MISS_WITH_OPARG_COUNTER(STORE_SUBSCR)
 
 binary_subscr_dict_error:
         {
@@ -5023,9 +5795,32 @@ MISS_WITH_OPARG_COUNTER(BINARY_SUBSCR)
 
     if (frame->depth) {
         cframe.current_frame = frame->previous;
-        _PyFrame_StackPush(cframe.current_frame, retval);
-        if (_PyEvalFrameClearAndPop(tstate, frame)) {
-            retval = NULL;
+        if (frame->generator != NULL) {
+            if (exit_inlined_generator(tstate, frame, retval)) {
+                retval = NULL;
+            }
+        }
+        else {
+            if (frame->f_inlined_init) {
+                /* CALL_FUNCTION_CLASS_INIT already left self on the
+                   caller's stack as the result of the call. */
+                if (retval != NULL && retval != Py_None) {
+                    _PyErr_Format(tstate, PyExc_TypeError,
+                                  "__init__() should return None, not '%.200s'",
+                                  Py_TYPE(retval)->tp_name);
+                    Py_CLEAR(retval);
+                }
+                else if (retval != NULL) {
+                    /* Only tested against NULL below */
+                    Py_DECREF(retval);
+                }
+            }
+            else {
+                _PyFrame_StackPush(cframe.current_frame, retval);
+            }
+            if (_PyEvalFrameClearAndPop(tstate, frame)) {
+                retval = NULL;
+            }
         }
         frame = cframe.current_frame;
         if (retval == NULL) {
@@ -5668,6 +6463,38 @@ _PyEvalFramePushAndInit(PyThreadState *tstate, PyFrameConstructor *con,
     return NULL;
 }
 
+/* Push a frame for a call whose layout was fixed by specialize_py_call_layout():
+ * the argcount arguments fill the first locals in order, followed by
+ * cache->defaults_len values taken from func_defaults.
+ * Consumes the references to the args on success only. */
+static InterpreterFrame *
+push_specialized_py_frame(PyThreadState *tstate, PyFunctionObject *func,
+                          PyObject **args, int argcount, _PyCallCache *cache)
+{
+    PyCodeObject *code = (PyCodeObject *)func->func_code;
+    size_t size = code->co_nlocalsplus + code->co_stacksize + FRAME_SPECIALS_SIZE;
+    InterpreterFrame *new_frame = _PyThreadState_BumpFramePointer(tstate, size);
+    if (new_frame == NULL) {
+        PyErr_NoMemory();
+        return NULL;
+    }
+    _PyFrame_InitializeSpecials(new_frame, PyFunction_AS_FRAME_CONSTRUCTOR(func),
+                                NULL, code->co_nlocalsplus);
+    for (int i = 0; i < argcount; i++) {
+        new_frame->localsplus[i] = args[i];
+    }
+    int deflen = cache->defaults_len;
+    for (int i = 0; i < deflen; i++) {
+        PyObject *def = PyTuple_GET_ITEM(func->func_defaults, cache->defaults_start+i);
+        Py_INCREF(def);
+        new_frame->localsplus[argcount+i] = def;
+    }
+    for (int i = argcount+deflen; i < code->co_nlocalsplus; i++) {
+        new_frame->localsplus[i] = NULL;
+    }
+    return new_frame;
+}
+
 static int
 _PyEvalFrameClearAndPop(PyThreadState *tstate, InterpreterFrame * frame)
 {
@@ -5682,6 +6509,45 @@ _PyEvalFrameClearAndPop(PyThreadState *tstate, InterpreterFrame * frame)
     return 0;
 }
 
+/* Leave a generator frame that FOR_ITER_GEN resumed inline, doing the
+ * bookkeeping that gen_send_ex2() does after evaluating the frame.
+ *
+ * If the generator yielded, retval is pushed onto the caller's stack.
+ * If it returned, the generator is released and the caller's FOR_ITER_GEN
+ * is executed again, which then finds the generator exhausted.
+ * Returns -1 if the generator raised an exception, 0 otherwise. */
+static int
+exit_inlined_generator(PyThreadState *tstate, InterpreterFrame *frame,
+                       PyObject *retval)
+{
+    PyGenObject *gen = (PyGenObject *)frame->generator;
+    InterpreterFrame *caller = frame->previous;
+    assert(PyGen_CheckExact(gen));
+    assert(gen->gi_xframe == frame);
+    tstate->exc_info = gen->gi_exc_state.previous_item;
+    gen->gi_exc_state.previous_item = NULL;
+    frame->previous = NULL;
+    frame->depth = 0;
+    if (retval != NULL) {
+        if (!_PyFrameHasCompleted(frame)) {
+            _PyFrame_StackPush(caller, retval);
+            return 0;
+        }
+        /* The return value of a generator is not visible to a for loop */
+        Py_DECREF(retval);
+        caller->f_lasti--;
+    }
+    else if (_PyErr_ExceptionMatches(tstate, PyExc_StopIteration)) {
+        _PyErr_FormatFromCause(PyExc_RuntimeError,
+                               "generator raised StopIteration");
+    }
+    _PyErr_ClearExcState(&gen->gi_exc_state);
+    frame->generator = NULL;
+    gen->gi_xframe = NULL;
+    _PyFrame_Clear(frame, 1);
+    return retval == NULL ? -1 : 0;
+}
+
 PyObject *
 _PyEval_Vector(PyThreadState *tstate, PyFrameConstructor *con,
                PyObject *locals,
@@ -737,6 +737,39 @@ sys__getquickenedcount(PyObject *module, PyObject *Py_UNUSED(ignored))
     return return_value;
 }
 
+PyDoc_STRVAR(sys__get_specialization_stats__doc__,
+"_get_specialization_stats($module, code, /)\n"
+"--\n"
+"\n"
+"Return the specialization stats of each instruction of a code object.\n"
+"\n"
+"The result maps the offset of every instruction with any activity to a\n"
+"dict of its counts.  Return None if the code object does not keep stats,\n"
+"which requires running with -X specialization_stats.");
+
+#define SYS__GET_SPECIALIZATION_STATS_METHODDEF    \
+    {"_get_specialization_stats", (PyCFunction)sys__get_specialization_stats, METH_O, sys__get_specialization_stats__doc__},
+
+static PyObject *
+sys__get_specialization_stats_impl(PyObject *module, PyObject *code);
+
+static PyObject *
+sys__get_specialization_stats(PyObject *module, PyObject *arg)
+{
+    PyObject *return_value = NULL;
+    PyObject *code;
+
+    if (!PyObject_TypeCheck(arg, &PyCode_Type)) {
+        _PyArg_BadArgument("_get_specialization_stats", "argument", (&PyCode_Type)->tp_name, arg);
+        goto exit;
+    }
+    code = arg;
+    return_value = sys__get_specialization_stats_impl(module, code);
+
+exit:
+    return return_value;
+}
+
 PyDoc_STRVAR(sys_getallocatedblocks__doc__,
 "getallocatedblocks($module, /)\n"
 "--\n"
@@ -907,6 +940,36 @@ sys__debugmallocstats(PyObject *module, PyObject *Py_UNUSED(ignored))
     return sys__debugmallocstats_impl(module);
 }
 
+PyDoc_STRVAR(sys__trim_memory__doc__,
+"_trim_memory($module, /)\n"
+"--\n"
+"\n"
+"Give the memory of pymalloc\'s free pools back to the operating system.\n"
+"\n"
+"Return the number of bytes released.");
+
+#define SYS__TRIM_MEMORY_METHODDEF    \
+    {"_trim_memory", (PyCFunction)sys__trim_memory, METH_NOARGS, sys__trim_memory__doc__},
+
+static Py_ssize_t
+sys__trim_memory_impl(PyObject *module);
+
+static PyObject *
+sys__trim_memory(PyObject *module, PyObject *Py_UNUSED(ignored))
+{
+    PyObject *return_value = NULL;
+    Py_ssize_t _return_value;
+
+    _return_value = sys__trim_memory_impl(module);
+    if ((_return_value == -1) && PyErr_Occurred()) {
+        goto exit;
+    }
+    return_value = PyLong_FromSsize_t(_return_value);
+
+exit:
+    return return_value;
+}
+
 PyDoc_STRVAR(sys__clear_type_cache__doc__,
 "_clear_type_cache($module, /)\n"
 "--\n"
@@ -992,4 +1055,4 @@ sys_getandroidapilevel(PyObject *module, PyObject *Py_UNUSED(ignored))
 #ifndef SYS_GETANDROIDAPILEVEL_METHODDEF
     #define SYS_GETANDROIDAPILEVEL_METHODDEF
 #endif /* !defined(SYS_GETANDROIDAPILEVEL_METHODDEF) */
-/*[clinic end generated code: output=855fc93b2347710b input=a9049054013a1b77]*/
+/*[clinic end generated code: output=a459ffe34ceadbc0 input=a9049054013a1b77]*/
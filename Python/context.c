@@ -1244,9 +1244,6 @@ token_new(PyContext *ctx, PyContextVar *var, PyObject *val)
 /////////////////////////// Token.MISSING
 
 
-static PyObject *_token_missing;
-
-
 typedef struct {
     PyObject_HEAD
 } PyContextTokenMissing;
@@ -1269,22 +1266,18 @@ PyTypeObject PyContextTokenMissing_Type = {
 };
 
 
+/* Immortal, since all the interpreters share it */
+static PyObject _token_missing = {
+    _PyObject_EXTRA_INIT
+    _Py_IMMORTAL_REFCNT, &PyContextTokenMissing_Type
+};
+
+
 static PyObject *
 get_token_missing(void)
 {
-    if (_token_missing != NULL) {
-        Py_INCREF(_token_missing);
-        return _token_missing;
-    }
-
-    _token_missing = (PyObject *)PyObject_New(
-        PyContextTokenMissing, &PyContextTokenMissing_Type);
-    if (_token_missing == NULL) {
-        return NULL;
-    }
-
-    Py_INCREF(_token_missing);
-    return _token_missing;
+    Py_INCREF(&_token_missing);
+    return &_token_missing;
 }
 
 
@@ -1309,9 +1302,6 @@ _PyContext_ClearFreeList(PyInterpreterState *interp)
 void
 _PyContext_Fini(PyInterpreterState *interp)
 {
-    if (_Py_IsMainInterpreter(interp)) {
-        Py_CLEAR(_token_missing);
-    }
     _PyContext_ClearFreeList(interp);
 #if defined(Py_DEBUG) && PyContext_MAXFREELIST > 0
     struct _Py_context_state *state = &interp->context;
@@ -104,6 +104,12 @@ static const char usage_3[] = "\
             when the interpreter displays tracebacks.\n\
          -X frozen_modules=[on|off]: whether or not frozen modules should be used.\n\
             The default is \"on\" (or \"off\" if you are running a local build).\n\
+         -X uops: run hot loops with the tier-2 micro-op interpreter, which executes\n\
+            optimized traces recorded from specialized bytecode\n\
+         -X jit: like -X uops, but also compile the traces to machine code\n\
+            (x86-64 Linux only)\n\
+         -X specialization_stats: count specialization hits, misses and failures\n\
+            for each instruction; see sys._get_specialization_stats()\n\
 \n\
 --check-hash-based-pycs always|default|never:\n\
     control how Python invalidates hash-based .pyc files\n\
@@ -2188,6 +2194,9 @@ const wchar_t* known_xoptions[] = {
     L"warn_default_encoding",
     L"no_debug_ranges",
     L"frozen_modules",
+    L"uops",
+    L"jit",
+    L"specialization_stats",
     NULL,
 };
 
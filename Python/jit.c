@@ -0,0 +1,231 @@
+/* Copy-and-patch JIT for tier-2 traces.
+ *
+ * The stencils in jit_stencils.h are generated at build time by
+ * Tools/jit/build.py from Tools/jit/template.c, which is compiled once per
+ * uop from the same uop bodies the tier-2 interpreter runs
+ * (Python/uop_cases.h).  A stencil is position-independent machine code
+ * with "holes": the places where the object file had relocations.
+ *
+ * Compiling a trace copies the stencil of each of its uops into a block of
+ * executable memory, one after the other, and fills in the holes with the
+ * fields of the uop, the addresses of the C functions and data the stencil
+ * uses, and the address of the next stencil.  The stencils continue with
+ * each other through tail calls, and every way out of the trace returns to
+ * the caller in Python/optimizer.c, which resumes tier 1.
+ */
+
+#include "Python.h"
+#include "pycore_code.h"
+#include "pycore_dict.h"          // DK_ENTRIES()
+#include "pycore_jit.h"
+#include "pycore_list.h"          // _PyListIterObject
+#include "pycore_long.h"          // _PyLong_Add()
+#include "pycore_pyerrors.h"      // _PyErr_Occurred()
+#include "pycore_range.h"         // _PyRangeIterObject
+#include "pycore_tuple.h"         // _PyTupleIterObject
+#include "pycore_uops.h"
+
+#if defined(__linux__) && defined(__x86_64__) && defined(HAVE_MMAP)
+
+#include <sys/mman.h>             // mmap()
+#include <unistd.h>               // sysconf()
+
+/* How a hole is patched, after the ELF relocation it came from */
+typedef enum {
+    HOLE_ABS_64,      /* R_X86_64_64: the 64-bit value */
+    HOLE_ABS_32,      /* R_X86_64_32: the value, zero-extended */
+    HOLE_ABS_32S,     /* R_X86_64_32S: the value, sign-extended */
+    HOLE_REL_32,      /* R_X86_64_PC32: relative to the hole */
+} HoleKind;
+
+/* What goes in a hole, before adding the addend */
+typedef enum {
+    HOLE_CONTINUE,    /* the stencil of the next uop */
+    HOLE_TOP,         /* the stencil of the first uop */
+    HOLE_BASE,        /* this stencil (for its own data) */
+    HOLE_OPARG,
+    HOLE_OPERAND,
+    HOLE_FLAGS,
+    HOLE_BORROWED,
+    HOLE_TARGET,
+    HOLE_INDEX,       /* the index of the uop in the trace */
+    HOLE_SYMBOL,      /* a C function or global, from jit_symbols */
+} HoleValue;
+
+typedef struct {
+    uint32_t offset;
+    uint8_t kind;
+    uint8_t value;
+    uint16_t symbol;
+    int64_t addend;
+} Hole;
+
+typedef struct {
+    size_t size;
+    const unsigned char *body;
+    size_t nholes;
+    const Hole *holes;
+} Stencil;
+
+#include "jit_stencils.h"
+
+#endif
+
+#if defined(JIT_STENCILS_AVAILABLE) && JIT_STENCILS_AVAILABLE
+
+static const uintptr_t jit_symbols[] = JIT_SYMBOLS_INIT;
+
+#define NSTENCILS ((int)(sizeof(stencils) / sizeof(stencils[0])))
+
+static int
+patch(unsigned char *location, HoleKind kind, uint64_t value)
+{
+    switch (kind) {
+        case HOLE_ABS_64:
+            memcpy(location, &value, sizeof(uint64_t));
+            return 0;
+        case HOLE_ABS_32: {
+            if (value > UINT32_MAX) {
+                return -1;
+            }
+            uint32_t value32 = (uint32_t)value;
+            memcpy(location, &value32, sizeof(uint32_t));
+            return 0;
+        }
+        case HOLE_ABS_32S:
+        case HOLE_REL_32: {
+            if (kind == HOLE_REL_32) {
+                value -= (uintptr_t)location;
+            }
+            int64_t svalue = (int64_t)value;
+            if (svalue < INT32_MIN || svalue > INT32_MAX) {
+                return -1;
+            }
+            int32_t value32 = (int32_t)svalue;
+            memcpy(location, &value32, sizeof(int32_t));
+            return 0;
+        }
+    }
+    Py_UNREACHABLE();
+}
+
+static int
+copy_and_patch(unsigned char *base, _PyUOpInstruction *uop, int index,
+               unsigned char *top, unsigned char *next)
+{
+    const Stencil *stencil = &stencils[uop->opcode];
+    memcpy(base, stencil->body, stencil->size);
+    for (size_t i = 0; i < stencil->nholes; i++) {
+        const Hole *hole = &stencil->holes[i];
+        uint64_t value;
+        switch (hole->value) {
+            case HOLE_CONTINUE:
+                if (next == NULL) {
+                    /* The last uop cannot fall off the end */
+                    return -1;
+                }
+                value = (uintptr_t)next;
+                break;
+            case HOLE_TOP:
+                value = (uintptr_t)top;
+                break;
+            case HOLE_BASE:
+                value = (uintptr_t)base;
+                break;
+            case HOLE_OPARG:
+                value = (uint64_t)(int64_t)uop->oparg;
+                break;
+            case HOLE_OPERAND:
+                value = uop->operand;
+                break;
+            case HOLE_FLAGS:
+                value = uop->flags;
+                break;
+            case HOLE_BORROWED:
+                value = uop->borrowed;
+                break;
+            case HOLE_TARGET:
+                value = (uint64_t)(int64_t)uop->target;
+                break;
+            case HOLE_INDEX:
+                value = (uint64_t)index;
+                break;
+            case HOLE_SYMBOL:
+                value = jit_symbols[hole->symbol];
+                break;
+            default:
+                Py_UNREACHABLE();
+        }
+        if (patch(base + hole->offset, hole->kind,
+                  value + (uint64_t)hole->addend) < 0)
+        {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+int
+_PyJIT_Compile(_PyUOpTrace *trace)
+{
+    assert(trace->jit_code == NULL);
+    size_t size = 0;
+    for (int i = 0; i < trace->length; i++) {
+        int opcode = trace->uops[i].opcode;
+        if (opcode >= NSTENCILS || stencils[opcode].size == 0) {
+            return -1;
+        }
+        size += stencils[opcode].size;
+    }
+    size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+    size = (size + page_size - 1) & ~(page_size - 1);
+    unsigned char *memory = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                                 MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) {
+        return -1;
+    }
+    unsigned char *here = memory;
+    for (int i = 0; i < trace->length; i++) {
+        _PyUOpInstruction *uop = &trace->uops[i];
+        size_t stencil_size = stencils[uop->opcode].size;
+        unsigned char *next = (i + 1 < trace->length) ? here + stencil_size : NULL;
+        if (copy_and_patch(here, uop, i, memory, next) < 0) {
+            munmap(memory, size);
+            return -1;
+        }
+        here += stencil_size;
+    }
+    if (mprotect(memory, size, PROT_READ | PROT_EXEC) < 0) {
+        munmap(memory, size);
+        return -1;
+    }
+    trace->jit_code = memory;
+    trace->jit_size = size;
+    return 0;
+}
+
+void
+_PyJIT_Free(_PyUOpTrace *trace)
+{
+    if (trace->jit_code != NULL) {
+        munmap(trace->jit_code, trace->jit_size);
+        trace->jit_code = NULL;
+        trace->jit_size = 0;
+    }
+}
+
+#else  /* !JIT_STENCILS_AVAILABLE */
+
+int
+_PyJIT_Compile(_PyUOpTrace *trace)
+{
+    return -1;
+}
+
+void
+_PyJIT_Free(_PyUOpTrace *trace)
+{
+    assert(trace->jit_code == NULL);
+}
+
+#endif
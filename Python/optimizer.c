@@ -0,0 +1,1122 @@
+/* Tier-2 trace optimizer and micro-op interpreter.
+ *
+ * With -X uops, every JUMP_ABSOLUTE_QUICK back-edge counts how often its
+ * loop runs.  Once a loop is hot, its body is projected from the quickened
+ * bytecode into a linear trace of micro-ops ("uops").  Specialized
+ * instructions are split into explicit type guards followed by the
+ * operation proper, so that later passes can remove what is redundant:
+ *
+ *  - guards on values whose type is already known are removed,
+ *  - constants stored in locals are propagated, and int and float
+ *    arithmetic on constants is folded,
+ *  - values that are loaded only to be consumed by a uop that cannot
+ *    escape are pushed as borrowed references, removing an incref/decref
+ *    pair.
+ *
+ * Forward branches follow the fall-through path.  If a branch's side exit
+ * is taken more often than the loop runs to completion, the branch is
+ * "flipped" and the trace is projected again, this time following the
+ * jump.
+ *
+ * Whenever the trace is left, the tier-1 interpreter resumes at the
+ * instruction the exiting uop came from, with the value stack laid out
+ * exactly as tier-1 would have it at that point.
+ */
+
+#include "Python.h"
+#include "pycore_code.h"
+#include "pycore_dict.h"          // DK_ENTRIES()
+#include "pycore_initconfig.h"    // _Py_get_xoption()
+#include "pycore_jit.h"           // _PyJIT_Compile()
+#include "pycore_list.h"          // _PyListIterObject
+#include "pycore_long.h"          // _PyLong_Add()
+#include "pycore_optimizer.h"
+#include "pycore_pyerrors.h"      // _PyErr_Occurred()
+#include "pycore_pystate.h"       // _PyInterpreterState_GET()
+#include "pycore_range.h"         // _PyRangeIterObject
+#include "pycore_tuple.h"         // _PyTupleIterObject
+#include "pycore_uops.h"
+#include "opcode.h"
+
+#include <stddef.h>               // offsetof()
+
+/* Back-edges taken before a loop is projected, and the cap on the
+ * exponential backoff applied when projection fails. */
+#define TRACE_THRESHOLD 16
+#define MAX_BACKOFF 12
+
+#define MAX_TRACE_LENGTH 256
+#define MAX_ABSTRACT_STACK 64
+
+/* A branch is flipped after this many side exits, provided they outnumber
+ * completed iterations.  Each loop is projected at most MAX_RETRACES
+ * times because of flipping. */
+#define FLIP_THRESHOLD 32
+#define MAX_RETRACES 8
+#define MAX_FLIPPED_BRANCHES 8
+
+/* A trace is thrown away once its guards have failed this many times,
+ * provided the failures outnumber completed iterations.  The loop is then
+ * projected again (with backoff) from the respecialized bytecode. */
+#define DEOPT_THRESHOLD 32
+
+typedef struct {
+    int start;
+    int counter;
+    int backoff;
+    int retraces;
+    int nflipped;
+    int flipped[MAX_FLIPPED_BRANCHES];
+    _PyUOpTrace *trace;
+} _PyTier2Entry;
+
+struct _PyTier2Table {
+    int count;
+    _PyTier2Entry entries[1];
+};
+
+static const struct {
+    int8_t popped;
+    int8_t pushed;
+    /* Operands that may be borrowed references, bit 0 being the top */
+    uint8_t borrowable;
+    /* Can call arbitrary code */
+    uint8_t escapes;
+} uop_info[] = {
+    [UOP_NOP] = { 0, 0, 0, 0 },
+    [UOP_LOAD_FAST] = { 0, 1, 0, 0 },
+    [UOP_LOAD_CONST] = { 0, 1, 0, 0 },
+    [UOP_STORE_FAST] = { 1, 0, 0, 0 },
+    [UOP_POP_TOP] = { 1, 0, 1, 0 },
+    [UOP_DUP_TOP] = { 1, 2, 0, 0 },
+    [UOP_ROT_TWO] = { 2, 2, 0, 0 },
+    [UOP_GUARD_TYPE] = { 0, 0, 0, 0 },
+    [UOP_BINARY_OP] = { 2, 1, 0, 1 },
+    [UOP_ADD_INT] = { 2, 1, 3, 0 },
+    [UOP_MULTIPLY_INT] = { 2, 1, 3, 0 },
+    [UOP_SUBTRACT_INT] = { 2, 1, 3, 0 },
+    [UOP_ADD_FLOAT] = { 2, 1, 3, 0 },
+    [UOP_MULTIPLY_FLOAT] = { 2, 1, 3, 0 },
+    [UOP_SUBTRACT_FLOAT] = { 2, 1, 3, 0 },
+    [UOP_BINARY_SUBSCR] = { 2, 1, 0, 1 },
+    [UOP_BINARY_SUBSCR_LIST_INT] = { 2, 1, 3, 0 },
+    [UOP_BINARY_SUBSCR_TUPLE_INT] = { 2, 1, 3, 0 },
+    [UOP_STORE_SUBSCR] = { 3, 0, 0, 1 },
+    [UOP_STORE_SUBSCR_LIST_INT] = { 3, 0, 3, 0 },
+    [UOP_COMPARE_OP] = { 2, 1, 0, 1 },
+    [UOP_IS_OP] = { 2, 1, 3, 0 },
+    [UOP_COMPARE_INT_BRANCH] = { 2, 0, 3, 0 },
+    [UOP_COMPARE_FLOAT_BRANCH] = { 2, 0, 3, 0 },
+    [UOP_COMPARE_STR_BRANCH] = { 2, 0, 3, 0 },
+    [UOP_BRANCH] = { 1, 0, 0, 1 },
+    [UOP_FOR_ITER] = { 0, 1, 0, 1 },
+    [UOP_FOR_ITER_LIST] = { 0, 1, 0, 0 },
+    [UOP_FOR_ITER_TUPLE] = { 0, 1, 0, 0 },
+    [UOP_FOR_ITER_RANGE] = { 0, 1, 0, 0 },
+    [UOP_LOAD_GLOBAL_MODULE] = { 0, 1, 0, 0 },
+    [UOP_LOAD_GLOBAL_BUILTIN] = { 0, 1, 0, 0 },
+    [UOP_JUMP_TO_TOP] = { 0, 0, 0, 0 },
+};
+
+
+/* Generic binary operations, the operand of UOP_BINARY_OP */
+
+static PyObject *
+power(PyObject *base, PyObject *exp)
+{
+    return PyNumber_Power(base, exp, Py_None);
+}
+
+static PyObject *
+inplace_power(PyObject *base, PyObject *exp)
+{
+    return PyNumber_InPlacePower(base, exp, Py_None);
+}
+
+static const binaryfunc binary_ops[] = {
+    [NB_ADD] = PyNumber_Add,
+    [NB_AND] = PyNumber_And,
+    [NB_FLOOR_DIVIDE] = PyNumber_FloorDivide,
+    [NB_LSHIFT] = PyNumber_Lshift,
+    [NB_MATRIX_MULTIPLY] = PyNumber_MatrixMultiply,
+    [NB_MULTIPLY] = PyNumber_Multiply,
+    [NB_REMAINDER] = PyNumber_Remainder,
+    [NB_OR] = PyNumber_Or,
+    [NB_POWER] = power,
+    [NB_RSHIFT] = PyNumber_Rshift,
+    [NB_SUBTRACT] = PyNumber_Subtract,
+    [NB_TRUE_DIVIDE] = PyNumber_TrueDivide,
+    [NB_XOR] = PyNumber_Xor,
+    [NB_INPLACE_ADD] = PyNumber_InPlaceAdd,
+    [NB_INPLACE_AND] = PyNumber_InPlaceAnd,
+    [NB_INPLACE_FLOOR_DIVIDE] = PyNumber_InPlaceFloorDivide,
+    [NB_INPLACE_LSHIFT] = PyNumber_InPlaceLshift,
+    [NB_INPLACE_MATRIX_MULTIPLY] = PyNumber_InPlaceMatrixMultiply,
+    [NB_INPLACE_MULTIPLY] = PyNumber_InPlaceMultiply,
+    [NB_INPLACE_REMAINDER] = PyNumber_InPlaceRemainder,
+    [NB_INPLACE_OR] = PyNumber_InPlaceOr,
+    [NB_INPLACE_POWER] = inplace_power,
+    [NB_INPLACE_RSHIFT] = PyNumber_InPlaceRshift,
+    [NB_INPLACE_SUBTRACT] = PyNumber_InPlaceSubtract,
+    [NB_INPLACE_TRUE_DIVIDE] = PyNumber_InPlaceTrueDivide,
+    [NB_INPLACE_XOR] = PyNumber_InPlaceXor,
+};
+
+
+
+/* Projection */
+
+static int
+is_flipped(_PyTier2Entry *entry, int index)
+{
+    for (int i = 0; i < entry->nflipped; i++) {
+        if (entry->flipped[i] == index) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static _PyUOpInstruction *
+add_uop(_PyUOpInstruction *trace, int *length, int opcode, int oparg,
+        int target, uint64_t operand)
+{
+    _PyUOpInstruction *uop = &trace[(*length)++];
+    uop->opcode = opcode;
+    uop->flags = 0;
+    uop->borrowed = 0;
+    uop->oparg = oparg;
+    uop->target = target;
+    uop->jump_target = -1;
+    uop->exits = 0;
+    uop->operand = operand;
+    return uop;
+}
+
+#define ADD(OP, ARG, OPERAND) \
+    add_uop(trace, &length, UOP_ ## OP, (ARG), target, (uint64_t)(OPERAND))
+
+#define GUARD(DEPTH, TYPE) \
+    ADD(GUARD_TYPE, (DEPTH), (uintptr_t)(TYPE))
+
+#define CACHE0() \
+    (&_GetSpecializedCacheEntryForInstruction(first_instr, i+1, oparg)->adaptive)
+
+/* Lower the loop starting at entry->start into uops, following the
+ * quickened instructions up to a jump back to the start.
+ * Returns the number of uops, or -1 if the loop cannot be traced. */
+static int
+project_trace(PyCodeObject *co, _PyTier2Entry *entry,
+              _PyUOpInstruction *trace)
+{
+    const _Py_CODEUNIT *first_instr = co->co_firstinstr;
+    int ninstrs = (int)(PyBytes_GET_SIZE(co->co_code) / sizeof(_Py_CODEUNIT));
+    int length = 0;
+    int i = entry->start;
+    for (;;) {
+        /* No instruction is lowered to more than three uops */
+        if (i >= ninstrs || length + 3 > MAX_TRACE_LENGTH) {
+            return -1;
+        }
+        /* Exits resume at the first EXTENDED_ARG, so that the
+         * instruction is decoded again with its full argument. */
+        int target = i;
+        int opcode = _Py_OPCODE(first_instr[i]);
+        int oparg = _Py_OPARG(first_instr[i]);
+        while (opcode == EXTENDED_ARG) {
+            if (++i >= ninstrs) {
+                return -1;
+            }
+            opcode = _Py_OPCODE(first_instr[i]);
+            oparg = (oparg << 8) | _Py_OPARG(first_instr[i]);
+        }
+        int next = i + 1;
+        int jump = -1, fallthrough = -1;
+        _PyUOpInstruction *branch = NULL;
+        /* Superinstructions are lowered as their first half only.
+         * The second half is still present as the next instruction. */
+        switch (opcode) {
+            case NOP:
+                break;
+            case LOAD_FAST:
+            case LOAD_FAST__LOAD_FAST:
+            case LOAD_FAST__LOAD_CONST:
+                ADD(LOAD_FAST, oparg, 0);
+                break;
+            case LOAD_CONST:
+            case LOAD_CONST__LOAD_FAST:
+                ADD(LOAD_CONST, 0, PyTuple_GET_ITEM(co->co_consts, oparg));
+                break;
+            case STORE_FAST:
+            case STORE_FAST__LOAD_FAST:
+            case STORE_FAST__STORE_FAST:
+                ADD(STORE_FAST, oparg, 0);
+                break;
+            case POP_TOP:
+                ADD(POP_TOP, 0, 0);
+                break;
+            case DUP_TOP:
+                ADD(DUP_TOP, 0, 0);
+                break;
+            case ROT_TWO:
+                ADD(ROT_TWO, 0, 0);
+                break;
+            case BINARY_OP:
+                ADD(BINARY_OP, oparg, binary_ops[oparg]);
+                break;
+            case BINARY_OP_ADAPTIVE:
+            case BINARY_OP_ADD_UNICODE:
+            case BINARY_OP_INPLACE_ADD_UNICODE:
+            {
+                int op = CACHE0()->original_oparg;
+                ADD(BINARY_OP, op, binary_ops[op]);
+                break;
+            }
+            case BINARY_OP_ADD_INT:
+                GUARD(1, &PyLong_Type);
+                GUARD(0, &PyLong_Type);
+                ADD(ADD_INT, 0, 0);
+                break;
+            case BINARY_OP_MULTIPLY_INT:
+                GUARD(1, &PyLong_Type);
+                GUARD(0, &PyLong_Type);
+                ADD(MULTIPLY_INT, 0, 0);
+                break;
+            case BINARY_OP_SUBTRACT_INT:
+                GUARD(1, &PyLong_Type);
+                GUARD(0, &PyLong_Type);
+                ADD(SUBTRACT_INT, 0, 0);
+                break;
+            case BINARY_OP_ADD_FLOAT:
+                GUARD(1, &PyFloat_Type);
+                GUARD(0, &PyFloat_Type);
+                ADD(ADD_FLOAT, 0, 0);
+                break;
+            case BINARY_OP_MULTIPLY_FLOAT:
+                GUARD(1, &PyFloat_Type);
+                GUARD(0, &PyFloat_Type);
+                ADD(MULTIPLY_FLOAT, 0, 0);
+                break;
+            case BINARY_OP_SUBTRACT_FLOAT:
+                GUARD(1, &PyFloat_Type);
+                GUARD(0, &PyFloat_Type);
+                ADD(SUBTRACT_FLOAT, 0, 0);
+                break;
+            case BINARY_SUBSCR:
+            case BINARY_SUBSCR_ADAPTIVE:
+            case BINARY_SUBSCR_DICT:
+                ADD(BINARY_SUBSCR, 0, 0);
+                break;
+            case BINARY_SUBSCR_LIST_INT:
+                GUARD(1, &PyList_Type);
+                GUARD(0, &PyLong_Type);
+                ADD(BINARY_SUBSCR_LIST_INT, 0, 0);
+                break;
+            case BINARY_SUBSCR_TUPLE_INT:
+                GUARD(1, &PyTuple_Type);
+                GUARD(0, &PyLong_Type);
+                ADD(BINARY_SUBSCR_TUPLE_INT, 0, 0);
+                break;
+            case STORE_SUBSCR:
+            case STORE_SUBSCR_ADAPTIVE:
+            case STORE_SUBSCR_DICT:
+                ADD(STORE_SUBSCR, 0, 0);
+                break;
+            case STORE_SUBSCR_LIST_INT:
+                GUARD(1, &PyList_Type);
+                GUARD(0, &PyLong_Type);
+                ADD(STORE_SUBSCR_LIST_INT, 0, 0);
+                break;
+            case COMPARE_OP:
+                ADD(COMPARE_OP, oparg, 0);
+                break;
+            case COMPARE_OP_ADAPTIVE:
+                ADD(COMPARE_OP, CACHE0()->original_oparg, 0);
+                break;
+            case COMPARE_OP_INT_JUMP:
+                GUARD(1, &PyLong_Type);
+                GUARD(0, &PyLong_Type);
+                branch = ADD(COMPARE_INT_BRANCH, CACHE0()->index, 0);
+                goto compare_and_branch;
+            case COMPARE_OP_FLOAT_JUMP:
+                GUARD(1, &PyFloat_Type);
+                GUARD(0, &PyFloat_Type);
+                branch = ADD(COMPARE_FLOAT_BRANCH, CACHE0()->index, 0);
+                goto compare_and_branch;
+            case COMPARE_OP_STR_JUMP:
+                GUARD(1, &PyUnicode_Type);
+                GUARD(0, &PyUnicode_Type);
+                branch = ADD(COMPARE_STR_BRANCH, CACHE0()->index, 0);
+            compare_and_branch:
+                /* Fused with the POP_JUMP_IF_XXX that follows */
+                jump = _Py_OPARG(first_instr[i+1]);
+                fallthrough = i + 2;
+                break;
+            case POP_JUMP_IF_FALSE:
+            case POP_JUMP_IF_TRUE:
+                branch = ADD(BRANCH, opcode == POP_JUMP_IF_TRUE, 0);
+                jump = oparg;
+                fallthrough = i + 1;
+                break;
+            case IS_OP:
+                ADD(IS_OP, oparg, 0);
+                break;
+            case JUMP_FORWARD:
+                next = i + 1 + oparg;
+                break;
+            case JUMP_ABSOLUTE:
+            case JUMP_ABSOLUTE_QUICK:
+                if (oparg != entry->start) {
+                    return -1;
+                }
+                ADD(JUMP_TO_TOP, 0, 0);
+                return length;
+            case FOR_ITER:
+                ADD(FOR_ITER, 0, 0)->jump_target = i + 1 + oparg;
+                break;
+            case FOR_ITER_ADAPTIVE:
+            case FOR_ITER_GEN:
+                ADD(FOR_ITER, 0, 0)->jump_target =
+                    i + 1 + CACHE0()->original_oparg;
+                break;
+            /* The specialized forms leave exhausted iterators to tier 1 */
+            case FOR_ITER_LIST:
+                ADD(FOR_ITER_LIST, 0, 0);
+                break;
+            case FOR_ITER_TUPLE:
+                ADD(FOR_ITER_TUPLE, 0, 0);
+                break;
+            case FOR_ITER_RANGE:
+                ADD(FOR_ITER_RANGE, 0, 0);
+                break;
+            case LOAD_GLOBAL_MODULE:
+            case LOAD_GLOBAL_BUILTIN:
+            {
+                SpecializedCacheEntry *caches =
+                    _GetSpecializedCacheEntryForInstruction(first_instr, i+1, oparg);
+                _PyLoadGlobalCache *cache1 = &caches[-1].load_global;
+                uint64_t versions = cache1->module_keys_version |
+                    ((uint64_t)cache1->builtin_keys_version << 32);
+                if (opcode == LOAD_GLOBAL_MODULE) {
+                    ADD(LOAD_GLOBAL_MODULE, caches[0].adaptive.index, versions);
+                }
+                else {
+                    ADD(LOAD_GLOBAL_BUILTIN, caches[0].adaptive.index, versions);
+                }
+                break;
+            }
+            default:
+                return -1;
+        }
+        if (branch != NULL) {
+            if (is_flipped(entry, target)) {
+                branch->flags |= UOP_JUMP;
+                branch->jump_target = fallthrough;
+                next = jump;
+            }
+            else {
+                branch->jump_target = jump;
+                next = fallthrough;
+            }
+            if (next == entry->start) {
+                /* Resuming at the start is fine if the trace has to exit
+                 * here, tier 1 checks the eval breaker on its own
+                 * back-edge. */
+                target = entry->start;
+                ADD(JUMP_TO_TOP, 0, 0);
+                return length;
+            }
+        }
+        /* Only forward jumps are followed */
+        if (next <= i) {
+            return -1;
+        }
+        i = next;
+    }
+}
+
+#undef ADD
+#undef GUARD
+#undef CACHE0
+
+
+/* Optimization passes */
+
+typedef struct {
+    /* Exact type, or NULL if unknown */
+    PyTypeObject *type;
+    /* Constant value (borrowed from the code object or the trace), or NULL */
+    PyObject *constant;
+    /* Index of the uop that pushed the value, or -1 */
+    int producer;
+} abstract_value;
+
+static void
+make_nop(_PyUOpInstruction *uop)
+{
+    uop->opcode = UOP_NOP;
+    uop->flags = 0;
+}
+
+static void
+make_load_const(_PyUOpInstruction *uop, PyObject *value)
+{
+    uop->opcode = UOP_LOAD_CONST;
+    uop->flags = 0;
+    uop->oparg = 0;
+    uop->operand = (uintptr_t)value;
+}
+
+static int
+only_nops_between(_PyUOpInstruction *trace, int start, int end)
+{
+    for (int pc = start + 1; pc < end; pc++) {
+        if (trace[pc].opcode != UOP_NOP) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/* Fold a binary operation on the two constants produced by the uops
+ * just before pc.  Returns the result (owned by *consts), or NULL. */
+static PyObject *
+fold_constants(_PyUOpInstruction *trace, int pc, abstract_value *left,
+               abstract_value *right, PyTypeObject *type, PyObject **consts)
+{
+    if (left->constant == NULL || right->constant == NULL ||
+        !Py_IS_TYPE(left->constant, type) ||
+        !Py_IS_TYPE(right->constant, type) ||
+        left->producer < 0 || right->producer < 0 ||
+        trace[left->producer].opcode != UOP_LOAD_CONST ||
+        trace[right->producer].opcode != UOP_LOAD_CONST ||
+        !only_nops_between(trace, left->producer, right->producer) ||
+        !only_nops_between(trace, right->producer, pc))
+    {
+        return NULL;
+    }
+    PyObject *res;
+    switch (trace[pc].opcode) {
+        case UOP_ADD_INT:
+        case UOP_ADD_FLOAT:
+            res = PyNumber_Add(left->constant, right->constant);
+            break;
+        case UOP_SUBTRACT_INT:
+        case UOP_SUBTRACT_FLOAT:
+            res = PyNumber_Subtract(left->constant, right->constant);
+            break;
+        default:
+            res = PyNumber_Multiply(left->constant, right->constant);
+            break;
+    }
+    if (res == NULL) {
+        PyErr_Clear();
+        return NULL;
+    }
+    if (*consts == NULL) {
+        *consts = PyList_New(0);
+    }
+    if (*consts == NULL || PyList_Append(*consts, res) < 0) {
+        PyErr_Clear();
+        Py_DECREF(res);
+        return NULL;
+    }
+    Py_DECREF(res);
+    make_nop(&trace[left->producer]);
+    make_nop(&trace[right->producer]);
+    make_load_const(&trace[pc], res);
+    return res;
+}
+
+/* Abstract interpretation over one iteration of the trace, tracking the
+ * type and constant value of stack items and locals.  Knowledge about
+ * locals is dropped when a uop may run arbitrary code.
+ * Removes redundant guards and propagates and folds constants. */
+static int
+optimize_abstract(PyCodeObject *co, _PyUOpInstruction *trace, int length,
+                  PyObject **consts, struct _Py_optimizer_stats *stats)
+{
+    abstract_value stack[MAX_ABSTRACT_STACK];
+    int nlocals = co->co_nlocalsplus;
+    abstract_value *locals = PyMem_Calloc(nlocals + 1, sizeof(abstract_value));
+    if (locals == NULL) {
+        return -1;
+    }
+    /* Items already on the stack when the loop starts are unknown */
+    int base = MAX_ABSTRACT_STACK / 4;
+    for (int k = 0; k < MAX_ABSTRACT_STACK; k++) {
+        stack[k].type = NULL;
+        stack[k].constant = NULL;
+        stack[k].producer = -1;
+    }
+    int sp = base;
+    int err = 0;
+    for (int pc = 0; pc < length; pc++) {
+        _PyUOpInstruction *uop = &trace[pc];
+        int opcode = uop->opcode;
+        if (sp - uop_info[opcode].popped < 0 ||
+            sp - uop_info[opcode].popped + uop_info[opcode].pushed > MAX_ABSTRACT_STACK)
+        {
+            err = -1;
+            break;
+        }
+        abstract_value res = { NULL, NULL, pc };
+        switch (opcode) {
+            case UOP_LOAD_FAST:
+                res.type = locals[uop->oparg].type;
+                res.constant = locals[uop->oparg].constant;
+                if (res.constant != NULL) {
+                    make_load_const(uop, res.constant);
+                    stats->constants_propagated++;
+                }
+                stack[sp++] = res;
+                break;
+            case UOP_LOAD_CONST:
+                res.constant = (PyObject *)(uintptr_t)uop->operand;
+                res.type = Py_TYPE(res.constant);
+                stack[sp++] = res;
+                break;
+            case UOP_STORE_FAST:
+                sp--;
+                locals[uop->oparg].type = stack[sp].type;
+                locals[uop->oparg].constant = stack[sp].constant;
+                break;
+            case UOP_DUP_TOP:
+                res = stack[sp-1];
+                res.producer = pc;
+                stack[sp-1].producer = pc;
+                stack[sp++] = res;
+                break;
+            case UOP_ROT_TWO:
+                res = stack[sp-1];
+                stack[sp-1] = stack[sp-2];
+                stack[sp-2] = res;
+                stack[sp-1].producer = stack[sp-2].producer = pc;
+                break;
+            case UOP_GUARD_TYPE:
+            {
+                abstract_value *value = &stack[sp-1-uop->oparg];
+                PyTypeObject *type = (PyTypeObject *)(uintptr_t)uop->operand;
+                if (value->type == type) {
+                    make_nop(uop);
+                    stats->guards_removed++;
+                }
+                else {
+                    value->type = type;
+                }
+                break;
+            }
+            case UOP_ADD_INT:
+            case UOP_MULTIPLY_INT:
+            case UOP_SUBTRACT_INT:
+            case UOP_ADD_FLOAT:
+            case UOP_MULTIPLY_FLOAT:
+            case UOP_SUBTRACT_FLOAT:
+            {
+                res.type = (opcode == UOP_ADD_INT || opcode == UOP_MULTIPLY_INT ||
+                            opcode == UOP_SUBTRACT_INT) ?
+                    &PyLong_Type : &PyFloat_Type;
+                res.constant = fold_constants(trace, pc, &stack[sp-2],
+                                              &stack[sp-1], res.type, consts);
+                if (res.constant != NULL) {
+                    stats->constants_folded++;
+                }
+                sp -= 2;
+                stack[sp++] = res;
+                break;
+            }
+            case UOP_IS_OP:
+                res.type = &PyBool_Type;
+                sp -= 2;
+                stack[sp++] = res;
+                break;
+            case UOP_FOR_ITER_RANGE:
+                res.type = &PyLong_Type;
+                stack[sp++] = res;
+                break;
+            default:
+                sp -= uop_info[opcode].popped;
+                for (int k = 0; k < uop_info[opcode].pushed; k++) {
+                    stack[sp++] = res;
+                }
+                break;
+        }
+        if (uop_info[opcode].escapes) {
+            memset(locals, 0, nlocals * sizeof(abstract_value));
+        }
+    }
+    PyMem_Free(locals);
+    return err;
+}
+
+/* Remove NOPs.  No uop refers to another by index at this point. */
+static int
+remove_nops(_PyUOpInstruction *trace, int length)
+{
+    int dest = 0;
+    for (int pc = 0; pc < length; pc++) {
+        if (trace[pc].opcode != UOP_NOP) {
+            trace[dest++] = trace[pc];
+        }
+    }
+    return dest;
+}
+
+static int
+is_load(_PyUOpInstruction *uop)
+{
+    return uop->opcode == UOP_LOAD_FAST || uop->opcode == UOP_LOAD_CONST;
+}
+
+/* A value loaded from a local or a constant can be borrowed if its
+ * consumer cannot escape, and only loads and guards run in between:
+ * nothing can then rebind the local before the value is consumed.
+ * Afterwards, record for each uop which stack items are borrowed, so
+ * that exits can turn them into strong references. */
+static int
+remove_increfs(_PyUOpInstruction *trace, int length,
+               struct _Py_optimizer_stats *stats)
+{
+    int producers[MAX_ABSTRACT_STACK];
+    int base = MAX_ABSTRACT_STACK / 4;
+    for (int k = 0; k < base; k++) {
+        producers[k] = -1;
+    }
+    int sp = base;
+    for (int pc = 0; pc < length; pc++) {
+        _PyUOpInstruction *uop = &trace[pc];
+        int popped = uop_info[uop->opcode].popped;
+        int pushed = uop_info[uop->opcode].pushed;
+        if (sp - popped < 0 || sp - popped + pushed > MAX_ABSTRACT_STACK) {
+            return -1;
+        }
+        for (int k = 0; k < popped; k++) {
+            int producer = producers[sp-1-k];
+            if (!(uop_info[uop->opcode].borrowable & (1 << k)) ||
+                producer < 0 || !is_load(&trace[producer]))
+            {
+                continue;
+            }
+            int between;
+            for (between = producer + 1; between < pc; between++) {
+                if (!is_load(&trace[between]) &&
+                    trace[between].opcode != UOP_GUARD_TYPE) {
+                    break;
+                }
+            }
+            if (between == pc) {
+                trace[producer].flags |= UOP_BORROW;
+                stats->increfs_removed++;
+            }
+        }
+        sp -= popped;
+        for (int k = 0; k < pushed; k++) {
+            producers[sp++] = pc;
+        }
+    }
+
+    uint8_t borrowed[MAX_ABSTRACT_STACK];
+    memset(borrowed, 0, sizeof(borrowed));
+    sp = base;
+    for (int pc = 0; pc < length; pc++) {
+        _PyUOpInstruction *uop = &trace[pc];
+        uint16_t mask = 0;
+        for (int k = 0; k < 16 && sp-1-k >= 0; k++) {
+            if (borrowed[sp-1-k]) {
+                mask |= 1 << k;
+            }
+        }
+        uop->borrowed = mask;
+        sp -= uop_info[uop->opcode].popped;
+        for (int k = 0; k < uop_info[uop->opcode].pushed; k++) {
+            borrowed[sp++] = (uop->flags & UOP_BORROW) != 0;
+        }
+    }
+    return 0;
+}
+
+static void
+free_trace(_PyUOpTrace *trace)
+{
+    assert(trace->running == 0);
+    if (trace->jit_code != NULL) {
+        _PyJIT_Free(trace);
+    }
+    Py_XDECREF(trace->consts);
+    PyMem_Free(trace);
+}
+
+static _PyUOpTrace *
+make_trace(PyCodeObject *co, _PyTier2Entry *entry,
+           struct _Py_optimizer_stats *stats)
+{
+    _PyUOpInstruction *buffer = PyMem_Malloc(
+        MAX_TRACE_LENGTH * sizeof(_PyUOpInstruction));
+    if (buffer == NULL) {
+        return NULL;
+    }
+    PyObject *consts = NULL;
+    _PyUOpTrace *trace = NULL;
+    int length = project_trace(co, entry, buffer);
+    if (length < 0) {
+        goto done;
+    }
+    if (optimize_abstract(co, buffer, length, &consts, stats) < 0) {
+        goto done;
+    }
+    length = remove_nops(buffer, length);
+    if (remove_increfs(buffer, length, stats) < 0) {
+        goto done;
+    }
+    trace = PyMem_Malloc(offsetof(_PyUOpTrace, uops) +
+                         length * sizeof(_PyUOpInstruction));
+    if (trace == NULL) {
+        goto done;
+    }
+    trace->start = entry->start;
+    trace->valid = 1;
+    trace->running = 0;
+    trace->flip = -1;
+    trace->iterations = 0;
+    trace->deopts = 0;
+    trace->consts = consts;
+    consts = NULL;
+    trace->jit_code = NULL;
+    trace->jit_size = 0;
+    trace->length = length;
+    memcpy(trace->uops, buffer, length * sizeof(_PyUOpInstruction));
+done:
+    Py_XDECREF(consts);
+    PyMem_Free(buffer);
+    return trace;
+}
+
+
+/* Micro-op interpreter */
+
+/* Turn borrowed references on the stack into strong ones before
+ * handing the stack back to tier 1. */
+static void
+make_stack_strong(_PyUOpInstruction *uop, PyObject **stack_pointer)
+{
+    for (int k = 0; k < 16; k++) {
+        if (uop->borrowed & (1 << k)) {
+            Py_INCREF(stack_pointer[-1-k]);
+        }
+    }
+}
+
+/* Common exit path of the interpreter and of JIT-compiled traces.
+ * Sets *resume to the instruction tier 1 continues with, and returns 1,
+ * or -1 if that instruction raised an exception. */
+static int
+leave_trace(PyThreadState *tstate, _PyUOpTrace *trace,
+            _PyUOpInstruction *uop, int exit, PyObject **stack_pointer,
+            Py_ssize_t iterations, int *resume)
+{
+    struct _Py_optimizer_stats *stats = &tstate->interp->optimizer.stats;
+    int status = 1;
+    switch (exit) {
+        case _PyUOP_EXIT_DEOPT:
+            make_stack_strong(uop, stack_pointer);
+            stats->deopts++;
+            trace->deopts++;
+            *resume = uop->target;
+            break;
+        case _PyUOP_EXIT_SIDE:
+            stats->side_exits++;
+            if (++uop->exits >= FLIP_THRESHOLD &&
+                uop->exits > trace->iterations + iterations)
+            {
+                trace->flip = uop->target;
+            }
+            *resume = uop->jump_target;
+            break;
+        case _PyUOP_EXIT_LOOP:
+            *resume = uop->jump_target;
+            break;
+        case _PyUOP_EXIT_BREAK:
+            *resume = uop->target;
+            break;
+        case _PyUOP_EXIT_ERROR_WITH_STACK:
+            make_stack_strong(uop, stack_pointer);
+            /* fall through */
+        case _PyUOP_EXIT_ERROR:
+            *resume = uop->target;
+            status = -1;
+            break;
+        default:
+            Py_UNREACHABLE();
+    }
+    trace->iterations += iterations;
+    stats->iterations += iterations;
+    return status;
+}
+
+static int
+execute_trace(PyThreadState *tstate, InterpreterFrame *frame,
+              _PyUOpTrace *trace, PyObject ***stack_pointer_ptr, int *resume)
+{
+    _Py_atomic_int * const eval_breaker = &tstate->interp->ceval.eval_breaker;
+    PyObject **stack_pointer = *stack_pointer_ptr;
+    PyObject **localsplus = frame->localsplus;
+    _PyUOpInstruction *uop = trace->uops;
+    Py_ssize_t iterations = 0;
+    int exit;
+
+    for (;;) {
+        int oparg = uop->oparg;
+        uint64_t operand = uop->operand;
+        int flags = uop->flags;
+        int borrowed = uop->borrowed;
+        int target = uop->target;
+        switch (uop->opcode) {
+
+#include "uop_cases.h"
+
+            case UOP_JUMP_TO_TOP:
+                iterations++;
+                if (_Py_atomic_load_relaxed(eval_breaker) ||
+                    tstate->cframe->use_tracing)
+                {
+                    exit = _PyUOP_EXIT_BREAK;
+                    goto done;
+                }
+                uop = trace->uops;
+                continue;
+
+            default:
+                Py_UNREACHABLE();
+        }
+        uop++;
+    }
+
+deopt:
+    exit = _PyUOP_EXIT_DEOPT;
+    goto done;
+side_exit:
+    exit = _PyUOP_EXIT_SIDE;
+    goto done;
+loop_exit:
+    exit = _PyUOP_EXIT_LOOP;
+    goto done;
+error_with_stack:
+    exit = _PyUOP_EXIT_ERROR_WITH_STACK;
+    goto done;
+error:
+    exit = _PyUOP_EXIT_ERROR;
+done:
+    *stack_pointer_ptr = stack_pointer;
+    return leave_trace(tstate, trace, uop, exit, stack_pointer,
+                       iterations, resume);
+}
+
+static int
+execute_jit(PyThreadState *tstate, InterpreterFrame *frame,
+            _PyUOpTrace *trace, PyObject ***stack_pointer_ptr, int *resume)
+{
+    _PyJITState state;
+    state.tstate = tstate;
+    state.iterations = 0;
+    state.exit = -1;
+    state.index = -1;
+    _PyJITFunction func = (_PyJITFunction)trace->jit_code;
+    PyObject **stack_pointer = func(&state, frame, *stack_pointer_ptr);
+    assert(0 <= state.index && state.index < trace->length);
+    *stack_pointer_ptr = stack_pointer;
+    return leave_trace(tstate, trace, &trace->uops[state.index], state.exit,
+                       stack_pointer, state.iterations, resume);
+}
+
+
+/* Per-code table of loops */
+
+static _PyTier2Entry *
+get_entry(PyCodeObject *co, int start)
+{
+    struct _PyTier2Table *table = co->co_tier2;
+    int count = 0;
+    if (table != NULL) {
+        count = table->count;
+        for (int i = 0; i < count; i++) {
+            if (table->entries[i].start == start) {
+                return &table->entries[i];
+            }
+        }
+    }
+    table = PyMem_Realloc(table, offsetof(struct _PyTier2Table, entries) +
+                                 (count + 1) * sizeof(_PyTier2Entry));
+    if (table == NULL) {
+        return NULL;
+    }
+    co->co_tier2 = table;
+    table->count = count + 1;
+    _PyTier2Entry *entry = &table->entries[count];
+    memset(entry, 0, sizeof(_PyTier2Entry));
+    entry->start = start;
+    return entry;
+}
+
+static void
+flip_branch(_PyTier2Entry *entry, int index)
+{
+    for (int i = 0; i < entry->nflipped; i++) {
+        if (entry->flipped[i] == index) {
+            entry->flipped[i] = entry->flipped[--entry->nflipped];
+            return;
+        }
+    }
+    if (entry->nflipped < MAX_FLIPPED_BRANCHES) {
+        entry->flipped[entry->nflipped++] = index;
+    }
+}
+
+int
+_PyOptimizer_RunLoop(PyThreadState *tstate, InterpreterFrame *frame,
+                     int start, PyObject ***stack_pointer, int *resume)
+{
+    PyCodeObject *co = frame->f_code;
+    struct _Py_optimizer_stats *stats = &tstate->interp->optimizer.stats;
+    _PyTier2Entry *entry = get_entry(co, start);
+    if (entry == NULL) {
+        return 0;
+    }
+    _PyUOpTrace *trace = entry->trace;
+    if (trace != NULL && !trace->valid) {
+        if (trace->running) {
+            return 0;
+        }
+        free_trace(trace);
+        entry->trace = trace = NULL;
+    }
+    if (trace == NULL) {
+        if (++entry->counter < (TRACE_THRESHOLD << entry->backoff)) {
+            return 0;
+        }
+        entry->counter = 0;
+        trace = make_trace(co, entry, stats);
+        if (trace == NULL) {
+            stats->traces_failed++;
+            if (entry->backoff < MAX_BACKOFF) {
+                entry->backoff++;
+            }
+            return 0;
+        }
+        stats->traces_created++;
+        entry->backoff = 0;
+        entry->trace = trace;
+        if (tstate->interp->optimizer.jit) {
+            if (_PyJIT_Compile(trace) == 0) {
+                stats->jit_traces++;
+                stats->jit_code_size += trace->jit_size;
+            }
+            else {
+                stats->jit_failures++;
+            }
+        }
+    }
+    stats->executions++;
+    trace->running++;
+    int status;
+    if (trace->jit_code != NULL) {
+        status = execute_jit(tstate, frame, trace, stack_pointer, resume);
+    }
+    else {
+        status = execute_trace(tstate, frame, trace, stack_pointer, resume);
+    }
+    trace->running--;
+    if (trace->flip >= 0) {
+        /* The table may have been resized while the trace was running */
+        entry = get_entry(co, start);
+        if (entry != NULL && entry->trace == trace &&
+            entry->retraces < MAX_RETRACES)
+        {
+            flip_branch(entry, trace->flip);
+            entry->retraces++;
+            trace->valid = 0;
+            stats->traces_invalidated++;
+        }
+        trace->flip = -1;
+    }
+    if (trace->valid && trace->deopts >= DEOPT_THRESHOLD &&
+        trace->deopts > trace->iterations)
+    {
+        entry = get_entry(co, start);
+        if (entry != NULL && entry->trace == trace) {
+            trace->valid = 0;
+            entry->counter = 0;
+            if (entry->backoff < MAX_BACKOFF) {
+                entry->backoff++;
+            }
+            stats->traces_invalidated++;
+        }
+    }
+    return status;
+}
+
+void
+_PyOptimizer_ClearCode(PyCodeObject *co)
+{
+    struct _PyTier2Table *table = co->co_tier2;
+    if (table == NULL) {
+        return;
+    }
+    for (int i = 0; i < table->count; i++) {
+        if (table->entries[i].trace != NULL) {
+            free_trace(table->entries[i].trace);
+        }
+    }
+    PyMem_Free(table);
+    co->co_tier2 = NULL;
+}
+
+void
+_PyOptimizer_Init(PyInterpreterState *interp)
+{
+    const PyConfig *config = _PyInterpreterState_GetConfig(interp);
+    /* -X jit compiles the traces of -X uops to machine code */
+    interp->optimizer.jit =
+        (_Py_get_xoption(&config->xoptions, L"jit") != NULL);
+    interp->optimizer.enabled = interp->optimizer.jit ||
+        (_Py_get_xoption(&config->xoptions, L"uops") != NULL);
+}
+
+#define ADD_STAT_TO_DICT(res, field) \
+    do { \
+        PyObject *val = PyLong_FromSsize_t(stats->field); \
+        if (val == NULL) { \
+            Py_DECREF(res); \
+            return NULL; \
+        } \
+        if (PyDict_SetItemString(res, #field, val) == -1) { \
+            Py_DECREF(res); \
+            Py_DECREF(val); \
+            return NULL; \
+        } \
+        Py_DECREF(val); \
+    } while(0);
+
+PyObject *
+_PyOptimizer_GetStats(PyInterpreterState *interp)
+{
+    struct _Py_optimizer_stats *stats = &interp->optimizer.stats;
+    PyObject *res = PyDict_New();
+    if (res == NULL) {
+        return NULL;
+    }
+    ADD_STAT_TO_DICT(res, traces_created);
+    ADD_STAT_TO_DICT(res, traces_failed);
+    ADD_STAT_TO_DICT(res, traces_invalidated);
+    ADD_STAT_TO_DICT(res, executions);
+    ADD_STAT_TO_DICT(res, iterations);
+    ADD_STAT_TO_DICT(res, deopts);
+    ADD_STAT_TO_DICT(res, side_exits);
+    ADD_STAT_TO_DICT(res, guards_removed);
+    ADD_STAT_TO_DICT(res, increfs_removed);
+    ADD_STAT_TO_DICT(res, constants_propagated);
+    ADD_STAT_TO_DICT(res, constants_folded);
+    ADD_STAT_TO_DICT(res, jit_traces);
+    ADD_STAT_TO_DICT(res, jit_failures);
+    ADD_STAT_TO_DICT(res, jit_code_size);
+    return res;
+}
@@ -8,6 +8,7 @@
 #include "pycore_import.h"        // _PyImport_BootstrapImp()
 #include "pycore_initconfig.h"    // _PyStatus_OK()
 #include "pycore_object.h"        // _PyDebug_PrintTotalRefs()
+#include "pycore_optimizer.h"     // _PyOptimizer_Init()
 #include "pycore_pathconfig.h"    // _PyConfig_WritePathConfig()
 #include "pycore_pyerrors.h"      // _PyErr_Occurred()
 #include "pycore_pylifecycle.h"   // _PyErr_Print()
@@ -1100,6 +1101,10 @@ init_interp_main(PyThreadState *tstate)
         }
     }
 
+    _PyOptimizer_Init(interp);
+    interp->specialization_stats =
+        (_Py_get_xoption(&config->xoptions, L"specialization_stats") != NULL);
+
     status = _PyUnicode_InitEncodings(tstate);
     if (_PyStatus_EXCEPTION(status)) {
         return status;
@@ -1647,6 +1652,8 @@ finalize_interp_types(PyInterpreterState *interp)
     _PyTuple_Fini(interp);
 
     _PySlice_Fini(interp);
+    _PyMethod_Fini(interp);
+    _PyRange_Fini(interp);
 
     _PyBytes_Fini(interp);
     _PyUnicode_Fini(interp);
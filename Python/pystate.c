@@ -96,6 +96,13 @@ _PyRuntimeState_Init_impl(_PyRuntimeState *runtime)
     }
     runtime->unicode_ids.next_index = unicode_next_index;
 
+#ifdef EXPERIMENTAL_ISOLATED_SUBINTERPRETERS
+    runtime->obmalloc_mutex = PyThread_allocate_lock();
+    if (runtime->obmalloc_mutex == NULL) {
+        return _PyStatus_NO_MEMORY();
+    }
+#endif
+
     return _PyStatus_OK();
 }
 
@@ -128,6 +135,9 @@ _PyRuntimeState_Fini(_PyRuntimeState *runtime)
     FREE_LOCK(runtime->interpreters.mutex);
     FREE_LOCK(runtime->xidregistry.mutex);
     FREE_LOCK(runtime->unicode_ids.lock);
+#ifdef EXPERIMENTAL_ISOLATED_SUBINTERPRETERS
+    FREE_LOCK(runtime->obmalloc_mutex);
+#endif
 
 #undef FREE_LOCK
     PyMem_SetAllocator(PYMEM_DOMAIN_RAW, &old_alloc);
@@ -151,13 +161,19 @@ _PyRuntimeState_ReInitThreads(_PyRuntimeState *runtime)
     int reinit_main_id = _PyThread_at_fork_reinit(&runtime->interpreters.main->id_mutex);
     int reinit_xidregistry = _PyThread_at_fork_reinit(&runtime->xidregistry.mutex);
     int reinit_unicode_ids = _PyThread_at_fork_reinit(&runtime->unicode_ids.lock);
+#ifdef EXPERIMENTAL_ISOLATED_SUBINTERPRETERS
+    int reinit_obmalloc = _PyThread_at_fork_reinit(&runtime->obmalloc_mutex);
+#else
+    int reinit_obmalloc = 0;
+#endif
 
     PyMem_SetAllocator(PYMEM_DOMAIN_RAW, &old_alloc);
 
     if (reinit_interp < 0
         || reinit_main_id < 0
         || reinit_xidregistry < 0
-        || reinit_unicode_ids < 0)
+        || reinit_unicode_ids < 0
+        || reinit_obmalloc < 0)
     {
         return _PyStatus_ERR("Failed to reinitialize runtime locks");
 
@@ -225,6 +241,13 @@ PyInterpreterState_New(void)
     if (_PyEval_InitState(&interp->ceval) < 0) {
         goto out_of_memory;
     }
+#ifdef EXPERIMENTAL_ISOLATED_SUBINTERPRETERS
+    /* Subinterpreters get their own pymalloc pools, the main interpreter
+       (created with tstate == NULL) keeps the static ones */
+    if (tstate != NULL && _PyObject_InitAllocatorState(interp) < 0) {
+        goto out_of_memory;
+    }
+#endif
 
     _PyGC_InitState(&interp->gc);
     PyConfig_InitPythonConfig(&interp->config);
@@ -248,6 +271,9 @@ PyInterpreterState_New(void)
             _PyErr_SetString(tstate, PyExc_RuntimeError,
                              "failed to get an interpreter ID");
         }
+#ifdef EXPERIMENTAL_ISOLATED_SUBINTERPRETERS
+        _PyObject_FiniAllocatorState(interp);
+#endif
         PyMem_RawFree(interp);
         interp = NULL;
     }
@@ -410,6 +436,9 @@ PyInterpreterState_Delete(PyInterpreterState *interp)
     if (interp->id_mutex != NULL) {
         PyThread_free_lock(interp->id_mutex);
     }
+#ifdef EXPERIMENTAL_ISOLATED_SUBINTERPRETERS
+    _PyObject_FiniAllocatorState(interp);
+#endif
     PyMem_RawFree(interp);
 }
 
@@ -691,6 +720,7 @@ new_threadstate(PyInterpreterState *interp, int init)
     tstate->datastack_limit = (PyObject **)(((char *)tstate->datastack_chunk) + DATA_STACK_CHUNK_SIZE);
     /* Mark trace_info as uninitialized */
     tstate->trace_info.code = NULL;
+    tstate->obmalloc_cache = _PyObject_NewThreadCache();
 
     if (init) {
         _PyThreadState_Init(tstate);
@@ -841,6 +871,13 @@ _PyInterpreterState_ClearModules(PyInterpreterState *interp)
         if (PyModule_Check(m)) {
             /* cleanup the saved copy of module dicts */
             PyModuleDef *md = PyModule_GetDef(m);
+#ifdef EXPERIMENTAL_ISOLATED_SUBINTERPRETERS
+            /* The copies are shared by all the interpreters, which may
+               run in parallel: the main interpreter clears them at exit */
+            if (md && !_Py_IsMainInterpreter(interp)) {
+                continue;
+            }
+#endif
             if (md) {
                 Py_CLEAR(md->m_base.m_copy);
             }
@@ -905,6 +942,9 @@ PyThreadState_Clear(PyThreadState *tstate)
     if (tstate->on_delete != NULL) {
         tstate->on_delete(tstate->on_delete_data);
     }
+
+    /* Last, since clearing the objects above fills the cache */
+    _PyObject_ClearThreadCache(tstate);
 }
 
 
@@ -1417,7 +1457,13 @@ _PyGILState_SetTstate(PyThreadState *tstate)
     struct _gilstate_runtime_state *gilstate = &tstate->interp->runtime->gilstate;
 
     gilstate->autoInterpreterState = tstate->interp;
+#ifdef EXPERIMENTAL_ISOLATED_SUBINTERPRETERS
+    /* _PyThreadState_Swap() already stored tstate in the TSS */
+    assert(PyThread_tss_get(&gilstate->autoTSSkey) == NULL
+           || PyThread_tss_get(&gilstate->autoTSSkey) == tstate);
+#else
     assert(PyThread_tss_get(&gilstate->autoTSSkey) == NULL);
+#endif
     assert(tstate->gilstate_counter == 0);
 
     _PyGILState_NoteThreadState(gilstate, tstate);
@@ -1808,6 +1854,7 @@ _register_xidata(struct _xidregistry *xidregistry, PyTypeObject *cls,
 }
 
 static void _register_builtins_for_crossinterpreter_data(struct _xidregistry *xidregistry);
+static int _buffer_shared(PyObject *, _PyCrossInterpreterData *);
 
 int
 _PyCrossInterpreterData_RegisterClass(PyTypeObject *cls,
@@ -1859,6 +1906,12 @@ _PyCrossInterpreterData_Lookup(PyObject *obj)
     }
     Py_DECREF(cls);
     PyThread_release_lock(xidregistry->mutex);
+    // Buffer exporters without a registered class share their memory.
+    // Subclasses of bytes are left out, like all other subclasses of
+    // registered classes.
+    if (getdata == NULL && PyObject_CheckBuffer(obj) && !PyBytes_Check(obj)) {
+        getdata = _buffer_shared;
+    }
     return getdata;
 }
 
@@ -1879,7 +1932,7 @@ _new_bytes_object(_PyCrossInterpreterData *data)
 static int
 _bytes_shared(PyObject *obj, _PyCrossInterpreterData *data)
 {
-    struct _shared_bytes_data *shared = PyMem_NEW(struct _shared_bytes_data, 1);
+    struct _shared_bytes_data *shared = PyMem_RawMalloc(sizeof(*shared));
     if (PyBytes_AsStringAndSize(obj, &shared->bytes, &shared->len) < 0) {
         return -1;
     }
@@ -1887,7 +1940,7 @@ _bytes_shared(PyObject *obj, _PyCrossInterpreterData *data)
     Py_INCREF(obj);
     data->obj = obj;  // Will be "released" (decref'ed) when data released.
     data->new_object = _new_bytes_object;
-    data->free = PyMem_Free;
+    data->free = PyMem_RawFree;
     return 0;
 }
 
@@ -1907,7 +1960,7 @@ _new_str_object(_PyCrossInterpreterData *data)
 static int
 _str_shared(PyObject *obj, _PyCrossInterpreterData *data)
 {
-    struct _shared_str_data *shared = PyMem_NEW(struct _shared_str_data, 1);
+    struct _shared_str_data *shared = PyMem_RawMalloc(sizeof(*shared));
     shared->kind = PyUnicode_KIND(obj);
     shared->buffer = PyUnicode_DATA(obj);
     shared->len = PyUnicode_GET_LENGTH(obj);
@@ -1915,7 +1968,7 @@ _str_shared(PyObject *obj, _PyCrossInterpreterData *data)
     Py_INCREF(obj);
     data->obj = obj;  // Will be "released" (decref'ed) when data released.
     data->new_object = _new_str_object;
-    data->free = PyMem_Free;
+    data->free = PyMem_RawFree;
     return 0;
 }
 
@@ -1964,6 +2017,219 @@ _none_shared(PyObject *obj, _PyCrossInterpreterData *data)
     return 0;
 }
 
+/* Objects that support the buffer protocol (memoryview, bytearray,
+   array.array, mmap, ...) are shared without copying.  The exporter's
+   buffer is acquired in the owning interpreter and kept in a raw-allocated,
+   refcounted block; the receiving interpreter gets a memoryview over a
+   small SharedBuffer object that refers to that block.  The buffer is
+   released, in the owning interpreter, once the last reference is gone.
+
+   The receiver's view is read-only, except when a writable memoryview is
+   sent: then the sender's memoryview is released as part of sending,
+   handing the memory off to the receiver. */
+
+struct _shared_buffer {
+    Py_buffer view;
+    int writable;
+    int64_t interp;
+    Py_ssize_t refcount;
+    PyThread_type_lock mutex;
+};
+
+static void
+_shared_buffer_free(void *arg)
+{
+    struct _shared_buffer *shared = (struct _shared_buffer *)arg;
+    PyBuffer_Release(&shared->view);
+    PyThread_free_lock(shared->mutex);
+    PyMem_RawFree(shared);
+}
+
+static void
+_shared_buffer_decref(void *arg)
+{
+    struct _shared_buffer *shared = (struct _shared_buffer *)arg;
+    PyThread_acquire_lock(shared->mutex, WAIT_LOCK);
+    Py_ssize_t refcount = --shared->refcount;
+    PyThread_release_lock(shared->mutex);
+    if (refcount > 0) {
+        return;
+    }
+
+    // The buffer must be released in the interpreter that exported it.
+    _PyRuntimeState *runtime = &_PyRuntime;
+    HEAD_LOCK(runtime);
+    PyInterpreterState *interp = interp_look_up_id(runtime, shared->interp);
+    HEAD_UNLOCK(runtime);
+    if (interp == NULL) {
+        // XXX The exporter went away with its interpreter, so the view
+        // can't be released any more.
+        PyThread_free_lock(shared->mutex);
+        PyMem_RawFree(shared);
+        return;
+    }
+    _call_in_interpreter(&runtime->gilstate, interp,
+                         _shared_buffer_free, shared);
+}
+
+typedef struct {
+    PyObject_HEAD
+    struct _shared_buffer *shared;
+} sharedbufferobject;
+
+static void
+sharedbuffer_dealloc(sharedbufferobject *self)
+{
+    _shared_buffer_decref(self->shared);
+    PyObject_Free(self);
+}
+
+static int
+sharedbuffer_getbuf(sharedbufferobject *self, Py_buffer *view, int flags)
+{
+    Py_buffer *src = &self->shared->view;
+
+    if ((flags & PyBUF_WRITABLE) == PyBUF_WRITABLE && !self->shared->writable) {
+        PyErr_SetString(PyExc_BufferError, "shared buffer is read-only");
+        return -1;
+    }
+    if ((flags & PyBUF_STRIDES) != PyBUF_STRIDES &&
+            !PyBuffer_IsContiguous(src, 'C')) {
+        PyErr_SetString(PyExc_BufferError,
+                        "shared buffer is not C-contiguous");
+        return -1;
+    }
+    if ((flags & PyBUF_INDIRECT) != PyBUF_INDIRECT && src->suboffsets != NULL) {
+        PyErr_SetString(PyExc_BufferError,
+                        "shared buffer requires suboffsets");
+        return -1;
+    }
+
+    *view = *src;
+    view->obj = (PyObject *)self;
+    Py_INCREF(self);
+    view->readonly = !self->shared->writable;
+    view->internal = NULL;
+    if ((flags & PyBUF_FORMAT) != PyBUF_FORMAT) {
+        view->format = NULL;
+    }
+    if ((flags & PyBUF_ND) != PyBUF_ND) {
+        view->shape = NULL;
+    }
+    if ((flags & PyBUF_STRIDES) != PyBUF_STRIDES) {
+        view->strides = NULL;
+    }
+    return 0;
+}
+
+static PyBufferProcs sharedbuffer_as_buffer = {
+    (getbufferproc)sharedbuffer_getbuf,     /* bf_getbuffer */
+    0,                                      /* bf_releasebuffer */
+};
+
+PyDoc_STRVAR(sharedbuffer_doc,
+"A buffer exported by another interpreter.");
+
+PyTypeObject _PySharedBuffer_Type = {
+    PyVarObject_HEAD_INIT(&PyType_Type, 0)
+    "SharedBuffer",                             /* tp_name */
+    sizeof(sharedbufferobject),                 /* tp_basicsize */
+    0,                                          /* tp_itemsize */
+    (destructor)sharedbuffer_dealloc,           /* tp_dealloc */
+    0,                                          /* tp_vectorcall_offset */
+    0,                                          /* tp_getattr */
+    0,                                          /* tp_setattr */
+    0,                                          /* tp_as_async */
+    0,                                          /* tp_repr */
+    0,                                          /* tp_as_number */
+    0,                                          /* tp_as_sequence */
+    0,                                          /* tp_as_mapping */
+    0,                                          /* tp_hash */
+    0,                                          /* tp_call */
+    0,                                          /* tp_str */
+    PyObject_GenericGetAttr,                    /* tp_getattro */
+    0,                                          /* tp_setattro */
+    &sharedbuffer_as_buffer,                    /* tp_as_buffer */
+    Py_TPFLAGS_DEFAULT,                         /* tp_flags */
+    sharedbuffer_doc,                           /* tp_doc */
+};
+
+static PyObject *
+_new_buffer_object(_PyCrossInterpreterData *data)
+{
+    struct _shared_buffer *shared = (struct _shared_buffer *)(data->data);
+    sharedbufferobject *exporter = PyObject_New(sharedbufferobject,
+                                                &_PySharedBuffer_Type);
+    if (exporter == NULL) {
+        return NULL;
+    }
+    PyThread_acquire_lock(shared->mutex, WAIT_LOCK);
+    shared->refcount++;
+    PyThread_release_lock(shared->mutex);
+    exporter->shared = shared;
+
+    PyObject *view = PyMemoryView_FromObject((PyObject *)exporter);
+    Py_DECREF(exporter);
+    return view;
+}
+
+static int
+_buffer_shared(PyObject *obj, _PyCrossInterpreterData *data)
+{
+    _Py_IDENTIFIER(release);
+    int writable = 0;
+    Py_INCREF(obj);
+    if (PyMemoryView_Check(obj)) {
+        // Hand the memory off: the new memoryview keeps the underlying
+        // export alive, while the sender's memoryview is released.
+        writable = !PyMemoryView_GET_BUFFER(obj)->readonly;
+        PyObject *handoff = PyMemoryView_FromObject(obj);
+        if (handoff == NULL) {
+            Py_DECREF(obj);
+            return -1;
+        }
+        PyObject *res = _PyObject_CallMethodIdNoArgs(obj, &PyId_release);
+        Py_DECREF(obj);
+        if (res == NULL) {
+            Py_DECREF(handoff);
+            return -1;
+        }
+        Py_DECREF(res);
+        obj = handoff;
+    }
+
+    struct _shared_buffer *shared = PyMem_RawMalloc(sizeof(*shared));
+    if (shared == NULL) {
+        Py_DECREF(obj);
+        PyErr_NoMemory();
+        return -1;
+    }
+    shared->mutex = PyThread_allocate_lock();
+    if (shared->mutex == NULL) {
+        PyMem_RawFree(shared);
+        Py_DECREF(obj);
+        PyErr_NoMemory();
+        return -1;
+    }
+    int flags = writable ? PyBUF_FULL : PyBUF_FULL_RO;
+    int res = PyObject_GetBuffer(obj, &shared->view, flags);
+    Py_DECREF(obj);  // The view holds its own reference.
+    if (res < 0) {
+        PyThread_free_lock(shared->mutex);
+        PyMem_RawFree(shared);
+        return -1;
+    }
+    shared->writable = writable;
+    shared->interp = _PyInterpreterState_GET()->id;
+    shared->refcount = 1;  // Owned by data, dropped in data->free.
+
+    data->data = (void *)shared;
+    // data->obj remains NULL; the view keeps the exporter alive.
+    data->new_object = _new_buffer_object;
+    data->free = _shared_buffer_decref;
+    return 0;
+}
+
 static void
 _register_builtins_for_crossinterpreter_data(struct _xidregistry *xidregistry)
 {
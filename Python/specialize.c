@@ -1,9 +1,11 @@
 #include "Python.h"
 #include "pycore_code.h"
 #include "pycore_dict.h"
+#include "pycore_frame.h"          // InterpreterFrame
 #include "pycore_long.h"
 #include "pycore_moduleobject.h"
 #include "pycore_object.h"
+#include "pycore_pystate.h"         // _PyThreadState_GET()
 #include "opcode.h"
 #include "structmember.h"         // struct PyMemberDef, T_OFFSET_EX
 
@@ -127,7 +129,13 @@ _Py_GetSpecializationStats(void) {
     err += add_stat_dict(stats, BINARY_SUBSCR, "binary_subscr");
     err += add_stat_dict(stats, STORE_ATTR, "store_attr");
     err += add_stat_dict(stats, CALL_FUNCTION, "call_function");
+    err += add_stat_dict(stats, CALL_FUNCTION_KW, "call_function_kw");
+    err += add_stat_dict(stats, CALL_METHOD, "call_method");
     err += add_stat_dict(stats, BINARY_OP, "binary_op");
+    err += add_stat_dict(stats, COMPARE_OP, "compare_op");
+    err += add_stat_dict(stats, FOR_ITER, "for_iter");
+    err += add_stat_dict(stats, STORE_SUBSCR, "store_subscr");
+    err += add_stat_dict(stats, UNPACK_SEQUENCE, "unpack_sequence");
     if (err < 0) {
         Py_DECREF(stats);
         return NULL;
@@ -184,7 +192,13 @@ _Py_PrintSpecializationStats(void)
     print_stats(out, &_specialization_stats[BINARY_SUBSCR], "binary_subscr");
     print_stats(out, &_specialization_stats[STORE_ATTR], "store_attr");
     print_stats(out, &_specialization_stats[CALL_FUNCTION], "call_function");
+    print_stats(out, &_specialization_stats[CALL_FUNCTION_KW], "call_function_kw");
+    print_stats(out, &_specialization_stats[CALL_METHOD], "call_method");
     print_stats(out, &_specialization_stats[BINARY_OP], "binary_op");
+    print_stats(out, &_specialization_stats[COMPARE_OP], "compare_op");
+    print_stats(out, &_specialization_stats[FOR_ITER], "for_iter");
+    print_stats(out, &_specialization_stats[STORE_SUBSCR], "store_subscr");
+    print_stats(out, &_specialization_stats[UNPACK_SEQUENCE], "unpack_sequence");
     if (out != stderr) {
         fclose(out);
     }
@@ -192,16 +206,53 @@ _Py_PrintSpecializationStats(void)
 
 #if COLLECT_SPECIALIZATION_STATS_DETAILED
 
-#define SPECIALIZATION_FAIL(opcode, kind) _specialization_stats[opcode].specialization_failure_kinds[kind]++
+#define GLOBAL_SPECIALIZATION_FAIL(opcode, kind) _specialization_stats[opcode].specialization_failure_kinds[kind]++
 
 
 #endif
 #endif
 
-#ifndef SPECIALIZATION_FAIL
-#define SPECIALIZATION_FAIL(opcode, kind) ((void)0)
+#ifndef GLOBAL_SPECIALIZATION_FAIL
+#define GLOBAL_SPECIALIZATION_FAIL(opcode, kind) ((void)0)
 #endif
 
+/* The stats of the instruction being specialized, or NULL if its code
+ * object does not keep any.  The specializer is only ever called for the
+ * instruction that the current frame is executing. */
+static _PyOpcodeStats *
+current_opstats(void)
+{
+    InterpreterFrame *frame = _PyThreadState_GET()->cframe->current_frame;
+    PyCodeObject *code = frame->f_code;
+    if (code->co_opstats == NULL) {
+        return NULL;
+    }
+    assert(frame->f_lasti >= 0);
+    return &code->co_opstats[frame->f_lasti];
+}
+
+#define STAT_INC(opname, name) \
+    do { \
+        GLOBAL_STAT_INC(opname, name); \
+        _PyOpcodeStats *opstats = current_opstats(); \
+        if (opstats != NULL) { \
+            opstats->name++; \
+        } \
+    } while (0)
+
+/* The kind is only computed if someone is going to look at it */
+#define SPECIALIZATION_FAIL(opcode, kind) \
+    do { \
+        _PyOpcodeStats *opstats = current_opstats(); \
+        if (opstats != NULL || COLLECT_SPECIALIZATION_STATS_DETAILED) { \
+            int fail_kind = (kind); \
+            GLOBAL_SPECIALIZATION_FAIL(opcode, fail_kind); \
+            if (opstats != NULL) { \
+                opstats->specialization_failure_kinds[fail_kind]++; \
+            } \
+        } \
+    } while (0)
+
 static SpecializedCacheOrInstruction *
 allocate(int cache_count, int instruction_count)
 {
@@ -234,8 +285,14 @@ static uint8_t adaptive_opcodes[256] = {
     [LOAD_METHOD] = LOAD_METHOD_ADAPTIVE,
     [BINARY_SUBSCR] = BINARY_SUBSCR_ADAPTIVE,
     [CALL_FUNCTION] = CALL_FUNCTION_ADAPTIVE,
+    [CALL_FUNCTION_KW] = CALL_FUNCTION_KW_ADAPTIVE,
+    [CALL_METHOD] = CALL_METHOD_ADAPTIVE,
     [STORE_ATTR] = STORE_ATTR_ADAPTIVE,
     [BINARY_OP] = BINARY_OP_ADAPTIVE,
+    [COMPARE_OP] = COMPARE_OP_ADAPTIVE,
+    [FOR_ITER] = FOR_ITER_ADAPTIVE,
+    [STORE_SUBSCR] = STORE_SUBSCR_ADAPTIVE,
+    [UNPACK_SEQUENCE] = UNPACK_SEQUENCE_ADAPTIVE,
 };
 
 /* The number of cache entries required for a "family" of instructions. */
@@ -245,8 +302,14 @@ static uint8_t cache_requirements[256] = {
     [LOAD_METHOD] = 3, /* _PyAdaptiveEntry, _PyAttrCache and _PyObjectCache */
     [BINARY_SUBSCR] = 0,
     [CALL_FUNCTION] = 2, /* _PyAdaptiveEntry and _PyObjectCache/_PyCallCache */
+    [CALL_FUNCTION_KW] = 2, /* _PyAdaptiveEntry and _PyCallCache */
+    [CALL_METHOD] = 2, /* _PyAdaptiveEntry and _PyCallCache */
     [STORE_ATTR] = 2, /* _PyAdaptiveEntry and _PyAttrCache */
     [BINARY_OP] = 1,  // _PyAdaptiveEntry
+    [COMPARE_OP] = 1, /* _PyAdaptiveEntry */
+    [FOR_ITER] = 1, /* _PyAdaptiveEntry */
+    [STORE_SUBSCR] = 0,
+    [UNPACK_SEQUENCE] = 1, /* _PyAdaptiveEntry */
 };
 
 /* Return the oparg for the cache_offset and instruction index.
@@ -400,6 +463,16 @@ _Py_Quicken(PyCodeObject *code) {
     if (quickened == NULL) {
         return -1;
     }
+    if (_PyInterpreterState_GET()->specialization_stats) {
+        assert(code->co_opstats == NULL);
+        code->co_opstats = PyMem_Calloc(instr_count, sizeof(_PyOpcodeStats));
+        if (code->co_opstats == NULL) {
+            PyMem_Free(quickened);
+            _Py_QuickenedCount--;
+            PyErr_NoMemory();
+            return -1;
+        }
+    }
     _Py_CODEUNIT *new_instructions = first_instruction(quickened);
     memcpy(new_instructions, code->co_firstinstr, size);
     optimize(quickened, instr_count);
@@ -408,6 +481,102 @@ _Py_Quicken(PyCodeObject *code) {
     return 0;
 }
 
+#define ADD_OPSTAT_TO_DICT(res, field) \
+    do { \
+        PyObject *val = PyLong_FromUnsignedLong(stats->field); \
+        if (val == NULL) { \
+            goto error; \
+        } \
+        int err = PyDict_SetItemString(res, #field, val); \
+        Py_DECREF(val); \
+        if (err < 0) { \
+            goto error; \
+        } \
+    } while (0)
+
+static PyObject *
+opstats_to_dict(_PyOpcodeStats *stats)
+{
+    PyObject *res = PyDict_New();
+    if (res == NULL) {
+        return NULL;
+    }
+    ADD_OPSTAT_TO_DICT(res, specialization_success);
+    ADD_OPSTAT_TO_DICT(res, specialization_failure);
+    ADD_OPSTAT_TO_DICT(res, hit);
+    ADD_OPSTAT_TO_DICT(res, deferred);
+    ADD_OPSTAT_TO_DICT(res, miss);
+    ADD_OPSTAT_TO_DICT(res, deopt);
+    ADD_OPSTAT_TO_DICT(res, unquickened);
+    PyObject *failure_kinds = PyTuple_New(SPECIALIZATION_FAILURE_KINDS);
+    if (failure_kinds == NULL) {
+        goto error;
+    }
+    for (int i = 0; i < SPECIALIZATION_FAILURE_KINDS; i++) {
+        PyObject *stat = PyLong_FromUnsignedLong(
+            stats->specialization_failure_kinds[i]);
+        if (stat == NULL) {
+            Py_DECREF(failure_kinds);
+            goto error;
+        }
+        PyTuple_SET_ITEM(failure_kinds, i, stat);
+    }
+    int err = PyDict_SetItemString(res, "specialization_failure_kinds",
+                                   failure_kinds);
+    Py_DECREF(failure_kinds);
+    if (err < 0) {
+        goto error;
+    }
+    return res;
+error:
+    Py_DECREF(res);
+    return NULL;
+}
+#undef ADD_OPSTAT_TO_DICT
+
+/* Return a dict mapping the offset of each instruction that has seen any
+ * specialization activity to a dict of its stats, or None if the code
+ * object does not keep stats. */
+PyObject *
+_PyCode_GetSpecializationStats(PyCodeObject *code)
+{
+    if (code->co_opstats == NULL) {
+        Py_RETURN_NONE;
+    }
+    PyObject *res = PyDict_New();
+    if (res == NULL) {
+        return NULL;
+    }
+    static const _PyOpcodeStats zero;
+    int instr_count = (int)(PyBytes_GET_SIZE(code->co_code) /
+                            sizeof(_Py_CODEUNIT));
+    for (int i = 0; i < instr_count; i++) {
+        _PyOpcodeStats *stats = &code->co_opstats[i];
+        if (memcmp(stats, &zero, sizeof(zero)) == 0) {
+            continue;
+        }
+        PyObject *offset = PyLong_FromLong(i * (long)sizeof(_Py_CODEUNIT));
+        if (offset == NULL) {
+            goto error;
+        }
+        PyObject *d = opstats_to_dict(stats);
+        if (d == NULL) {
+            Py_DECREF(offset);
+            goto error;
+        }
+        int err = PyDict_SetItem(res, offset, d);
+        Py_DECREF(offset);
+        Py_DECREF(d);
+        if (err < 0) {
+            goto error;
+        }
+    }
+    return res;
+error:
+    Py_DECREF(res);
+    return NULL;
+}
+
 static inline int
 initial_counter_value(void) {
     /* Starting value for the counter.
@@ -464,6 +633,11 @@ initial_counter_value(void) {
 #define SPEC_FAIL_BUFFER_SLICE 16
 #define SPEC_FAIL_SEQUENCE_INT 17
 
+/* Store subscr */
+/* SPEC_FAIL_ARRAY_*, SPEC_FAIL_LIST_SLICE and SPEC_FAIL_BUFFER_* as above */
+#define SPEC_FAIL_BYTEARRAY_INT 18
+#define SPEC_FAIL_BYTEARRAY_SLICE 19
+
 /* Binary add */
 
 #define SPEC_FAIL_NON_FUNCTION_SCOPE 11
@@ -482,6 +656,34 @@ initial_counter_value(void) {
 #define SPEC_FAIL_PYCFUNCTION_NOARGS 16
 #define SPEC_FAIL_BAD_CALL_FLAGS 17
 #define SPEC_FAIL_CLASS 18
+#define SPEC_FAIL_KWNAMES 19
+
+/* COMPARE_OP */
+#define SPEC_FAIL_STRING_COMPARE 13
+#define SPEC_FAIL_NOT_FOLLOWED_BY_COND_JUMP 14
+#define SPEC_FAIL_BIG_INT 15
+#define SPEC_FAIL_COMPARE_BYTES 16
+#define SPEC_FAIL_COMPARE_TUPLE 17
+#define SPEC_FAIL_COMPARE_LIST 18
+#define SPEC_FAIL_COMPARE_SET 19
+
+/* FOR_ITER */
+#define SPEC_FAIL_FOR_ITER_COROUTINE 6
+#define SPEC_FAIL_FOR_ITER_ASYNC_GENERATOR 7
+#define SPEC_FAIL_FOR_ITER_DICT_KEYS 8
+#define SPEC_FAIL_FOR_ITER_DICT_VALUES 9
+#define SPEC_FAIL_FOR_ITER_DICT_ITEMS 10
+#define SPEC_FAIL_FOR_ITER_LONG_RANGE 11
+#define SPEC_FAIL_FOR_ITER_REVERSED_LIST 12
+#define SPEC_FAIL_FOR_ITER_SET 13
+#define SPEC_FAIL_FOR_ITER_STRING 14
+#define SPEC_FAIL_FOR_ITER_ENUMERATE 15
+#define SPEC_FAIL_FOR_ITER_ZIP 16
+#define SPEC_FAIL_FOR_ITER_MAP 17
+
+/* UNPACK_SEQUENCE */
+#define SPEC_FAIL_UNPACK_SEQUENCE_ITERATOR 8
+#define SPEC_FAIL_UNPACK_SEQUENCE_SEQUENCE 9
 
 
 static int
@@ -643,7 +845,7 @@ specialize_dict_access(
             cache1->tp_version = type->tp_version_tag;
             cache0->index = (uint16_t)index;
             *instr = _Py_MAKECODEUNIT(values_op, _Py_OPARG(*instr));
-            return 0;
+            return 1;
         }
         else {
             if (dict == NULL || !PyDict_CheckExact(dict)) {
@@ -865,7 +1067,6 @@ _Py_Specialize_StoreAttr(PyObject *owner, _Py_CODEUNIT *instr, PyObject *name, S
 }
 
 
-#if COLLECT_SPECIALIZATION_STATS_DETAILED
 static int
 load_method_fail_kind(DesciptorClassification kind)
 {
@@ -899,7 +1100,6 @@ load_method_fail_kind(DesciptorClassification kind)
     }
     Py_UNREACHABLE();
 }
-#endif
 
 static int
 specialize_class_load_method(PyObject *owner, _Py_CODEUNIT *instr, PyObject *name,
@@ -1098,7 +1298,6 @@ _Py_Specialize_LoadGlobal(
     return 0;
 }
 
-#if COLLECT_SPECIALIZATION_STATS_DETAILED
 static int
 binary_subscr_faiL_kind(PyTypeObject *container_type, PyObject *sub)
 {
@@ -1136,7 +1335,6 @@ binary_subscr_faiL_kind(PyTypeObject *container_type, PyObject *sub)
     }
     return SPEC_FAIL_OTHER;
 }
-#endif
 
 int
 _Py_Specialize_BinarySubscr(
@@ -1180,69 +1378,247 @@ _Py_Specialize_BinarySubscr(
 }
 
 static int
-specialize_class_call(
-    PyObject *callable, _Py_CODEUNIT *instr,
-    int nargs, SpecializedCacheEntry *cache)
+store_subscr_fail_kind(PyTypeObject *container_type, PyObject *sub)
 {
-    SPECIALIZATION_FAIL(CALL_FUNCTION, SPEC_FAIL_CLASS);
-    return -1;
+    if (container_type == &PyByteArray_Type) {
+        if (PyLong_CheckExact(sub)) {
+            return SPEC_FAIL_BYTEARRAY_INT;
+        }
+        if (PySlice_Check(sub)) {
+            return SPEC_FAIL_BYTEARRAY_SLICE;
+        }
+        return SPEC_FAIL_OTHER;
+    }
+    else if (strcmp(container_type->tp_name, "array.array") == 0) {
+        if (PyLong_CheckExact(sub)) {
+            return SPEC_FAIL_ARRAY_INT;
+        }
+        if (PySlice_Check(sub)) {
+            return SPEC_FAIL_ARRAY_SLICE;
+        }
+        return SPEC_FAIL_OTHER;
+    }
+    else if (container_type->tp_as_buffer) {
+        if (PyLong_CheckExact(sub)) {
+            return SPEC_FAIL_BUFFER_INT;
+        }
+        if (PySlice_Check(sub)) {
+            return SPEC_FAIL_BUFFER_SLICE;
+        }
+        return SPEC_FAIL_OTHER;
+    }
+    else if (container_type->tp_as_sequence) {
+        if (PyLong_CheckExact(sub) && container_type->tp_as_sequence->sq_ass_item) {
+            return SPEC_FAIL_SEQUENCE_INT;
+        }
+    }
+    return SPEC_FAIL_OTHER;
+}
+
+int
+_Py_Specialize_StoreSubscr(
+    PyObject *container, PyObject *sub, _Py_CODEUNIT *instr)
+{
+    PyTypeObject *container_type = Py_TYPE(container);
+    if (container_type == &PyList_Type) {
+        if (PyLong_CheckExact(sub)) {
+            if ((Py_SIZE(sub) == 0 || Py_SIZE(sub) == 1)
+                && ((PyLongObject *)sub)->ob_digit[0] < (size_t)PyList_GET_SIZE(container))
+            {
+                *instr = _Py_MAKECODEUNIT(STORE_SUBSCR_LIST_INT,
+                                          initial_counter_value());
+                goto success;
+            }
+            SPECIALIZATION_FAIL(STORE_SUBSCR, SPEC_FAIL_OUT_OF_RANGE);
+            goto fail;
+        }
+        SPECIALIZATION_FAIL(STORE_SUBSCR,
+            PySlice_Check(sub) ? SPEC_FAIL_LIST_SLICE : SPEC_FAIL_OTHER);
+        goto fail;
+    }
+    if (container_type == &PyDict_Type) {
+        *instr = _Py_MAKECODEUNIT(STORE_SUBSCR_DICT, initial_counter_value());
+        goto success;
+    }
+    SPECIALIZATION_FAIL(STORE_SUBSCR,
+                        store_subscr_fail_kind(container_type, sub));
+    goto fail;
+fail:
+    STAT_INC(STORE_SUBSCR, specialization_failure);
+    assert(!PyErr_Occurred());
+    *instr = _Py_MAKECODEUNIT(_Py_OPCODE(*instr), ADAPTIVE_CACHE_BACKOFF);
+    return 0;
+success:
+    STAT_INC(STORE_SUBSCR, specialization_success);
+    assert(!PyErr_Occurred());
+    return 0;
 }
 
+/* Checks that a call to func with nargs positional arguments, followed by
+ * the keyword arguments named in kwnames (which may be NULL), can be laid
+ * out directly in the localsplus array of the new frame: the keywords must
+ * name the parameters immediately following the positional arguments, in
+ * order, and any remaining parameters must be filled from func_defaults.
+ * Fills in the _PyCallCache on success.
+ */
 static int
-specialize_py_call(
-    PyFunctionObject *func, _Py_CODEUNIT *instr,
-    int nargs, SpecializedCacheEntry *cache)
+specialize_py_call_layout(
+    PyFunctionObject *func, int opcode, int nargs, PyObject *kwnames,
+    _PyCallCache *cache1)
 {
-    _PyCallCache *cache1 = &cache[-1].call;
     /* Exclude generator or coroutines for now */
     PyCodeObject *code = (PyCodeObject *)func->func_code;
     int flags = code->co_flags;
     if (flags & (CO_GENERATOR | CO_COROUTINE | CO_ASYNC_GENERATOR)) {
-        SPECIALIZATION_FAIL(CALL_FUNCTION, SPEC_FAIL_GENERATOR);
+        SPECIALIZATION_FAIL(opcode, SPEC_FAIL_GENERATOR);
         return -1;
     }
-    if ((flags & (CO_VARKEYWORDS | CO_VARARGS)) || code->co_kwonlyargcount) {
-        SPECIALIZATION_FAIL(CALL_FUNCTION, SPEC_FAIL_COMPLEX_PARAMETERS);
+    if (flags & (CO_VARKEYWORDS | CO_VARARGS)) {
+        SPECIALIZATION_FAIL(opcode, SPEC_FAIL_COMPLEX_PARAMETERS);
         return -1;
     }
     if ((flags & CO_OPTIMIZED) == 0) {
-        SPECIALIZATION_FAIL(CALL_FUNCTION, SPEC_FAIL_CO_NOT_OPTIMIZED);
+        SPECIALIZATION_FAIL(opcode, SPEC_FAIL_CO_NOT_OPTIMIZED);
         return -1;
     }
     if (code->co_nfreevars) {
-        SPECIALIZATION_FAIL(CALL_FUNCTION, SPEC_FAIL_FREE_VARS);
+        SPECIALIZATION_FAIL(opcode, SPEC_FAIL_FREE_VARS);
         return -1;
     }
     int argcount = code->co_argcount;
+    int kwonlycount = code->co_kwonlyargcount;
+    int nkwargs = kwnames == NULL ? 0 : (int)PyTuple_GET_SIZE(kwnames);
+    int total = nargs + nkwargs;
+    if (nargs > argcount || total > argcount + kwonlycount) {
+        SPECIALIZATION_FAIL(opcode, SPEC_FAIL_WRONG_NUMBER_ARGUMENTS);
+        return -1;
+    }
+    if (nkwargs && nargs < code->co_posonlyargcount) {
+        SPECIALIZATION_FAIL(opcode, SPEC_FAIL_KWNAMES);
+        return -1;
+    }
+    for (int i = 0; i < nkwargs; i++) {
+        /* Both names are interned by the compiler */
+        if (PyTuple_GET_ITEM(kwnames, i) !=
+            PyTuple_GET_ITEM(code->co_localsplusnames, nargs + i))
+        {
+            SPECIALIZATION_FAIL(opcode, SPEC_FAIL_KWNAMES);
+            return -1;
+        }
+    }
+    if (kwonlycount && total != argcount + kwonlycount) {
+        /* Keyword-only defaults live in a dict */
+        SPECIALIZATION_FAIL(opcode, SPEC_FAIL_COMPLEX_PARAMETERS);
+        return -1;
+    }
     int defcount = func->func_defaults == NULL ? 0 : (int)PyTuple_GET_SIZE(func->func_defaults);
     assert(defcount <= argcount);
     int min_args = argcount-defcount;
-    if (nargs > argcount || nargs < min_args) {
-        SPECIALIZATION_FAIL(CALL_FUNCTION, SPEC_FAIL_WRONG_NUMBER_ARGUMENTS);
+    if (total < min_args) {
+        SPECIALIZATION_FAIL(opcode, SPEC_FAIL_WRONG_NUMBER_ARGUMENTS);
         return -1;
     }
-    assert(nargs <= argcount && nargs >= min_args);
-    int defstart = nargs - min_args;
-    int deflen = argcount - nargs;
+    int defstart = 0;
+    int deflen = 0;
+    if (total < argcount) {
+        defstart = total - min_args;
+        deflen = argcount - total;
+    }
     assert(defstart >= 0 && deflen >= 0);
     assert(deflen == 0 || func->func_defaults != NULL);
     if (defstart > 0xffff || deflen > 0xffff) {
-        SPECIALIZATION_FAIL(CALL_FUNCTION, SPEC_FAIL_OUT_OF_RANGE);
+        SPECIALIZATION_FAIL(opcode, SPEC_FAIL_OUT_OF_RANGE);
         return -1;
     }
     int version = _PyFunction_GetVersionForCurrentState(func);
     if (version == 0) {
-        SPECIALIZATION_FAIL(CALL_FUNCTION, SPEC_FAIL_OUT_OF_VERSIONS);
+        SPECIALIZATION_FAIL(opcode, SPEC_FAIL_OUT_OF_VERSIONS);
         return -1;
     }
     cache1->func_version = version;
     cache1->defaults_start = defstart;
     cache1->defaults_len = deflen;
-    *instr = _Py_MAKECODEUNIT(CALL_FUNCTION_PY_SIMPLE, _Py_OPARG(*instr));
     return 0;
 }
 
-#if COLLECT_SPECIALIZATION_STATS_DETAILED
+static int
+specialize_py_call(
+    PyFunctionObject *func, _Py_CODEUNIT *instr,
+    int nargs, SpecializedCacheEntry *cache)
+{
+    _PyCallCache *cache1 = &cache[-1].call;
+    if (specialize_py_call_layout(func, CALL_FUNCTION, nargs, NULL, cache1)) {
+        return -1;
+    }
+    if (cache1->defaults_len == 0) {
+        *instr = _Py_MAKECODEUNIT(CALL_FUNCTION_PY_SIMPLE, _Py_OPARG(*instr));
+    }
+    else {
+        *instr = _Py_MAKECODEUNIT(CALL_FUNCTION_PY_WITH_DEFAULTS,
+                                  _Py_OPARG(*instr));
+    }
+    return 0;
+}
+
+/* Heap types using object.__new__ and a Python __init__ are instantiated
+ * by CALL_FUNCTION_CLASS_INIT, which allocates the object and pushes the
+ * __init__ frame itself. */
+static int
+specialize_class_call(
+    PyObject *callable, _Py_CODEUNIT *instr,
+    int nargs, SpecializedCacheEntry *cache)
+{
+    _Py_IDENTIFIER(__init__);
+    PyTypeObject *tp = (PyTypeObject *)callable;
+    if (!Py_IS_TYPE(tp, &PyType_Type) ||
+        !(tp->tp_flags & Py_TPFLAGS_HEAPTYPE) ||
+        (tp->tp_flags & Py_TPFLAGS_IS_ABSTRACT) ||
+        tp->tp_new != PyBaseObject_Type.tp_new ||
+        tp->tp_alloc != PyType_GenericAlloc)
+    {
+        SPECIALIZATION_FAIL(CALL_FUNCTION, SPEC_FAIL_CLASS);
+        return -1;
+    }
+    PyObject *init = _PyType_LookupId(tp, &PyId___init__);
+    if (init == NULL || !PyFunction_Check(init)) {
+        SPECIALIZATION_FAIL(CALL_FUNCTION, SPEC_FAIL_CLASS);
+        return -1;
+    }
+    if (!(tp->tp_flags & Py_TPFLAGS_VALID_VERSION_TAG)) {
+        SPECIALIZATION_FAIL(CALL_FUNCTION, SPEC_FAIL_OUT_OF_VERSIONS);
+        return -1;
+    }
+    /* self is passed as the first argument */
+    if (specialize_py_call_layout((PyFunctionObject *)init, CALL_FUNCTION,
+                                  nargs + 1, NULL, &cache[-1].call)) {
+        return -1;
+    }
+    PyHeapTypeObject *ht = (PyHeapTypeObject *)tp;
+    ht->_ht_init = init;  // borrowed
+    ht->_ht_init_version = tp->tp_version_tag;
+    *instr = _Py_MAKECODEUNIT(CALL_FUNCTION_CLASS_INIT, _Py_OPARG(*instr));
+    return 0;
+}
+
+static int
+specialize_bound_method_call(
+    PyMethodObject *method, _Py_CODEUNIT *instr,
+    int nargs, SpecializedCacheEntry *cache)
+{
+    if (!PyFunction_Check(method->im_func)) {
+        SPECIALIZATION_FAIL(CALL_FUNCTION, SPEC_FAIL_METHOD);
+        return -1;
+    }
+    _PyCallCache *cache1 = &cache[-1].call;
+    /* self is passed as the first argument */
+    if (specialize_py_call_layout((PyFunctionObject *)method->im_func,
+                                  CALL_FUNCTION, nargs + 1, NULL, cache1)) {
+        return -1;
+    }
+    *instr = _Py_MAKECODEUNIT(CALL_FUNCTION_BOUND_METHOD, _Py_OPARG(*instr));
+    return 0;
+}
+
 static int
 builtin_call_fail_kind(int ml_flags)
 {
@@ -1264,7 +1640,6 @@ builtin_call_fail_kind(int ml_flags)
             return SPEC_FAIL_BAD_CALL_FLAGS;
     }
 }
-#endif
 
 static int
 specialize_c_call(PyObject *callable, _Py_CODEUNIT *instr, int nargs,
@@ -1317,7 +1692,6 @@ specialize_c_call(PyObject *callable, _Py_CODEUNIT *instr, int nargs,
     }
 }
 
-#if COLLECT_SPECIALIZATION_STATS_DETAILED
 static int
 call_fail_kind(PyObject *callable)
 {
@@ -1336,11 +1710,7 @@ call_fail_kind(PyObject *callable)
     }
     return SPEC_FAIL_OTHER;
 }
-#endif
 
-/* TODO:
-    - Specialize calling classes.
-*/
 int
 _Py_Specialize_CallFunction(
     PyObject *callable, _Py_CODEUNIT *instr,
@@ -1354,6 +1724,9 @@ _Py_Specialize_CallFunction(
     else if (PyFunction_Check(callable)) {
         fail = specialize_py_call((PyFunctionObject *)callable, instr, nargs, cache);
     }
+    else if (Py_IS_TYPE(callable, &PyMethod_Type)) {
+        fail = specialize_bound_method_call((PyMethodObject *)callable, instr, nargs, cache);
+    }
     else if (PyType_Check(callable)) {
         fail = specialize_class_call(callable, instr, nargs, cache);
     }
@@ -1375,6 +1748,132 @@ _Py_Specialize_CallFunction(
     return 0;
 }
 
+int
+_Py_Specialize_CallFunctionKw(
+    PyObject *callable, _Py_CODEUNIT *instr,
+    int nargs, PyObject *kwnames, SpecializedCacheEntry *cache)
+{
+    int fail;
+    if (PyFunction_Check(callable)) {
+        fail = specialize_py_call_layout((PyFunctionObject *)callable,
+            CALL_FUNCTION_KW, nargs, kwnames, &cache[-1].call);
+        if (!fail) {
+            *instr = _Py_MAKECODEUNIT(CALL_FUNCTION_KW_PY, _Py_OPARG(*instr));
+        }
+    }
+    else {
+        SPECIALIZATION_FAIL(CALL_FUNCTION_KW, call_fail_kind(callable));
+        fail = -1;
+    }
+    _PyAdaptiveEntry *cache0 = &cache->adaptive;
+    if (fail) {
+        STAT_INC(CALL_FUNCTION_KW, specialization_failure);
+        assert(!PyErr_Occurred());
+        cache_backoff(cache0);
+    }
+    else {
+        STAT_INC(CALL_FUNCTION_KW, specialization_success);
+        assert(!PyErr_Occurred());
+        cache0->counter = initial_counter_value();
+    }
+    return 0;
+}
+
+static int
+specialize_method_descriptor(
+    PyMethodDescrObject *descr, PyObject *self, _Py_CODEUNIT *instr,
+    int nargs, SpecializedCacheEntry *cache)
+{
+    _PyObjectCache *cache1 = &cache[-1].obj;
+    if (!Py_IS_TYPE(self, descr->d_common.d_type)) {
+        /* Subclass instances would need a slower type check */
+        SPECIALIZATION_FAIL(CALL_METHOD, SPEC_FAIL_OTHER);
+        return -1;
+    }
+    switch (descr->d_method->ml_flags &
+        (METH_VARARGS | METH_FASTCALL | METH_NOARGS | METH_O |
+        METH_KEYWORDS | METH_METHOD)) {
+        case METH_NOARGS: {
+            if (nargs != 0) {
+                SPECIALIZATION_FAIL(CALL_METHOD, SPEC_FAIL_WRONG_NUMBER_ARGUMENTS);
+                return -1;
+            }
+            *instr = _Py_MAKECODEUNIT(CALL_METHOD_DESCRIPTOR_NOARGS,
+                _Py_OPARG(*instr));
+            return 0;
+        }
+        case METH_O: {
+            if (nargs != 1) {
+                SPECIALIZATION_FAIL(CALL_METHOD, SPEC_FAIL_WRONG_NUMBER_ARGUMENTS);
+                return -1;
+            }
+            _Py_IDENTIFIER(append);
+            PyObject *list_append = _PyType_LookupId(&PyList_Type, &PyId_append);
+            if ((PyObject *)descr == list_append) {
+                cache1->obj = list_append;  // borrowed
+                *instr = _Py_MAKECODEUNIT(CALL_METHOD_LIST_APPEND,
+                    _Py_OPARG(*instr));
+                return 0;
+            }
+            *instr = _Py_MAKECODEUNIT(CALL_METHOD_DESCRIPTOR_O,
+                _Py_OPARG(*instr));
+            return 0;
+        }
+        case METH_FASTCALL: {
+            *instr = _Py_MAKECODEUNIT(CALL_METHOD_DESCRIPTOR_FAST,
+                _Py_OPARG(*instr));
+            return 0;
+        }
+        default:
+            SPECIALIZATION_FAIL(CALL_METHOD,
+                builtin_call_fail_kind(descr->d_method->ml_flags));
+            return -1;
+    }
+}
+
+/* meth is NULL if LOAD_METHOD did not find a method, in which case
+ * self_or_callable is the callable rather than self.
+ * nargs does not include self.
+ */
+int
+_Py_Specialize_CallMethod(
+    PyObject *meth, PyObject *self_or_callable, _Py_CODEUNIT *instr,
+    int nargs, SpecializedCacheEntry *cache)
+{
+    int fail;
+    if (meth == NULL) {
+        SPECIALIZATION_FAIL(CALL_METHOD, SPEC_FAIL_OTHER);
+        fail = -1;
+    }
+    else if (PyFunction_Check(meth)) {
+        fail = specialize_py_call_layout((PyFunctionObject *)meth,
+            CALL_METHOD, nargs + 1, NULL, &cache[-1].call);
+        if (!fail) {
+            *instr = _Py_MAKECODEUNIT(CALL_METHOD_PY, _Py_OPARG(*instr));
+        }
+    }
+    else if (Py_IS_TYPE(meth, &PyMethodDescr_Type)) {
+        fail = specialize_method_descriptor((PyMethodDescrObject *)meth,
+            self_or_callable, instr, nargs, cache);
+    }
+    else {
+        SPECIALIZATION_FAIL(CALL_METHOD, call_fail_kind(meth));
+        fail = -1;
+    }
+    _PyAdaptiveEntry *cache0 = &cache->adaptive;
+    if (fail) {
+        STAT_INC(CALL_METHOD, specialization_failure);
+        assert(!PyErr_Occurred());
+        cache_backoff(cache0);
+    }
+    else {
+        STAT_INC(CALL_METHOD, specialization_success);
+        assert(!PyErr_Occurred());
+        cache0->counter = initial_counter_value();
+    }
+    return 0;
+}
+
 void
 _Py_Specialize_BinaryOp(PyObject *lhs, PyObject *rhs, _Py_CODEUNIT *instr,
                         SpecializedCacheEntry *cache)
@@ -1420,6 +1919,19 @@ _Py_Specialize_BinaryOp(PyObject *lhs, PyObject *rhs, _Py_CODEUNIT *instr,
                 goto success;
             }
             break;
+        case NB_SUBTRACT:
+        case NB_INPLACE_SUBTRACT:
+            if (PyLong_CheckExact(lhs)) {
+                *instr = _Py_MAKECODEUNIT(BINARY_OP_SUBTRACT_INT,
+                                          _Py_OPARG(*instr));
+                goto success;
+            }
+            if (PyFloat_CheckExact(lhs)) {
+                *instr = _Py_MAKECODEUNIT(BINARY_OP_SUBTRACT_FLOAT,
+                                          _Py_OPARG(*instr));
+                goto success;
+            }
+            break;
         default:
             // These operators don't have any available specializations. Rather
             // than repeatedly attempting to specialize them, just convert them
@@ -1435,3 +1947,216 @@ _Py_Specialize_BinaryOp(PyObject *lhs, PyObject *rhs, _Py_CODEUNIT *instr,
     STAT_INC(BINARY_OP, specialization_success);
     adaptive->counter = initial_counter_value();
 }
+
+static int
+compare_op_fail_kind(PyObject *lhs, PyObject *rhs)
+{
+    if (Py_TYPE(lhs) != Py_TYPE(rhs)) {
+        return SPEC_FAIL_DIFFERENT_TYPES;
+    }
+    if (PyBytes_CheckExact(lhs)) {
+        return SPEC_FAIL_COMPARE_BYTES;
+    }
+    if (PyTuple_CheckExact(lhs)) {
+        return SPEC_FAIL_COMPARE_TUPLE;
+    }
+    if (PyList_CheckExact(lhs)) {
+        return SPEC_FAIL_COMPARE_LIST;
+    }
+    if (PySet_CheckExact(lhs) || PyFrozenSet_CheckExact(lhs)) {
+        return SPEC_FAIL_COMPARE_SET;
+    }
+    return SPEC_FAIL_OTHER;
+}
+
+/* The fused COMPARE_OP_*_JUMP forms compute the sign of the comparison
+ * (-1, 0 or 1) and jump if bit (1 << (sign + 1)) is set in the mask
+ * stored in the index field of the adaptive entry. */
+static int compare_masks[] = {
+    // 1-bit: jump if less than
+    // 2-bit: jump if equal
+    // 4-bit: jump if greater
+    [Py_LT] = 1 | 0 | 0,
+    [Py_LE] = 1 | 2 | 0,
+    [Py_EQ] = 0 | 2 | 0,
+    [Py_NE] = 1 | 0 | 4,
+    [Py_GT] = 0 | 0 | 4,
+    [Py_GE] = 0 | 2 | 4,
+};
+
+void
+_Py_Specialize_CompareOp(PyObject *lhs, PyObject *rhs,
+                         _Py_CODEUNIT *instr, SpecializedCacheEntry *cache)
+{
+    _PyAdaptiveEntry *adaptive = &cache->adaptive;
+    int op = adaptive->original_oparg;
+    int next_opcode = _Py_OPCODE(instr[1]);
+    if (next_opcode != POP_JUMP_IF_FALSE && next_opcode != POP_JUMP_IF_TRUE) {
+        // Can't ever combine, so don't bother being adaptive.
+        SPECIALIZATION_FAIL(COMPARE_OP, SPEC_FAIL_NOT_FOLLOWED_BY_COND_JUMP);
+        *instr = _Py_MAKECODEUNIT(COMPARE_OP, adaptive->original_oparg);
+        goto failure;
+    }
+    assert(op <= Py_GE);
+    int when_to_jump_mask = compare_masks[op];
+    if (next_opcode == POP_JUMP_IF_FALSE) {
+        when_to_jump_mask = (1 | 2 | 4) & ~when_to_jump_mask;
+    }
+    if (Py_TYPE(lhs) != Py_TYPE(rhs)) {
+        SPECIALIZATION_FAIL(COMPARE_OP, compare_op_fail_kind(lhs, rhs));
+        goto failure;
+    }
+    if (PyFloat_CheckExact(lhs)) {
+        *instr = _Py_MAKECODEUNIT(COMPARE_OP_FLOAT_JUMP, _Py_OPARG(*instr));
+        adaptive->index = when_to_jump_mask;
+        goto success;
+    }
+    if (PyLong_CheckExact(lhs)) {
+        if (Py_ABS(Py_SIZE(lhs)) <= 1 && Py_ABS(Py_SIZE(rhs)) <= 1) {
+            *instr = _Py_MAKECODEUNIT(COMPARE_OP_INT_JUMP, _Py_OPARG(*instr));
+            adaptive->index = when_to_jump_mask;
+            goto success;
+        }
+        SPECIALIZATION_FAIL(COMPARE_OP, SPEC_FAIL_BIG_INT);
+        goto failure;
+    }
+    if (PyUnicode_CheckExact(lhs)) {
+        if (op != Py_EQ && op != Py_NE) {
+            SPECIALIZATION_FAIL(COMPARE_OP, SPEC_FAIL_STRING_COMPARE);
+            goto failure;
+        }
+        *instr = _Py_MAKECODEUNIT(COMPARE_OP_STR_JUMP, _Py_OPARG(*instr));
+        adaptive->index = when_to_jump_mask;
+        goto success;
+    }
+    SPECIALIZATION_FAIL(COMPARE_OP, compare_op_fail_kind(lhs, rhs));
+failure:
+    STAT_INC(COMPARE_OP, specialization_failure);
+    cache_backoff(adaptive);
+    return;
+success:
+    STAT_INC(COMPARE_OP, specialization_success);
+    adaptive->counter = initial_counter_value();
+}
+
+static int
+for_iter_fail_kind(PyObject *iter)
+{
+    PyTypeObject *t = Py_TYPE(iter);
+    if (t == &PyCoro_Type) {
+        return SPEC_FAIL_FOR_ITER_COROUTINE;
+    }
+    if (t == &PyAsyncGen_Type) {
+        return SPEC_FAIL_FOR_ITER_ASYNC_GENERATOR;
+    }
+    if (t == &PyDictIterKey_Type) {
+        return SPEC_FAIL_FOR_ITER_DICT_KEYS;
+    }
+    if (t == &PyDictIterValue_Type) {
+        return SPEC_FAIL_FOR_ITER_DICT_VALUES;
+    }
+    if (t == &PyDictIterItem_Type) {
+        return SPEC_FAIL_FOR_ITER_DICT_ITEMS;
+    }
+    if (t == &PyLongRangeIter_Type) {
+        return SPEC_FAIL_FOR_ITER_LONG_RANGE;
+    }
+    if (t == &PyListRevIter_Type) {
+        return SPEC_FAIL_FOR_ITER_REVERSED_LIST;
+    }
+    if (t == &PySetIter_Type) {
+        return SPEC_FAIL_FOR_ITER_SET;
+    }
+    if (t == &PyUnicodeIter_Type) {
+        return SPEC_FAIL_FOR_ITER_STRING;
+    }
+    if (t == &PyEnum_Type) {
+        return SPEC_FAIL_FOR_ITER_ENUMERATE;
+    }
+    if (t == &PyZip_Type) {
+        return SPEC_FAIL_FOR_ITER_ZIP;
+    }
+    if (t == &PyMap_Type) {
+        return SPEC_FAIL_FOR_ITER_MAP;
+    }
+    return SPEC_FAIL_OTHER;
+}
+
+void
+_Py_Specialize_ForIter(PyObject *iter, _Py_CODEUNIT *instr,
+                       SpecializedCacheEntry *cache)
+{
+    _PyAdaptiveEntry *adaptive = &cache->adaptive;
+    PyTypeObject *tp = Py_TYPE(iter);
+    if (tp == &PyListIter_Type) {
+        *instr = _Py_MAKECODEUNIT(FOR_ITER_LIST, _Py_OPARG(*instr));
+        goto success;
+    }
+    if (tp == &PyTupleIter_Type) {
+        *instr = _Py_MAKECODEUNIT(FOR_ITER_TUPLE, _Py_OPARG(*instr));
+        goto success;
+    }
+    if (tp == &PyRangeIter_Type) {
+        *instr = _Py_MAKECODEUNIT(FOR_ITER_RANGE, _Py_OPARG(*instr));
+        goto success;
+    }
+    if (tp == &PyGen_Type) {
+        *instr = _Py_MAKECODEUNIT(FOR_ITER_GEN, _Py_OPARG(*instr));
+        goto success;
+    }
+    SPECIALIZATION_FAIL(FOR_ITER, for_iter_fail_kind(iter));
+    STAT_INC(FOR_ITER, specialization_failure);
+    cache_backoff(adaptive);
+    return;
+success:
+    STAT_INC(FOR_ITER, specialization_success);
+    adaptive->counter = initial_counter_value();
+}
+
+static int
+unpack_sequence_fail_kind(PyObject *seq)
+{
+    if (PySequence_Check(seq)) {
+        return SPEC_FAIL_UNPACK_SEQUENCE_SEQUENCE;
+    }
+    if (PyIter_Check(seq)) {
+        return SPEC_FAIL_UNPACK_SEQUENCE_ITERATOR;
+    }
+    return SPEC_FAIL_OTHER;
+}
+
+void
+_Py_Specialize_UnpackSequence(PyObject *seq, _Py_CODEUNIT *instr,
+                              SpecializedCacheEntry *cache)
+{
+    _PyAdaptiveEntry *adaptive = &cache->adaptive;
+    if (PyTuple_CheckExact(seq)) {
+        if (PyTuple_GET_SIZE(seq) != adaptive->original_oparg) {
+            SPECIALIZATION_FAIL(UNPACK_SEQUENCE, SPEC_FAIL_EXPECTED_ERROR);
+            goto failure;
+        }
+        if (PyTuple_GET_SIZE(seq) == 2) {
+            *instr = _Py_MAKECODEUNIT(UNPACK_SEQUENCE_TWO_TUPLE,
+                                      _Py_OPARG(*instr));
+            goto success;
+        }
+        *instr = _Py_MAKECODEUNIT(UNPACK_SEQUENCE_TUPLE, _Py_OPARG(*instr));
+        goto success;
+    }
+    if (PyList_CheckExact(seq)) {
+        if (PyList_GET_SIZE(seq) != adaptive->original_oparg) {
+            SPECIALIZATION_FAIL(UNPACK_SEQUENCE, SPEC_FAIL_EXPECTED_ERROR);
+            goto failure;
+        }
+        *instr = _Py_MAKECODEUNIT(UNPACK_SEQUENCE_LIST, _Py_OPARG(*instr));
+        goto success;
+    }
+    SPECIALIZATION_FAIL(UNPACK_SEQUENCE, unpack_sequence_fail_kind(seq));
+failure:
+    STAT_INC(UNPACK_SEQUENCE, specialization_failure);
+    cache_backoff(adaptive);
+    return;
+success:
+    STAT_INC(UNPACK_SEQUENCE, specialization_success);
+    adaptive->counter = initial_counter_value();
+}
@@ -1777,6 +1777,26 @@ sys__getquickenedcount_impl(PyObject *module)
     return _Py_QuickenedCount;
 }
 
+/*[clinic input]
+sys._get_specialization_stats
+
+    code: object(subclass_of='&PyCode_Type')
+    /
+
+Return the specialization stats of each instruction of a code object.
+
+The result maps the offset of every instruction with any activity to a
+dict of its counts.  Return None if the code object does not keep stats,
+which requires running with -X specialization_stats.
+[clinic start generated code]*/
+
+static PyObject *
+sys__get_specialization_stats_impl(PyObject *module, PyObject *code)
+/*[clinic end generated code: output=95761f52726ddf76 input=a226756f8d65484d]*/
+{
+    return _PyCode_GetSpecializationStats((PyCodeObject *)code);
+}
+
 /*[clinic input]
 sys.getallocatedblocks -> Py_ssize_t
 
@@ -1910,6 +1930,21 @@ sys__debugmallocstats_impl(PyObject *module)
     Py_RETURN_NONE;
 }
 
+/*[clinic input]
+sys._trim_memory -> Py_ssize_t
+
+Give the memory of pymalloc's free pools back to the operating system.
+
+Return the number of bytes released.
+[clinic start generated code]*/
+
+static Py_ssize_t
+sys__trim_memory_impl(PyObject *module)
+/*[clinic end generated code: output=3126d241cfc76942 input=be1bbd2a77a19723]*/
+{
+    return (Py_ssize_t)_PyObject_TrimMemory();
+}
+
 #ifdef Py_TRACE_REFS
 /* Defined in objects.c because it uses static globals in that file */
 extern PyObject *_Py_GetObjects(PyObject *, PyObject *);
@@ -1989,6 +2024,7 @@ static PyMethodDef sys_methods[] = {
     SYS_GETFILESYSTEMENCODING_METHODDEF
     SYS_GETFILESYSTEMENCODEERRORS_METHODDEF
     SYS__GETQUICKENEDCOUNT_METHODDEF
+    SYS__GET_SPECIALIZATION_STATS_METHODDEF
 #ifdef Py_TRACE_REFS
     {"getobjects",      _Py_GetObjects, METH_VARARGS},
 #endif
@@ -2013,6 +2049,7 @@ static PyMethodDef sys_methods[] = {
     SYS_GETTRACE_METHODDEF
     SYS_CALL_TRACING_METHODDEF
     SYS__DEBUGMALLOCSTATS_METHODDEF
+    SYS__TRIM_MEMORY_METHODDEF
     SYS_SET_COROUTINE_ORIGIN_TRACKING_DEPTH_METHODDEF
     SYS_GET_COROUTINE_ORIGIN_TRACKING_DEPTH_METHODDEF
     {"set_asyncgen_hooks", (PyCFunction)(void(*)(void))sys_set_asyncgen_hooks,
@@ -0,0 +1,481 @@
+/* Bodies of the micro-ops, included inside a switch on the uop opcode by
+ * the tier-2 interpreter (Python/optimizer.c) and by the JIT template
+ * (Tools/jit/template.c), which compiles one stencil per uop from them.
+ *
+ * The includer provides:
+ *
+ *   tstate, frame, localsplus, stack_pointer
+ *   oparg, operand, flags, borrowed, target  -- fields of the current uop
+ *   the labels deopt, side_exit, loop_exit, error and error_with_stack
+ *
+ * UOP_JUMP_TO_TOP is left to the includer.
+ */
+
+#define TOP()             (stack_pointer[-1])
+#define SECOND()          (stack_pointer[-2])
+#define THIRD()           (stack_pointer[-3])
+#define PEEK(n)           (stack_pointer[-(n)])
+#define SET_TOP(v)        (stack_pointer[-1] = (v))
+#define SET_SECOND(v)     (stack_pointer[-2] = (v))
+#define PUSH(v)           (*stack_pointer++ = (v))
+#define POP()             (*--stack_pointer)
+#define STACK_SHRINK(n)   (stack_pointer -= (n))
+
+#define DEOPT_IF(cond) if (cond) { goto deopt; }
+
+/* Release an operand, which was at the given depth when the uop started */
+#define DECREF_OPERAND(depth, v) \
+    do { \
+        if (!(borrowed & (1 << (depth)))) { \
+            Py_DECREF(v); \
+        } \
+    } while (0)
+
+/* Leave through the side exit unless the branch went the way the trace
+ * expects it to */
+#define BRANCH_IF(jump) \
+    if ((jump) != ((flags & UOP_JUMP) != 0)) { goto side_exit; }
+
+/* Uops that may run arbitrary code record where they are first,
+ * for tracebacks and line numbers. */
+#define ESCAPE() frame->f_lasti = target
+
+/* An operand can hold the result of an arithmetic uop if the trace owns
+ * the only reference to it, as in Python/ceval.c.  Borrowed operands are
+ * owned by a local. */
+#define REUSABLE(depth, v) \
+    (!(borrowed & (1 << (depth))) && Py_REFCNT(v) == 1)
+
+#define FLOAT_OP(OP) \
+    do { \
+        PyObject *left = SECOND(); \
+        PyObject *right = TOP(); \
+        double dres = PyFloat_AS_DOUBLE(left) OP PyFloat_AS_DOUBLE(right); \
+        PyObject *res; \
+        if (REUSABLE(1, left)) { \
+            ((PyFloatObject *)left)->ob_fval = dres; \
+            DECREF_OPERAND(0, right); \
+            res = left; \
+        } \
+        else if (REUSABLE(0, right)) { \
+            ((PyFloatObject *)right)->ob_fval = dres; \
+            DECREF_OPERAND(1, left); \
+            res = right; \
+        } \
+        else { \
+            res = PyFloat_FromDouble(dres); \
+            DECREF_OPERAND(0, right); \
+            DECREF_OPERAND(1, left); \
+        } \
+        SET_SECOND(res); \
+        STACK_SHRINK(1); \
+        if (res == NULL) { \
+            goto error; \
+        } \
+    } while (0)
+
+#define INT_OP(OP, FUNC) \
+    do { \
+        PyObject *left = SECOND(); \
+        PyObject *right = TOP(); \
+        PyObject *res = NULL; \
+        if (_PyLong_IsMedium(left) && _PyLong_IsMedium(right)) { \
+            stwodigits ival = _PyLong_MediumValue(left) OP \
+                _PyLong_MediumValue(right); \
+            if (REUSABLE(1, left) && _PyLong_CanStoreInPlace(left, ival)) { \
+                _PyLong_StoreInPlace(left, ival); \
+                DECREF_OPERAND(0, right); \
+                res = left; \
+            } \
+            else if (REUSABLE(0, right) && \
+                     _PyLong_CanStoreInPlace(right, ival)) { \
+                _PyLong_StoreInPlace(right, ival); \
+                DECREF_OPERAND(1, left); \
+                res = right; \
+            } \
+        } \
+        if (res == NULL) { \
+            res = FUNC((PyLongObject *)left, (PyLongObject *)right); \
+            DECREF_OPERAND(0, right); \
+            DECREF_OPERAND(1, left); \
+        } \
+        SET_SECOND(res); \
+        STACK_SHRINK(1); \
+        if (res == NULL) { \
+            goto error; \
+        } \
+    } while (0)
+
+        case UOP_NOP:
+            break;
+
+        case UOP_LOAD_FAST: {
+            PyObject *value = localsplus[oparg];
+            /* Let tier 1 raise UnboundLocalError */
+            DEOPT_IF(value == NULL);
+            if (!(flags & UOP_BORROW)) {
+                Py_INCREF(value);
+            }
+            PUSH(value);
+            break;
+        }
+
+        case UOP_LOAD_CONST: {
+            PyObject *value = (PyObject *)(uintptr_t)operand;
+            if (!(flags & UOP_BORROW)) {
+                Py_INCREF(value);
+            }
+            PUSH(value);
+            break;
+        }
+
+        case UOP_STORE_FAST: {
+            PyObject *value = POP();
+            PyObject *old = localsplus[oparg];
+            localsplus[oparg] = value;
+            Py_XDECREF(old);
+            break;
+        }
+
+        case UOP_POP_TOP: {
+            PyObject *value = POP();
+            DECREF_OPERAND(0, value);
+            break;
+        }
+
+        case UOP_DUP_TOP: {
+            PyObject *value = TOP();
+            Py_INCREF(value);
+            PUSH(value);
+            break;
+        }
+
+        case UOP_ROT_TWO: {
+            PyObject *top = TOP();
+            SET_TOP(SECOND());
+            SET_SECOND(top);
+            break;
+        }
+
+        case UOP_GUARD_TYPE:
+            DEOPT_IF(Py_TYPE(PEEK(oparg + 1)) !=
+                     (PyTypeObject *)(uintptr_t)operand);
+            break;
+
+        case UOP_BINARY_OP: {
+            /* The operand is the binaryfunc to call */
+            ESCAPE();
+            PyObject *rhs = POP();
+            PyObject *lhs = TOP();
+            PyObject *res = ((binaryfunc)(uintptr_t)operand)(lhs, rhs);
+            Py_DECREF(lhs);
+            Py_DECREF(rhs);
+            SET_TOP(res);
+            if (res == NULL) {
+                goto error;
+            }
+            break;
+        }
+
+        case UOP_ADD_INT:
+            INT_OP(+, _PyLong_Add);
+            break;
+
+        case UOP_MULTIPLY_INT:
+            INT_OP(*, _PyLong_Multiply);
+            break;
+
+        case UOP_SUBTRACT_INT:
+            INT_OP(-, _PyLong_Subtract);
+            break;
+
+        case UOP_ADD_FLOAT:
+            FLOAT_OP(+);
+            break;
+
+        case UOP_MULTIPLY_FLOAT:
+            FLOAT_OP(*);
+            break;
+
+        case UOP_SUBTRACT_FLOAT:
+            FLOAT_OP(-);
+            break;
+
+        case UOP_BINARY_SUBSCR: {
+            ESCAPE();
+            PyObject *sub = POP();
+            PyObject *container = TOP();
+            PyObject *res = PyObject_GetItem(container, sub);
+            Py_DECREF(container);
+            Py_DECREF(sub);
+            SET_TOP(res);
+            if (res == NULL) {
+                goto error;
+            }
+            break;
+        }
+
+        case UOP_BINARY_SUBSCR_LIST_INT: {
+            PyObject *sub = TOP();
+            PyObject *list = SECOND();
+            // Deopt unless 0 <= sub < len(list)
+            DEOPT_IF(((size_t)Py_SIZE(sub)) > 1);
+            Py_ssize_t index = ((PyLongObject *)sub)->ob_digit[0];
+            DEOPT_IF(index >= PyList_GET_SIZE(list));
+            PyObject *res = PyList_GET_ITEM(list, index);
+            assert(res != NULL);
+            Py_INCREF(res);
+            STACK_SHRINK(1);
+            DECREF_OPERAND(0, sub);
+            SET_TOP(res);
+            DECREF_OPERAND(1, list);
+            break;
+        }
+
+        case UOP_BINARY_SUBSCR_TUPLE_INT: {
+            PyObject *sub = TOP();
+            PyObject *tuple = SECOND();
+            // Deopt unless 0 <= sub < len(tuple)
+            DEOPT_IF(((size_t)Py_SIZE(sub)) > 1);
+            Py_ssize_t index = ((PyLongObject *)sub)->ob_digit[0];
+            DEOPT_IF(index >= PyTuple_GET_SIZE(tuple));
+            PyObject *res = PyTuple_GET_ITEM(tuple, index);
+            assert(res != NULL);
+            Py_INCREF(res);
+            STACK_SHRINK(1);
+            DECREF_OPERAND(0, sub);
+            SET_TOP(res);
+            DECREF_OPERAND(1, tuple);
+            break;
+        }
+
+        case UOP_STORE_SUBSCR: {
+            ESCAPE();
+            PyObject *sub = TOP();
+            PyObject *container = SECOND();
+            PyObject *v = THIRD();
+            STACK_SHRINK(3);
+            /* container[sub] = v */
+            int err = PyObject_SetItem(container, sub, v);
+            Py_DECREF(v);
+            Py_DECREF(container);
+            Py_DECREF(sub);
+            if (err != 0) {
+                goto error;
+            }
+            break;
+        }
+
+        case UOP_STORE_SUBSCR_LIST_INT: {
+            PyObject *sub = TOP();
+            PyObject *list = SECOND();
+            PyObject *value = THIRD();
+            // Deopt unless 0 <= sub < len(list)
+            DEOPT_IF(((size_t)Py_SIZE(sub)) > 1);
+            Py_ssize_t index = ((PyLongObject *)sub)->ob_digit[0];
+            DEOPT_IF(index >= PyList_GET_SIZE(list));
+            PyObject *old_value = PyList_GET_ITEM(list, index);
+            PyList_SET_ITEM(list, index, value);
+            STACK_SHRINK(3);
+            assert(old_value != NULL);
+            Py_DECREF(old_value);
+            DECREF_OPERAND(0, sub);
+            DECREF_OPERAND(1, list);
+            break;
+        }
+
+        case UOP_COMPARE_OP: {
+            ESCAPE();
+            PyObject *right = POP();
+            PyObject *left = TOP();
+            PyObject *res = PyObject_RichCompare(left, right, oparg);
+            SET_TOP(res);
+            Py_DECREF(left);
+            Py_DECREF(right);
+            if (res == NULL) {
+                goto error;
+            }
+            break;
+        }
+
+        case UOP_IS_OP: {
+            PyObject *right = TOP();
+            PyObject *left = SECOND();
+            int res = Py_Is(left, right) ^ oparg;
+            PyObject *b = res ? Py_True : Py_False;
+            Py_INCREF(b);
+            STACK_SHRINK(1);
+            SET_TOP(b);
+            DECREF_OPERAND(0, right);
+            DECREF_OPERAND(1, left);
+            break;
+        }
+
+        case UOP_COMPARE_INT_BRANCH: {
+            PyObject *right = TOP();
+            PyObject *left = SECOND();
+            // Deopt unless both operands fit in a single digit
+            DEOPT_IF((size_t)(Py_SIZE(left) + 1) > 2);
+            DEOPT_IF((size_t)(Py_SIZE(right) + 1) > 2);
+            Py_ssize_t ileft = Py_SIZE(left) * ((PyLongObject *)left)->ob_digit[0];
+            Py_ssize_t iright = Py_SIZE(right) * ((PyLongObject *)right)->ob_digit[0];
+            int sign = (ileft > iright) - (ileft < iright);
+            STACK_SHRINK(2);
+            DECREF_OPERAND(0, right);
+            DECREF_OPERAND(1, left);
+            BRANCH_IF(((1 << (sign + 1)) & oparg) != 0);
+            break;
+        }
+
+        case UOP_COMPARE_FLOAT_BRANCH: {
+            PyObject *right = TOP();
+            PyObject *left = SECOND();
+            double dleft = PyFloat_AS_DOUBLE(left);
+            double dright = PyFloat_AS_DOUBLE(right);
+            DEOPT_IF(isnan(dleft));
+            DEOPT_IF(isnan(dright));
+            int sign = (dleft > dright) - (dleft < dright);
+            STACK_SHRINK(2);
+            DECREF_OPERAND(0, right);
+            DECREF_OPERAND(1, left);
+            BRANCH_IF(((1 << (sign + 1)) & oparg) != 0);
+            break;
+        }
+
+        case UOP_COMPARE_STR_BRANCH: {
+            PyObject *right = TOP();
+            PyObject *left = SECOND();
+            int res = _PyUnicode_Equal(left, right);
+            if (res < 0) {
+                /* The operands are still on the stack */
+                goto error_with_stack;
+            }
+            STACK_SHRINK(2);
+            DECREF_OPERAND(0, right);
+            DECREF_OPERAND(1, left);
+            int sign = !res;
+            BRANCH_IF(((1 << (sign + 1)) & oparg) != 0);
+            break;
+        }
+
+        case UOP_BRANCH: {
+            PyObject *cond = POP();
+            int truth;
+            if (Py_IsTrue(cond)) {
+                truth = 1;
+            }
+            else if (Py_IsFalse(cond)) {
+                truth = 0;
+            }
+            else {
+                ESCAPE();
+                truth = PyObject_IsTrue(cond);
+            }
+            Py_DECREF(cond);
+            if (truth < 0) {
+                goto error;
+            }
+            BRANCH_IF(truth == oparg);
+            break;
+        }
+
+        case UOP_FOR_ITER: {
+            ESCAPE();
+            PyObject *iter = TOP();
+            PyObject *next = (*Py_TYPE(iter)->tp_iternext)(iter);
+            if (next != NULL) {
+                PUSH(next);
+                break;
+            }
+            if (_PyErr_Occurred(tstate)) {
+                if (!_PyErr_ExceptionMatches(tstate, PyExc_StopIteration)) {
+                    goto error;
+                }
+                _PyErr_Clear(tstate);
+            }
+            /* iterator ended normally */
+            STACK_SHRINK(1);
+            Py_DECREF(iter);
+            goto loop_exit;
+        }
+
+        case UOP_FOR_ITER_LIST: {
+            _PyListIterObject *it = (_PyListIterObject *)TOP();
+            DEOPT_IF(Py_TYPE(it) != &PyListIter_Type);
+            PyListObject *seq = it->it_seq;
+            DEOPT_IF(seq == NULL || it->it_index >= PyList_GET_SIZE(seq));
+            PyObject *next = PyList_GET_ITEM(seq, it->it_index++);
+            Py_INCREF(next);
+            PUSH(next);
+            break;
+        }
+
+        case UOP_FOR_ITER_TUPLE: {
+            _PyTupleIterObject *it = (_PyTupleIterObject *)TOP();
+            DEOPT_IF(Py_TYPE(it) != &PyTupleIter_Type);
+            PyTupleObject *seq = it->it_seq;
+            DEOPT_IF(seq == NULL || it->it_index >= PyTuple_GET_SIZE(seq));
+            PyObject *next = PyTuple_GET_ITEM(seq, it->it_index++);
+            Py_INCREF(next);
+            PUSH(next);
+            break;
+        }
+
+        case UOP_FOR_ITER_RANGE: {
+            _PyRangeIterObject *r = (_PyRangeIterObject *)TOP();
+            DEOPT_IF(Py_TYPE(r) != &PyRangeIter_Type);
+            DEOPT_IF(r->index >= r->len);
+            long value = (long)(r->start +
+                                (unsigned long)(r->index++) * r->step);
+            PyObject *next = PyLong_FromLong(value);
+            if (next == NULL) {
+                goto error;
+            }
+            PUSH(next);
+            break;
+        }
+
+        case UOP_LOAD_GLOBAL_MODULE: {
+            PyObject *globals = frame->f_globals;
+            DEOPT_IF(!PyDict_CheckExact(globals));
+            PyDictKeysObject *keys = ((PyDictObject *)globals)->ma_keys;
+            DEOPT_IF(keys->dk_version != (uint32_t)operand);
+            PyObject *res = DK_ENTRIES(keys)[oparg].me_value;
+            DEOPT_IF(res == NULL);
+            Py_INCREF(res);
+            PUSH(res);
+            break;
+        }
+
+        case UOP_LOAD_GLOBAL_BUILTIN: {
+            PyObject *globals = frame->f_globals;
+            PyObject *builtins = frame->f_builtins;
+            DEOPT_IF(!PyDict_CheckExact(globals));
+            DEOPT_IF(!PyDict_CheckExact(builtins));
+            PyDictKeysObject *mkeys = ((PyDictObject *)globals)->ma_keys;
+            PyDictKeysObject *bkeys = ((PyDictObject *)builtins)->ma_keys;
+            DEOPT_IF(mkeys->dk_version != (uint32_t)operand);
+            DEOPT_IF(bkeys->dk_version != (uint32_t)(operand >> 32));
+            PyObject *res = DK_ENTRIES(bkeys)[oparg].me_value;
+            DEOPT_IF(res == NULL);
+            Py_INCREF(res);
+            PUSH(res);
+            break;
+        }
+
+#undef TOP
+#undef SECOND
+#undef THIRD
+#undef PEEK
+#undef SET_TOP
+#undef SET_SECOND
+#undef PUSH
+#undef POP
+#undef STACK_SHRINK
+#undef DEOPT_IF
+#undef DECREF_OPERAND
+#undef BRANCH_IF
+#undef ESCAPE
+#undef REUSABLE
+#undef FLOAT_OP
+#undef INT_OP
@@ -0,0 +1,4 @@
+
+import sys
+print('running...')
+sys.exit(0)
@@ -0,0 +1,346 @@
+"""Build the stencils for the copy-and-patch JIT.
+
+Usage: build.py --cc CC -o Python/jit_stencils.h -- CFLAGS...
+
+Tools/jit/template.c is compiled once for every uop defined in
+Include/internal/pycore_uops.h.  The relocatable object files are read
+back, and the machine code, the read-only data it refers to and the
+relocations ("holes") are written out as C arrays for Python/jit.c.
+
+Only x86-64 ELF targets are supported.  For any other target, the output
+just says so, and the JIT is not available.
+"""
+
+import argparse
+import concurrent.futures
+import os
+import re
+import shlex
+import struct
+import subprocess
+import sys
+import tempfile
+
+TOOLS_JIT = os.path.dirname(os.path.abspath(__file__))
+ROOT = os.path.dirname(os.path.dirname(TOOLS_JIT))
+TEMPLATE = os.path.join(TOOLS_JIT, "template.c")
+UOPS_H = os.path.join(ROOT, "Include", "internal", "pycore_uops.h")
+
+# Code generation options for the stencils:
+# - the large code model turns every address into a 64-bit immediate,
+#   so stencils can be placed anywhere and can reach any symbol,
+# - no jump tables, unwind tables, stack protector or CET markers, which
+#   would need data the stencils cannot carry,
+# - no hot/cold splitting, so each stencil is a single function.
+STENCIL_CFLAGS = [
+    "-O3",
+    "-fno-pic",
+    "-fno-pie",
+    "-mcmodel=large",
+    "-fno-jump-tables",
+    "-fno-asynchronous-unwind-tables",
+    "-fno-unwind-tables",
+    "-fno-stack-protector",
+    "-fcf-protection=none",
+    "-fno-reorder-blocks-and-partition",
+    "-fno-plt",
+    "-g0",
+]
+
+# ELF constants
+SHT_PROGBITS = 1
+SHT_RELA = 4
+SHT_NOBITS = 8
+SHF_WRITE = 0x1
+SHF_ALLOC = 0x2
+SHF_EXECINSTR = 0x4
+SHN_UNDEF = 0
+
+R_X86_64_64 = 1
+R_X86_64_PC32 = 2
+R_X86_64_PLT32 = 4
+R_X86_64_32 = 10
+R_X86_64_32S = 11
+
+HOLE_KINDS = {
+    R_X86_64_64: "HOLE_ABS_64",
+    R_X86_64_32: "HOLE_ABS_32",
+    R_X86_64_32S: "HOLE_ABS_32S",
+    R_X86_64_PC32: "HOLE_REL_32",
+    R_X86_64_PLT32: "HOLE_REL_32",
+}
+
+# The holes with a special meaning, see Tools/jit/template.c
+SPECIAL_HOLES = {
+    "_JIT_CONTINUE": "HOLE_CONTINUE",
+    "_JIT_TOP": "HOLE_TOP",
+    "_JIT_OPARG": "HOLE_OPARG",
+    "_JIT_OPERAND": "HOLE_OPERAND",
+    "_JIT_FLAGS": "HOLE_FLAGS",
+    "_JIT_BORROWED": "HOLE_BORROWED",
+    "_JIT_TARGET": "HOLE_TARGET",
+    "_JIT_INDEX": "HOLE_INDEX",
+}
+
+
+class StencilError(Exception):
+    pass
+
+
+def read_uops():
+    with open(UOPS_H) as f:
+        uops = re.findall(r"^#define (UOP_\w+)\s+(\d+)$", f.read(), re.M)
+    return [(name, int(value)) for name, value in uops if name != "UOP_NOP"]
+
+
+def filter_cflags(cflags):
+    """Keep the options that affect what the headers declare, and drop
+    those that affect code generation."""
+    kept = []
+    args = iter(cflags)
+    for arg in args:
+        if arg in ("-I", "-D", "-U", "-include", "-isystem"):
+            kept += [arg, next(args, "")]
+        elif arg.startswith(("-I", "-D", "-U", "-std=", "-isystem")):
+            kept.append(arg)
+        elif arg in ("-fwrapv", "-fno-strict-aliasing", "-pthread"):
+            kept.append(arg)
+    return kept
+
+
+class Section:
+    def __init__(self, index, name, type, flags, offset, size, link, info):
+        self.index = index
+        self.name = name
+        self.type = type
+        self.flags = flags
+        self.offset = offset
+        self.size = size
+        self.link = link
+        self.info = info
+
+
+class ObjectFile:
+    """Just enough of an ELF64 little-endian relocatable file."""
+
+    def __init__(self, data):
+        if data[:4] != b"\x7fELF" or data[4] != 2 or data[5] != 1:
+            raise StencilError("not an ELF64 little-endian object file")
+        self.data = data
+        shoff, = struct.unpack_from("<Q", data, 0x28)
+        shentsize, shnum, shstrndx = struct.unpack_from("<HHH", data, 0x3A)
+        raw = []
+        for i in range(shnum):
+            raw.append(struct.unpack_from("<IIQQQQIIQQ", data,
+                                          shoff + i * shentsize))
+        strtab = raw[shstrndx]
+        self.sections = []
+        for i, (name, type, flags, _, offset, size, link, info, _, _) in enumerate(raw):
+            self.sections.append(Section(
+                i, self._string(strtab[4], name), type, flags, offset, size,
+                link, info))
+        self.symbols = []
+        for section in self.sections:
+            if section.name == ".symtab":
+                names = self.sections[section.link]
+                for offset in range(section.offset,
+                                    section.offset + section.size, 24):
+                    name, info, _, shndx, value, _ = struct.unpack_from(
+                        "<IBBHQQ", data, offset)
+                    self.symbols.append(
+                        (self._string(names.offset, name), info & 0xF,
+                         shndx, value))
+
+    def _string(self, table, offset):
+        end = self.data.index(b"\0", table + offset)
+        return self.data[table + offset:end].decode()
+
+    def contents(self, section):
+        if section.type == SHT_NOBITS:
+            return bytes(section.size)
+        return self.data[section.offset:section.offset + section.size]
+
+    def relocations(self, section):
+        for offset in range(section.offset, section.offset + section.size, 24):
+            r_offset, r_info, r_addend = struct.unpack_from(
+                "<QQq", self.data, offset)
+            yield r_offset, r_info >> 32, r_info & 0xFFFFFFFF, r_addend
+
+
+class Stencil:
+    def __init__(self, name, body, holes):
+        self.name = name
+        self.body = body
+        # (offset, kind, value, symbol, addend)
+        self.holes = holes
+
+
+def make_stencil(name, obj):
+    # Lay out the code first, then the read-only data it refers to
+    layout = {}
+    body = bytearray()
+    alloc = [s for s in obj.sections
+             if s.flags & SHF_ALLOC and s.type in (SHT_PROGBITS, SHT_NOBITS)]
+    alloc.sort(key=lambda s: not s.flags & SHF_EXECINSTR)
+    for section in alloc:
+        if section.size == 0:
+            continue
+        if section.flags & SHF_WRITE:
+            raise StencilError(f"{name}: writable section {section.name}")
+        while len(body) % 16:
+            body.append(0)
+        layout[section.index] = len(body)
+        body += obj.contents(section)
+    entry = [(shndx, value) for sym, _, shndx, value in obj.symbols
+             if sym == "_JIT_ENTRY"]
+    if (len(entry) != 1 or entry[0][0] not in layout or
+            layout[entry[0][0]] + entry[0][1] != 0):
+        raise StencilError(f"{name}: _JIT_ENTRY does not start the stencil")
+
+    holes = []
+    for section in obj.sections:
+        if section.type != SHT_RELA or section.info not in layout:
+            continue
+        base = layout[section.info]
+        for r_offset, sym_index, r_type, addend in obj.relocations(section):
+            offset = base + r_offset
+            if r_type not in HOLE_KINDS:
+                raise StencilError(f"{name}: unsupported relocation {r_type}")
+            kind = HOLE_KINDS[r_type]
+            sym_name, _, shndx, value = obj.symbols[sym_index]
+            if shndx != SHN_UNDEF:
+                if shndx not in layout:
+                    raise StencilError(
+                        f"{name}: relocation against {sym_name or shndx}")
+                addend += layout[shndx] + value
+                if kind == "HOLE_REL_32":
+                    # Both ends are in the stencil: resolve it now
+                    delta = addend - offset
+                    struct.pack_into("<i", body, offset, delta)
+                    continue
+                holes.append((offset, kind, "HOLE_BASE", None, addend))
+            elif sym_name in SPECIAL_HOLES:
+                holes.append((offset, kind, SPECIAL_HOLES[sym_name], None,
+                              addend))
+            else:
+                holes.append((offset, kind, "HOLE_SYMBOL", sym_name, addend))
+    holes.sort()
+    return Stencil(name, bytes(body), holes)
+
+
+def check_tail_calls(name, path, objdump):
+    """Make sure that stencils continue with a jump, not with a call:
+    a trace would otherwise grow the C stack on every uop."""
+    if objdump is None:
+        return
+    out = subprocess.run([objdump, "-d", "-r", "--no-show-raw-insn", path],
+                         check=True, capture_output=True, text=True).stdout
+    register = previous = None
+    for line in out.splitlines():
+        reloc = re.search(r"R_X86_64_64\s+(_JIT_CONTINUE|_JIT_TOP)", line)
+        if reloc:
+            register = previous
+            continue
+        m = re.match(r"\s*[0-9a-f]+:\s+(\S+)\s+(.*)", line)
+        if not m:
+            continue
+        insn, args = m.groups()
+        if register is not None and args.strip() == "*" + register:
+            if insn.startswith("call"):
+                raise StencilError(f"{name}: the next stencil is called, "
+                                   "not jumped to")
+            register = None
+        mov = re.match(r"movabs\s+\$0x0,(%\w+)", f"{insn} {args}")
+        previous = mov.group(1) if mov else None
+
+
+def compile_uop(cc, cflags, tmpdir, objdump, uop):
+    name, _ = uop
+    path = os.path.join(tmpdir, f"{name}.o")
+    cmd = [*cc, *cflags, *STENCIL_CFLAGS, f"-D_JIT_OPCODE={name}",
+           "-c", TEMPLATE, "-o", path]
+    subprocess.run(cmd, check=True)
+    check_tail_calls(name, path, objdump)
+    with open(path, "rb") as f:
+        return make_stencil(name, ObjectFile(f.read()))
+
+
+def find_objdump():
+    for tool in ("objdump", "llvm-objdump"):
+        try:
+            subprocess.run([tool, "--version"], check=True,
+                           capture_output=True)
+        except (OSError, subprocess.CalledProcessError):
+            continue
+        return tool
+    return None
+
+
+def write_header(out, stencils, target):
+    symbols = sorted({hole[3] for stencil in stencils
+                      for hole in stencil.holes if hole[3] is not None})
+    index = {symbol: i for i, symbol in enumerate(symbols)}
+    out.write(f"// Generated by Tools/jit/build.py for {target}, "
+              "do not edit.\n\n")
+    out.write("#define JIT_STENCILS_AVAILABLE 1\n\n")
+    for stencil in stencils:
+        out.write(f"static const unsigned char {stencil.name}_body[{len(stencil.body)}] = {{\n")
+        for i in range(0, len(stencil.body), 12):
+            chunk = stencil.body[i:i + 12]
+            out.write("    " + " ".join(f"0x{b:02x}," for b in chunk) + "\n")
+        out.write("};\n")
+        out.write(f"static const Hole {stencil.name}_holes[{len(stencil.holes) + 1}] = {{\n")
+        for offset, kind, value, symbol, addend in stencil.holes:
+            sym = index[symbol] if symbol is not None else 0
+            out.write(f"    {{0x{offset:x}, {kind}, {value}, {sym}, {addend}}},\n")
+        out.write("    {0, 0, 0, 0, 0},\n};\n\n")
+    out.write("static const Stencil stencils[] = {\n")
+    for stencil in stencils:
+        out.write(f"    [{stencil.name}] = {{{len(stencil.body)}, "
+                  f"{stencil.name}_body, {len(stencil.holes)}, "
+                  f"{stencil.name}_holes}},\n")
+    out.write("};\n\n")
+    out.write("#define JIT_SYMBOLS_INIT { \\\n")
+    for symbol in symbols:
+        out.write(f"    (uintptr_t)&{symbol}, \\\n")
+    out.write("}\n")
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--cc", required=True)
+    parser.add_argument("-o", "--output", required=True)
+    parser.add_argument("cflags", nargs=argparse.REMAINDER)
+    args = parser.parse_args()
+    cc = shlex.split(args.cc)
+    cflags = args.cflags
+    if cflags and cflags[0] == "--":
+        cflags = cflags[1:]
+    cflags = filter_cflags(cflags)
+
+    target = subprocess.run([*cc, "-dumpmachine"], check=True,
+                            capture_output=True, text=True).stdout.strip()
+    tmp_output = args.output + ".new"
+    with open(tmp_output, "w") as out:
+        if not re.match(r"x86_64-.*linux", target):
+            out.write(f"// The JIT is not available for {target}.\n\n"
+                      "#define JIT_STENCILS_AVAILABLE 0\n")
+        else:
+            objdump = find_objdump()
+            uops = read_uops()
+            with tempfile.TemporaryDirectory() as tmpdir:
+                with concurrent.futures.ThreadPoolExecutor(
+                        os.cpu_count() or 1) as pool:
+                    stencils = list(pool.map(
+                        lambda uop: compile_uop(cc, cflags, tmpdir,
+                                                objdump, uop),
+                        uops))
+            write_header(out, stencils, target)
+    os.replace(tmp_output, args.output)
+
+
+if __name__ == "__main__":
+    try:
+        main()
+    except (StencilError, subprocess.CalledProcessError) as exc:
+        sys.exit(f"{sys.argv[0]}: {exc}")
@@ -0,0 +1,91 @@
+/* Template for the JIT stencils.
+ *
+ * Tools/jit/build.py compiles this file once for every uop, with
+ * _JIT_OPCODE defined to the uop, and turns the resulting object file into
+ * a stencil.  The extern symbols starting with _JIT_ are the holes that
+ * Python/jit.c patches when it copies the stencil into a trace:
+ *
+ *   _JIT_CONTINUE   the stencil of the next uop
+ *   _JIT_TOP        the stencil of the first uop of the trace
+ *   _JIT_OPARG, _JIT_OPERAND, _JIT_FLAGS, _JIT_BORROWED, _JIT_TARGET
+ *                   fields of the uop
+ *   _JIT_INDEX      the index of the uop in the trace
+ *
+ * The holes for data are used through their address, so that the values
+ * are patched into the instructions as immediates.
+ */
+
+#include "Python.h"
+#include "pycore_code.h"
+#include "pycore_dict.h"          // DK_ENTRIES()
+#include "pycore_jit.h"           // _PyJITState
+#include "pycore_list.h"          // _PyListIterObject
+#include "pycore_long.h"          // _PyLong_Add()
+#include "pycore_pyerrors.h"      // _PyErr_Occurred()
+#include "pycore_range.h"         // _PyRangeIterObject
+#include "pycore_tuple.h"         // _PyTupleIterObject
+#include "pycore_uops.h"
+
+extern PyObject **_JIT_CONTINUE(_PyJITState *, InterpreterFrame *, PyObject **);
+extern PyObject **_JIT_TOP(_PyJITState *, InterpreterFrame *, PyObject **);
+
+extern char _JIT_OPARG;
+extern char _JIT_OPERAND;
+extern char _JIT_FLAGS;
+extern char _JIT_BORROWED;
+extern char _JIT_TARGET;
+extern char _JIT_INDEX;
+
+#define PATCH_VALUE(TYPE, NAME) ((TYPE)(uintptr_t)&NAME)
+
+PyObject **
+_JIT_ENTRY(_PyJITState *state, InterpreterFrame *frame,
+           PyObject **stack_pointer)
+{
+    PyThreadState *tstate = state->tstate;
+    PyObject **localsplus = frame->localsplus;
+    const int oparg = PATCH_VALUE(int, _JIT_OPARG);
+    const uint64_t operand = PATCH_VALUE(uint64_t, _JIT_OPERAND);
+    const int flags = PATCH_VALUE(int, _JIT_FLAGS);
+    const int borrowed = PATCH_VALUE(int, _JIT_BORROWED);
+    const int target = PATCH_VALUE(int, _JIT_TARGET);
+    int exit;
+
+    switch (_JIT_OPCODE) {
+
+#include "uop_cases.h"
+
+        case UOP_JUMP_TO_TOP:
+            state->iterations++;
+            if (_Py_atomic_load_relaxed(&tstate->interp->ceval.eval_breaker) ||
+                tstate->cframe->use_tracing)
+            {
+                exit = _PyUOP_EXIT_BREAK;
+                goto leave;
+            }
+            return _JIT_TOP(state, frame, stack_pointer);
+
+        default:
+            Py_UNREACHABLE();
+    }
+    return _JIT_CONTINUE(state, frame, stack_pointer);
+
+deopt:
+    exit = _PyUOP_EXIT_DEOPT;
+    goto leave;
+side_exit:
+    exit = _PyUOP_EXIT_SIDE;
+    goto leave;
+loop_exit:
+    exit = _PyUOP_EXIT_LOOP;
+    goto leave;
+error_with_stack:
+    exit = _PyUOP_EXIT_ERROR_WITH_STACK;
+    goto leave;
+error:
+    exit = _PyUOP_EXIT_ERROR;
+leave:
+    state->exit = exit;
+    state->index = PATCH_VALUE(int, _JIT_INDEX);
+    return stack_pointer;
+}